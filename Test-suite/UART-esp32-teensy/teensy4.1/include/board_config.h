@@ -23,21 +23,70 @@
 // SD Card Configuration
 // Teensy 4.1 has built-in SD card slot
 #define SD_CS_PIN BUILTIN_SDCARD
-#define LOG_FILENAME "uart_log.txt"
+#define LOG_FILE_PREFIX "uart_log_"  // uart_log_000.bin, uart_log_001.bin, ...
+#define LOG_FILE_MAX_INDEX 999
+
+// Log format: 1 = binary records (BinaryLogFormat.h, ~16 bytes per message),
+// 0 = text lines (~55 bytes per message)
+#ifndef SD_LOG_BINARY
+#define SD_LOG_BINARY 1
+#endif
+
+#if SD_LOG_BINARY
+#define LOG_FILE_EXT ".bin"
+#else
+#define LOG_FILE_EXT ".txt"
+#endif
+
+// Contiguous space reserved for each log file at boot
+// 1 kHz is ~58 MB per hour in binary, ~200 MB per hour as text
+#ifndef SD_PREALLOC_MB
+#define SD_PREALLOC_MB 256
+#endif
 
 // Buffer Sizes
-#define RX_BUFFER_SIZE 256
+// Serial1 RX ring is extended with addMemoryForRead() so the UART interrupt
+// keeps buffering while the main loop is busy (16 KB = ~1.4 s at 115200)
+#ifndef UART_RX_RING_SIZE
+#define UART_RX_RING_SIZE 16384
+#endif
 #define TX_BUFFER_SIZE 64
+#define LOG_LINE_SIZE (FRAMER_MAX_FRAME + 32)
 
 // Timing Configuration
 #ifndef SD_FLUSH_INTERVAL_MS
-#define SD_FLUSH_INTERVAL_MS 5000  // Flush SD every 5 seconds
+#define SD_FLUSH_INTERVAL_MS 5000  // Flush partial SD sectors every 5 seconds
 #endif
 
 #ifndef STATS_INTERVAL_MS
 #define STATS_INTERVAL_MS 10000  // Print stats every 10 seconds
 #endif
 
+// 1 = echo every frame and fragment to USB ([RX]/[OK]/[ERR]/[FRAG]). Off by
+// default: per-record printing slows the drain loop at full rate, and the
+// periodic statistics carry the counts
+#ifndef DEBUG_PRINT_FRAMES
+#define DEBUG_PRINT_FRAMES 0
+#endif
+
+// ACK Configuration
+// 1 = windowed: every ACK_INTERVAL_MS send, per device, the highest contiguous
+//     sequence and a bitmap of the holes after it; the sender retransmits
+//     only the holes
+// 0 = legacy: one ACK,NNNN,OK|ERR line per message
+#ifndef ACK_WINDOWED
+#define ACK_WINDOWED 1
+#endif
+
+#ifndef ACK_INTERVAL_MS
+#define ACK_INTERVAL_MS 50
+#endif
+
+// Binary (ThrustLink) senders tracked by device ID, auto-detected next to ASCII
+#ifndef BINARY_MAX_DEVICE_IDS
+#define BINARY_MAX_DEVICE_IDS 8
+#endif
+
 // Serial Aliases for cleaner code
 #define DEBUG_SERIAL Serial   // USB Serial for debugging
 #define UART_SERIAL  Serial1  // UART from ESP32
@@ -0,0 +1,199 @@
+#include "BaudNegotiator.h"
+#include <stdlib.h>
+
+static_assert(THRUSTLINK_BAUD_TEST_FRAMES <= 32, "Test mask holds 32 frames");
+
+BaudNegotiator::BaudNegotiator()
+    : _serial(nullptr)
+    , _ingest(nullptr)
+    , _baseBaud(THRUSTLINK_BASE_BAUD)
+    , _baud(THRUSTLINK_BASE_BAUD)
+    , _state(IDLE)
+    , _pendingBaud(0)
+    , _deadline(0)
+    , _testMask(0)
+    , _lastCheck(0)
+    , _lastGood(0)
+    , _lastBad(0)
+    , _lastActivity(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void BaudNegotiator::begin(HardwareSerial& serial, UartIngest& ingest, uint32_t baseBaud) {
+    _serial = &serial;
+    _ingest = &ingest;
+    _baseBaud = baseBaud;
+    _baud = baseBaud;
+    _state = IDLE;
+    _lastCheck = millis();
+    _lastActivity = millis();
+}
+
+// ===== Control Frames =====
+
+bool BaudNegotiator::handleControl(const char* frame) {
+    if (strncmp(frame, "$BAUD", 5) != 0) return false;
+
+    const char* comma = strchr(frame, ',');
+    if (!comma) return true;
+    uint32_t rate = strtoul(comma + 1, NULL, 10);
+    char body[32];
+
+    if (strncmp(frame, "$BAUDREQ,", 9) == 0) {
+        _stats.requests++;
+        if (!isSupported(rate)) {
+            snprintf(body, sizeof(body), "BAUDNAK,%lu", rate);
+            sendControl(body);
+            return true;
+        }
+        snprintf(body, sizeof(body), "BAUDACK,%lu", rate);
+        sendControl(body);
+
+        switchBaud(rate);
+        _state = TESTING;
+        _pendingBaud = rate;
+        _testMask = 0;
+        _deadline = millis() + THRUSTLINK_BAUD_SETTLE_MS + THRUSTLINK_BAUD_STEP_TIMEOUT_MS;
+        return true;
+    }
+
+    if (strncmp(frame, "$BAUDCOMMIT,", 12) == 0) {
+        if (_state == AWAIT_COMMIT && rate == _pendingBaud) {
+            _state = IDLE;
+            _stats.commits++;
+            _lastCheck = millis();
+            _lastActivity = millis();
+            Serial.printf("[BAUD] Committed %lu baud\n", _baud);
+        }
+        return true;
+    }
+
+    return true;
+}
+
+bool BaudNegotiator::handleTest(const uint8_t* payload, size_t length) {
+    uint8_t index;
+    if (length == 0 || payload[0] != THRUSTLINK_TYPE_TEST) return false;
+
+    if (_state == TESTING && thrustLinkCheckTest(payload, length, index) &&
+        index < THRUSTLINK_BAUD_TEST_FRAMES) {
+        _testMask |= 1UL << index;
+        if (_testMask == (1UL << THRUSTLINK_BAUD_TEST_FRAMES) - 1) {
+            finishTest();
+        }
+    }
+    return true;
+}
+
+void BaudNegotiator::finishTest() {
+    uint8_t good = 0;
+    for (uint8_t i = 0; i < THRUSTLINK_BAUD_TEST_FRAMES; i++) {
+        if (_testMask & (1UL << i)) good++;
+    }
+
+    char body[32];
+    snprintf(body, sizeof(body), "BAUDRES,%lu,%u", _pendingBaud, good);
+    sendControl(body);
+
+    if (good == THRUSTLINK_BAUD_TEST_FRAMES) {
+        _state = AWAIT_COMMIT;
+        _deadline = millis() + THRUSTLINK_BAUD_STEP_TIMEOUT_MS;
+    } else {
+        _stats.testFailures++;
+        fallBack();
+    }
+}
+
+// ===== Timeouts and Link Quality =====
+
+void BaudNegotiator::poll() {
+    if (!_serial) return;
+
+    if (_state != IDLE) {
+        if ((int32_t)(millis() - _deadline) >= 0) {
+            if (_state == TESTING) {
+                // Report what arrived; a partial result fails the rate
+                finishTest();
+            } else {
+                _stats.timeouts++;
+                fallBack();
+            }
+        }
+        return;
+    }
+
+    if (millis() - _lastCheck >= BAUD_CHECK_INTERVAL_MS) {
+        _lastCheck = millis();
+        checkLinkQuality();
+    }
+}
+
+void BaudNegotiator::checkLinkQuality() {
+    const FramerStats& frames = _ingest->getFramerStats();
+    uint32_t good = frames.framesValid + _ingest->getBinaryFrames();
+    uint32_t bad = frames.framesBadChecksum + frames.fragmentsTruncated +
+                   frames.framesOverflow + _ingest->getBinaryErrors();
+
+    uint32_t windowGood = good - _lastGood;
+    uint32_t windowBad = bad - _lastBad;
+    _lastGood = good;
+    _lastBad = bad;
+
+    if (_baud == _baseBaud) return;
+
+    uint32_t total = windowGood + windowBad;
+    if (total > 0) {
+        _lastActivity = millis();
+    }
+
+    bool noisy = total >= BAUD_FALLBACK_MIN_FRAMES &&
+                 windowBad * 100 > total * BAUD_FALLBACK_ERROR_PCT;
+    bool silent = millis() - _lastActivity >= BAUD_SILENCE_TIMEOUT_MS;
+    if (noisy || silent) {
+        Serial.printf("[BAUD] %s at %lu baud (%lu/%lu bad), back to %lu\n",
+                            noisy ? "Errors" : "Silence", _baud, windowBad, total, _baseBaud);
+        _stats.fallbacks++;
+        fallBack();
+    }
+}
+
+// ===== Port Control =====
+
+void BaudNegotiator::fallBack() {
+    _state = IDLE;
+    _pendingBaud = 0;
+    if (_baud != _baseBaud) {
+        switchBaud(_baseBaud);
+    }
+    _lastCheck = millis();
+    _lastActivity = millis();
+}
+
+void BaudNegotiator::switchBaud(uint32_t baud) {
+    // Stop the ingest timer while the port is reconfigured; the RX ring
+    // memory added with addMemoryForRead() is kept by begin()
+    _ingest->end();
+    _serial->flush();
+    _serial->begin(baud);
+    _ingest->begin(*_serial);
+    _baud = baud;
+}
+
+void BaudNegotiator::sendControl(const char* body) {
+    uint8_t checksum = 0;
+    for (const char* c = body; *c; c++) {
+        checksum ^= (uint8_t)*c;
+    }
+    char line[48];
+    snprintf(line, sizeof(line), "$%s*%02X\n", body, checksum);
+    _serial->print(line);
+}
+
+bool BaudNegotiator::isSupported(uint32_t baud) {
+    if (baud > UART_MAX_BAUD) return false;
+    for (size_t i = 0; i < THRUSTLINK_BAUD_RATE_COUNT; i++) {
+        if (THRUSTLINK_BAUD_RATES[i] == baud) return true;
+    }
+    return false;
+}
@@ -0,0 +1,95 @@
+#ifndef BAUD_NEGOTIATOR_H
+#define BAUD_NEGOTIATOR_H
+
+#include <Arduino.h>
+#include "ThrustLink.h"
+#include "UartIngest.h"
+
+// ============================================================================
+// Receiver Side of the Baud Negotiation
+// ============================================================================
+// Answers the sender's $BAUDREQ/$BAUDCOMMIT control lines and counts its
+// TEST frames (protocol in ThrustLink.h). Once a higher rate is committed,
+// the link is watched every BAUD_CHECK_INTERVAL_MS: too many bad frames or
+// no frames at all return the port to the base rate. The sender notices the
+// missing ACKs, falls back too and renegotiates at a lower rate.
+
+#ifndef UART_MAX_BAUD
+#define UART_MAX_BAUD 3000000          // Highest rate accepted from the sender
+#endif
+
+#ifndef BAUD_CHECK_INTERVAL_MS
+#define BAUD_CHECK_INTERVAL_MS 1000
+#endif
+
+#ifndef BAUD_FALLBACK_ERROR_PCT
+#define BAUD_FALLBACK_ERROR_PCT 5      // Bad frames per window that force fallback
+#endif
+
+#define BAUD_FALLBACK_MIN_FRAMES 20    // Smaller windows are not judged on errors
+
+#ifndef BAUD_SILENCE_TIMEOUT_MS
+#define BAUD_SILENCE_TIMEOUT_MS 2000   // No frames at a high rate -> fallback
+#endif
+
+struct BaudStats {
+    uint32_t requests;        // $BAUDREQ received
+    uint32_t commits;         // Rates committed
+    uint32_t testFailures;    // Test patterns with missing/corrupt frames
+    uint32_t timeouts;        // Handshake steps that expired
+    uint32_t fallbacks;       // Returns to base after a committed rate degraded
+};
+
+class BaudNegotiator {
+public:
+    BaudNegotiator();
+
+    void begin(HardwareSerial& serial, UartIngest& ingest, uint32_t baseBaud);
+
+    // Handle a $BAUD... control frame. Returns false for any other frame.
+    bool handleControl(const char* frame);
+
+    // Handle a binary payload. Returns false if it is not a TEST frame.
+    bool handleTest(const uint8_t* payload, size_t length);
+
+    // Step timeouts and link-quality fallback. Call from loop().
+    void poll();
+
+    uint32_t getBaud() const { return _baud; }
+    bool isNegotiating() const { return _state != IDLE; }
+    const BaudStats& getStats() const { return _stats; }
+
+private:
+    enum State : uint8_t {
+        IDLE,           // At _baud, no handshake running
+        TESTING,        // Switched, collecting TEST frames
+        AWAIT_COMMIT    // Test passed, waiting for $BAUDCOMMIT
+    };
+
+    void switchBaud(uint32_t baud);
+    void fallBack();
+    void finishTest();
+    void checkLinkQuality();
+    void sendControl(const char* body);
+    static bool isSupported(uint32_t baud);
+
+    HardwareSerial* _serial;
+    UartIngest* _ingest;
+    uint32_t _baseBaud;
+    uint32_t _baud;
+
+    State _state;
+    uint32_t _pendingBaud;
+    uint32_t _deadline;
+    uint32_t _testMask;       // Bit i: TEST frame i received intact
+
+    // Link quality window
+    uint32_t _lastCheck;
+    uint32_t _lastGood;
+    uint32_t _lastBad;
+    uint32_t _lastActivity;
+
+    BaudStats _stats;
+};
+
+#endif // BAUD_NEGOTIATOR_H
@@ -0,0 +1,85 @@
+#ifndef BINARY_LOG_FORMAT_H
+#define BINARY_LOG_FORMAT_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Binary SD Log Format (version 1)
+// ============================================================================
+// File layout:
+//   [BinLogHeader - one 512-byte sector][BinLogRecord][BinLogRecord]...
+// All fields are little-endian. Records are 16 bytes, so 32 fit exactly in a
+// sector. A record of all zero bytes marks the end of data (flush padding).
+//
+// Shared by the Teensy firmware and the host-side converter (tools/), so this
+// header must stay free of Arduino dependencies.
+
+#define BINLOG_MAGIC "TRDBLOG"    // 7 characters + '\0'
+#define BINLOG_VERSION 1
+#define BINLOG_HEADER_SIZE 512
+#define BINLOG_MAX_DEVICES 4
+#define BINLOG_MAX_SENSORS 8
+
+// ===== Record Flags =====
+#define BINLOG_FLAG_VALID         0x01  // Checksum matched
+#define BINLOG_FLAG_BAD_CHECKSUM  0x02  // Complete frame, checksum mismatch
+#define BINLOG_FLAG_TRUNCATED     0x04  // Fragment; only localMicros is meaningful
+#define BINLOG_FLAG_UNPARSED      0x08  // Complete frame with malformed fields
+#define BINLOG_DEVICE_SHIFT       4     // Bits 4-5: index into the device table
+#define BINLOG_DEVICE_MASK        0x30
+
+#define BINLOG_SENSOR_NONE        0xFF  // sensorId for fragments/unparsed frames
+
+// ===== Header Tables =====
+
+struct BinLogDevice {
+    char name[16];              // Sender device name ("thrust_test")
+    uint32_t received;          // Link statistics, refreshed whenever the
+    uint32_t lost;              // header is rewritten (periodically and
+    uint32_t duplicates;        // when the log is closed)
+    int16_t driftPpm;           // Receiver minus sender clock rate
+    uint16_t latencyMs;         // Smoothed latency above the fastest delivery
+};
+
+struct BinLogSensor {
+    char name[8];               // Sensor field ("THST")
+    char unit[6];               // Unit field ("N")
+    uint8_t decimals;           // Digits after the point in the ASCII value
+    uint8_t reserved;
+};
+
+// ===== File Header =====
+
+struct BinLogHeader {
+    char magic[8];              // BINLOG_MAGIC
+    uint16_t version;           // BINLOG_VERSION
+    uint16_t headerSize;        // sizeof(BinLogHeader)
+    uint16_t recordSize;        // sizeof(BinLogRecord)
+    uint8_t deviceCount;
+    uint8_t sensorCount;
+    uint32_t bootMillis;        // Receiver millis() when the log was opened
+    uint32_t bootMicros;        // Receiver micros() at the same instant
+    uint32_t uartBaud;
+    uint32_t reserved0;
+    BinLogDevice devices[BINLOG_MAX_DEVICES];
+    BinLogSensor sensors[BINLOG_MAX_SENSORS];
+    uint8_t reserved[224];
+};
+
+// ===== Data Record =====
+
+struct BinLogRecord {
+    uint32_t localMicros;       // Receiver micros() when the frame completed
+    uint32_t senderTimestamp;   // Sender <TIMESTAMP> field (ms)
+    float value;                // Sensor value
+    uint16_t sequence;          // Sender <MSG_ID>
+    uint8_t sensorId;           // Index into the sensor table
+    uint8_t flags;              // BINLOG_FLAG_* | device index
+};
+
+static_assert(sizeof(BinLogDevice) == 32, "BinLogDevice layout changed");
+static_assert(sizeof(BinLogSensor) == 16, "BinLogSensor layout changed");
+static_assert(sizeof(BinLogHeader) == BINLOG_HEADER_SIZE, "BinLogHeader must fill one sector");
+static_assert(sizeof(BinLogRecord) == 16, "BinLogRecord layout changed");
+
+#endif // BINARY_LOG_FORMAT_H
@@ -0,0 +1,138 @@
+#include "BinaryLogWriter.h"
+#include "DataMessage.h"
+
+BinaryLogWriter::BinaryLogWriter()
+    : _log(nullptr)
+    , _headerDirty(false)
+{
+    memset(&_header, 0, sizeof(_header));
+}
+
+// ===== Initialization =====
+
+bool BinaryLogWriter::begin(SectorLogger& log, uint32_t uartBaud) {
+    _log = &log;
+
+    memset(&_header, 0, sizeof(_header));
+    memcpy(_header.magic, BINLOG_MAGIC, sizeof(_header.magic));
+    _header.version = BINLOG_VERSION;
+    _header.headerSize = sizeof(BinLogHeader);
+    _header.recordSize = sizeof(BinLogRecord);
+    _header.bootMillis = millis();
+    _header.bootMicros = micros();
+    _header.uartBaud = uartBaud;
+
+    _headerDirty = false;
+    return _log->append(&_header, sizeof(_header));
+}
+
+// ===== Records =====
+
+bool BinaryLogWriter::logFrame(uint32_t rxMicros, const char* frame, bool valid) {
+    if (!_log) return false;
+
+    BinLogRecord record;
+    record.localMicros = rxMicros;
+    record.flags = valid ? BINLOG_FLAG_VALID : BINLOG_FLAG_BAD_CHECKSUM;
+
+    DataMessage msg;
+    int device = -1;
+    int sensor = -1;
+    if (parseDataMessage(frame, msg)) {
+        device = findDevice(msg.device);
+        sensor = findSensor(msg.sensor, msg.unit, msg.valueDecimals);
+    }
+
+    if (device >= 0 && sensor >= 0) {
+        record.senderTimestamp = msg.timestamp;
+        record.value = msg.value;
+        record.sequence = (uint16_t)msg.messageId;
+        record.sensorId = (uint8_t)sensor;
+        record.flags |= (uint8_t)(device << BINLOG_DEVICE_SHIFT);
+    } else {
+        // Malformed fields or tables full: keep the arrival time only
+        record.senderTimestamp = 0;
+        record.value = NAN;
+        record.sequence = 0;
+        record.sensorId = BINLOG_SENSOR_NONE;
+        record.flags |= BINLOG_FLAG_UNPARSED;
+    }
+
+    if (_headerDirty) {
+        updateHeader();
+    }
+    return _log->append(&record, sizeof(record));
+}
+
+bool BinaryLogWriter::logFragment(uint32_t rxMicros) {
+    if (!_log) return false;
+
+    BinLogRecord record;
+    record.localMicros = rxMicros;
+    record.senderTimestamp = 0;
+    record.value = NAN;
+    record.sequence = 0;
+    record.sensorId = BINLOG_SENSOR_NONE;
+    record.flags = BINLOG_FLAG_TRUNCATED;
+    return _log->append(&record, sizeof(record));
+}
+
+// ===== Header Tables =====
+
+int BinaryLogWriter::findDevice(const char* name) {
+    for (uint8_t i = 0; i < _header.deviceCount; i++) {
+        if (strncmp(_header.devices[i].name, name, sizeof(_header.devices[i].name)) == 0) {
+            return i;
+        }
+    }
+    if (_header.deviceCount >= BINLOG_MAX_DEVICES) {
+        return -1;
+    }
+
+    BinLogDevice& device = _header.devices[_header.deviceCount];
+    strncpy(device.name, name, sizeof(device.name) - 1);
+    _headerDirty = true;
+    return _header.deviceCount++;
+}
+
+int BinaryLogWriter::findSensor(const char* name, const char* unit, uint8_t decimals) {
+    for (uint8_t i = 0; i < _header.sensorCount; i++) {
+        if (strncmp(_header.sensors[i].name, name, sizeof(_header.sensors[i].name)) == 0) {
+            return i;
+        }
+    }
+    if (_header.sensorCount >= BINLOG_MAX_SENSORS) {
+        return -1;
+    }
+
+    BinLogSensor& sensor = _header.sensors[_header.sensorCount];
+    strncpy(sensor.name, name, sizeof(sensor.name) - 1);
+    strncpy(sensor.unit, unit, sizeof(sensor.unit) - 1);
+    sensor.decimals = decimals;
+    _headerDirty = true;
+    return _header.sensorCount++;
+}
+
+void BinaryLogWriter::updateLinkStats(const LinkStats& stats) {
+    if (!_log) return;
+
+    for (uint8_t i = 0; i < stats.getDeviceCount(); i++) {
+        const DeviceLinkStats& link = stats.getDevice(i);
+        int index = findDevice(link.name);
+        if (index < 0) continue;
+
+        BinLogDevice& device = _header.devices[index];
+        device.received = link.received;
+        device.lost = link.lost;
+        device.duplicates = link.duplicates;
+        device.driftPpm = (int16_t)constrain(link.driftPpm, -32768.0f, 32767.0f);
+        device.latencyMs = (uint16_t)constrain(link.latencyMs, 0.0f, 65535.0f);
+    }
+    updateHeader();
+}
+
+void BinaryLogWriter::updateHeader() {
+    if (_log->rewriteHead(&_header, sizeof(_header))) {
+        _headerDirty = false;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef BINARY_LOG_WRITER_H
+#define BINARY_LOG_WRITER_H
+
+#include <Arduino.h>
+#include "BinaryLogFormat.h"
+#include "SectorLogger.h"
+#include "LinkStats.h"
+
+// ============================================================================
+// Binary Log Writer
+// ============================================================================
+// Converts received frames into fixed-size BinLogRecords and appends them to
+// a SectorLogger. Device and sensor tables are learned from the stream; when
+// a new entry is added, the header sector is rewritten in place.
+
+class BinaryLogWriter {
+public:
+    BinaryLogWriter();
+
+    // Write the file header as the first sector of an open log
+    bool begin(SectorLogger& log, uint32_t uartBaud);
+
+    // Log a complete frame (checksum result from the framer)
+    bool logFrame(uint32_t rxMicros, const char* frame, bool valid);
+
+    // Log a truncated fragment (only its arrival time is kept)
+    bool logFragment(uint32_t rxMicros);
+
+    // Copy per-device link statistics into the header and rewrite it
+    void updateLinkStats(const LinkStats& stats);
+
+    const BinLogHeader& getHeader() const { return _header; }
+
+private:
+    int findDevice(const char* name);
+    int findSensor(const char* name, const char* unit, uint8_t decimals);
+    void updateHeader();
+
+    SectorLogger* _log;
+    BinLogHeader _header;
+    bool _headerDirty;
+};
+
+#endif // BINARY_LOG_WRITER_H
@@ -0,0 +1,72 @@
+#include "DataMessage.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Copy the field starting at *cursor up to the next ',' or '*' into out.
+// Advances *cursor past the separator. Returns false on an empty or
+// oversized field or if the separator is not the expected one.
+static bool nextField(const char** cursor, char* out, size_t outSize, char separator = ',') {
+    const char* start = *cursor;
+    const char* end = start;
+    while (*end && *end != ',' && *end != '*') {
+        end++;
+    }
+
+    size_t length = end - start;
+    if (*end != separator || length == 0 || length >= outSize) {
+        return false;
+    }
+
+    memcpy(out, start, length);
+    out[length] = '\0';
+    *cursor = end + 1;
+    return true;
+}
+
+bool parseDataMessage(const char* frame, DataMessage& msg) {
+    if (!frame || frame[0] != '$') return false;
+
+    const char* cursor = frame + 1;
+    char number[16];
+    char* endPtr;
+
+    if (!nextField(&cursor, msg.device, sizeof(msg.device))) return false;
+
+    if (!nextField(&cursor, number, sizeof(number))) return false;
+    msg.messageId = strtoul(number, &endPtr, 10);
+    if (*endPtr != '\0') return false;
+
+    if (!nextField(&cursor, msg.type, sizeof(msg.type))) return false;
+    if (!nextField(&cursor, msg.sensor, sizeof(msg.sensor))) return false;
+
+    if (!nextField(&cursor, number, sizeof(number))) return false;
+    msg.value = strtof(number, &endPtr);
+    if (*endPtr != '\0') return false;
+    const char* point = strchr(number, '.');
+    msg.valueDecimals = point ? (uint8_t)strlen(point + 1) : 0;
+
+    if (!nextField(&cursor, msg.unit, sizeof(msg.unit))) return false;
+
+    // Timestamp is terminated by '*'
+    if (!nextField(&cursor, number, sizeof(number), '*')) return false;
+    msg.timestamp = strtoul(number, &endPtr, 10);
+    if (*endPtr != '\0') return false;
+
+    return true;
+}
+
+size_t formatDataMessage(char* out, size_t outSize, const char* device, uint32_t messageId,
+                         const char* sensor, const char* value, const char* unit,
+                         uint32_t timestamp) {
+    int length = snprintf(out, outSize, "$%s,%04lu,DATA,%s,%s,%s,%lu",
+                          device, (unsigned long)(messageId % 10000), sensor, value, unit,
+                          (unsigned long)timestamp);
+    if (length <= 0 || (size_t)length + 3 >= outSize) return 0;
+
+    uint8_t checksum = 0;
+    for (int i = 1; i < length; i++) {
+        checksum ^= (uint8_t)out[i];
+    }
+    return length + snprintf(out + length, outSize - length, "*%02X", checksum);
+}
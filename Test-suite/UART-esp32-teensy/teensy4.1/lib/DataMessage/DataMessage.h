@@ -0,0 +1,37 @@
+#ifndef DATA_MESSAGE_H
+#define DATA_MESSAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// ASCII Data Message Parser
+// ============================================================================
+// Splits a framed message into its fields:
+//   $<DEVICE>,<MSG_ID>,<TYPE>,<SENSOR>,<VALUE>,<UNIT>,<TIMESTAMP>*<CHECKSUM>
+// The checksum itself is checked by UartFramer; this only parses the body.
+
+#define MSG_DEVICE_LEN 16
+#define MSG_FIELD_LEN 8
+
+struct DataMessage {
+    char device[MSG_DEVICE_LEN];
+    uint32_t messageId;
+    char type[MSG_FIELD_LEN];
+    char sensor[MSG_FIELD_LEN];
+    float value;
+    uint8_t valueDecimals;     // Digits after the decimal point in VALUE
+    char unit[MSG_FIELD_LEN];
+    uint32_t timestamp;        // Sender millis()
+};
+
+// Parse a frame into msg. Returns false if any field is missing or malformed.
+bool parseDataMessage(const char* frame, DataMessage& msg);
+
+// Build a complete DATA frame with checksum (no line ending) from already
+// formatted fields. Returns the frame length, or 0 if it does not fit.
+size_t formatDataMessage(char* out, size_t outSize, const char* device, uint32_t messageId,
+                         const char* sensor, const char* value, const char* unit,
+                         uint32_t timestamp);
+
+#endif // DATA_MESSAGE_H
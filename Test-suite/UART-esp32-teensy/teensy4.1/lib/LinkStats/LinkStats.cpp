@@ -0,0 +1,203 @@
+#include "LinkStats.h"
+#include <string.h>
+
+LinkStats::LinkStats() {
+    reset();
+}
+
+void LinkStats::reset() {
+    memset(_devices, 0, sizeof(_devices));
+    _deviceCount = 0;
+}
+
+// ===== Update =====
+
+int LinkStats::update(const char* device, uint16_t sequence, uint32_t senderMs, uint32_t localMs) {
+    int index = findDevice(device);
+    if (index < 0) return -1;
+
+    DeviceLinkStats& dev = _devices[index];
+
+    // A jump in the sender clock means it restarted or reset its timestamp
+    // (tare/zero on the ESP32): restart both sequence and timing windows
+    double offset = (double)localMs - (double)senderMs;
+    if (dev.timingSamples > 0 &&
+        (offset - dev.lastOffset > LINK_CLOCK_JUMP_MS || dev.lastOffset - offset > LINK_CLOCK_JUMP_MS)) {
+        dev.resyncs++;
+        dev.seenBitmap = 0;
+        resetTiming(dev);
+    }
+
+    updateSequence(dev, sequence);
+    updateTiming(dev, senderMs, localMs);
+    return index;
+}
+
+int LinkStats::findDevice(const char* name) {
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        if (strncmp(_devices[i].name, name, sizeof(_devices[i].name)) == 0) {
+            return i;
+        }
+    }
+    if (_deviceCount >= LINK_MAX_DEVICES) {
+        return -1;
+    }
+
+    DeviceLinkStats& dev = _devices[_deviceCount];
+    memset(&dev, 0, sizeof(dev));
+    strncpy(dev.name, name, sizeof(dev.name) - 1);
+    return _deviceCount++;
+}
+
+// ===== Sequence Accounting =====
+
+void LinkStats::updateSequence(DeviceLinkStats& dev, uint16_t sequence) {
+    if (dev.seenBitmap == 0) {
+        dev.lastSeq = sequence;
+        dev.seenBitmap = 1;
+        dev.windowDepth = 1;
+        dev.received++;
+        return;
+    }
+
+    int32_t delta = seqDelta(sequence, dev.lastSeq);
+
+    if (delta > LINK_RESYNC_THRESHOLD || delta < -LINK_RESYNC_THRESHOLD) {
+        // Sender restarted; start a new sequence window
+        dev.resyncs++;
+        dev.lastSeq = sequence;
+        dev.seenBitmap = 1;
+        dev.windowDepth = 1;
+        dev.received++;
+        return;
+    }
+
+    if (delta > 0) {
+        uint32_t gap = delta - 1;
+        if (gap > 0) {
+            dev.lost += gap;
+            dev.gapHistogram[gapBucket(gap)]++;
+        }
+        dev.seenBitmap = delta >= 64 ? 1 : (dev.seenBitmap << delta) | 1;
+        dev.windowDepth = dev.windowDepth + delta >= 64 ? 64 : dev.windowDepth + delta;
+        dev.lastSeq = sequence;
+        dev.received++;
+        return;
+    }
+
+    if (delta == 0) {
+        dev.duplicates++;
+        return;
+    }
+
+    // Behind the newest sequence: either a duplicate or a late fill
+    uint32_t back = -delta;
+    if (back < dev.windowDepth && (dev.seenBitmap >> back) & 1) {
+        dev.duplicates++;
+        return;
+    }
+    if (back < dev.windowDepth) {
+        dev.seenBitmap |= 1ULL << back;
+    }
+    dev.late++;
+    dev.received++;
+    if (dev.lost > 0) {
+        dev.lost--;
+    }
+}
+
+// ===== Windowed ACK =====
+
+bool LinkStats::getAckWindow(uint8_t index, uint16_t& cumulative, uint32_t& missing) const {
+    if (index >= _deviceCount) return false;
+
+    const DeviceLinkStats& dev = _devices[index];
+    if (dev.seenBitmap == 0) return false;
+
+    // Oldest hole still inside the window; anything older is given up
+    int oldest = -1;
+    for (int i = dev.windowDepth - 1; i >= 1; i--) {
+        if (!((dev.seenBitmap >> i) & 1)) {
+            oldest = i;
+            break;
+        }
+    }
+
+    missing = 0;
+    if (oldest < 0) {
+        cumulative = dev.lastSeq;
+        return true;
+    }
+
+    cumulative = (uint16_t)((dev.lastSeq + LINK_SEQ_MODULUS - oldest - 1) % LINK_SEQ_MODULUS);
+    for (int j = 0; j < 32 && oldest - j >= 1; j++) {
+        if (!((dev.seenBitmap >> (oldest - j)) & 1)) {
+            missing |= 1UL << j;
+        }
+    }
+    return true;
+}
+
+int32_t LinkStats::seqDelta(uint16_t a, uint16_t b) {
+    int32_t delta = ((int32_t)a - (int32_t)b) % LINK_SEQ_MODULUS;
+    if (delta < -LINK_SEQ_MODULUS / 2) delta += LINK_SEQ_MODULUS;
+    if (delta >= LINK_SEQ_MODULUS / 2) delta -= LINK_SEQ_MODULUS;
+    return delta;
+}
+
+uint8_t LinkStats::gapBucket(uint32_t gap) {
+    if (gap <= 2) return gap - 1;
+    if (gap <= 4) return 2;
+    if (gap <= 8) return 3;
+    if (gap <= 16) return 4;
+    return 5;
+}
+
+uint16_t LinkStats::bucketLowerBound(uint8_t bucket) {
+    static const uint16_t bounds[LINK_GAP_BUCKETS] = {1, 2, 3, 5, 9, 17};
+    return bucket < LINK_GAP_BUCKETS ? bounds[bucket] : 0;
+}
+
+// ===== Latency and Drift =====
+
+void LinkStats::resetTiming(DeviceLinkStats& dev) {
+    dev.timingSamples = 0;
+    dev.meanT = 0;
+    dev.meanOffset = 0;
+    dev.varT = 0;
+    dev.covTOffset = 0;
+    dev.latencyMs = 0;
+}
+
+void LinkStats::updateTiming(DeviceLinkStats& dev, uint32_t senderMs, uint32_t localMs) {
+    double offset = (double)localMs - (double)senderMs;
+    dev.lastOffset = offset;
+
+    if (dev.timingSamples == 0) {
+        dev.firstLocalMs = localMs;
+    }
+    double t = (double)(uint32_t)(localMs - dev.firstLocalMs);
+
+    // Welford update of means, variance of t and covariance of (t, offset)
+    dev.timingSamples++;
+    double n = dev.timingSamples;
+    double dt = t - dev.meanT;
+    dev.meanT += dt / n;
+    dev.meanOffset += (offset - dev.meanOffset) / n;
+    dev.varT += dt * (t - dev.meanT);
+    dev.covTOffset += dt * (offset - dev.meanOffset);
+
+    double slope = dev.varT > 0 ? dev.covTOffset / dev.varT : 0;
+    dev.driftPpm = (float)(slope * 1e6);
+
+    // Remove drift, then measure latency above the fastest delivery seen
+    double corrected = offset - slope * t;
+    if (dev.timingSamples == 1 || corrected < dev.minCorrOffset) {
+        dev.minCorrOffset = corrected;
+    }
+    float latency = (float)(corrected - dev.minCorrOffset);
+    dev.latencyMs += (latency - dev.latencyMs) / 16.0f;
+    if (latency > dev.maxLatencyMs) {
+        dev.maxLatencyMs = latency;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef LINK_STATS_H
+#define LINK_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// Per-device Link Statistics
+// ============================================================================
+// Tracks every sender device seen on the link:
+//   - Sequence gaps (lost messages) with a gap-length histogram
+//   - Duplicates and late arrivals, using a bitmap of the last 64 sequences
+//   - One-way latency and clock drift from the sender <TIMESTAMP>
+//   - Windowed ACK state (cumulative sequence + missing bitmap) from the
+//     same bitmap, so the receiver can request retransmission of holes
+//
+// Latency is relative: the sender and receiver clocks are not synchronized, so
+// the fastest delivery seen so far (after drift correction) is taken as zero
+// and each message's latency is measured above it. Drift is the least-squares
+// slope of (local - sender) time over local time, in ppm.
+//
+// Has no Arduino dependencies so it can also be used by host tools.
+
+#ifndef LINK_MAX_DEVICES
+#define LINK_MAX_DEVICES 4
+#endif
+
+#define LINK_SEQ_MODULUS 10000       // ASCII <MSG_ID> wraps at 10000
+#define LINK_RESYNC_THRESHOLD 1000   // Larger sequence jumps mean a sender restart
+#define LINK_CLOCK_JUMP_MS 1000      // Larger timestamp jumps mean a sender clock reset
+#define LINK_GAP_BUCKETS 6           // Gap lengths: 1, 2, 3-4, 5-8, 9-16, 17+
+
+struct DeviceLinkStats {
+    char name[16];
+
+    // Sequence accounting
+    uint32_t received;          // Unique messages received
+    uint32_t lost;              // Sequence numbers never received
+    uint32_t duplicates;        // Messages received twice
+    uint32_t late;              // Out-of-order arrivals that filled a gap
+    uint32_t resyncs;           // Sequence or clock restarts
+    uint32_t gapHistogram[LINK_GAP_BUCKETS];
+    uint16_t lastSeq;           // Highest sequence received
+    uint64_t seenBitmap;        // Bit i: lastSeq - i was received
+    uint8_t windowDepth;        // Valid bits in seenBitmap (1-64)
+
+    // Timing (ms)
+    float latencyMs;            // Smoothed latency above the fastest delivery
+    float maxLatencyMs;
+    float driftPpm;             // Receiver minus sender clock rate
+
+    // Internal estimator state
+    uint32_t timingSamples;
+    uint32_t firstLocalMs;
+    double meanT;               // Welford running means/co-moment of
+    double meanOffset;          // (local time, local - sender offset)
+    double varT;
+    double covTOffset;
+    double minCorrOffset;
+    double lastOffset;
+};
+
+class LinkStats {
+public:
+    LinkStats();
+
+    void reset();
+
+    // Account for one valid message. localMs is the receiver millis() at
+    // arrival. Returns the device index, or -1 if the table is full.
+    int update(const char* device, uint16_t sequence, uint32_t senderMs, uint32_t localMs);
+
+    // Windowed ACK state for a device: the highest sequence received with no
+    // hole before it (within the 64-entry window), and a bitmap whose bit j
+    // is set if cumulative + 1 + j is still missing.
+    bool getAckWindow(uint8_t index, uint16_t& cumulative, uint32_t& missing) const;
+
+    uint8_t getDeviceCount() const { return _deviceCount; }
+    const DeviceLinkStats& getDevice(uint8_t index) const { return _devices[index]; }
+
+    // Lower edge of each histogram bucket (1, 2, 3, 5, 9, 17)
+    static uint16_t bucketLowerBound(uint8_t bucket);
+
+    // Signed distance a - b in the sequence space, in [-5000, 5000)
+    static int32_t seqDelta(uint16_t a, uint16_t b);
+
+private:
+    int findDevice(const char* name);
+    void updateSequence(DeviceLinkStats& dev, uint16_t sequence);
+    void updateTiming(DeviceLinkStats& dev, uint32_t senderMs, uint32_t localMs);
+    static void resetTiming(DeviceLinkStats& dev);
+    static uint8_t gapBucket(uint32_t gap);
+
+    DeviceLinkStats _devices[LINK_MAX_DEVICES];
+    uint8_t _deviceCount;
+};
+
+#endif // LINK_STATS_H
@@ -0,0 +1,183 @@
+#include "SectorLogger.h"
+
+SectorLogger::SectorLogger()
+    : _open(false)
+    , _preallocated(false)
+    , _active(0)
+    , _fill(0)
+    , _pending(false)
+    , _fileOffset(0)
+    , _flushIntervalMs(0)
+    , _lastFlushTime(0)
+{
+    _filename[0] = '\0';
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// ===== Initialization =====
+
+bool SectorLogger::begin(const char* filename, uint64_t preallocBytes, uint32_t flushIntervalMs) {
+    strncpy(_filename, filename, sizeof(_filename) - 1);
+    _filename[sizeof(_filename) - 1] = '\0';
+
+    _file = SD.sdfs.open(_filename, O_RDWR | O_CREAT | O_TRUNC);
+    if (!_file) {
+        return false;
+    }
+
+    // Round up to whole buffers so the last commit never crosses the end
+    uint64_t rounded = (preallocBytes + SD_BUFFER_SIZE - 1) / SD_BUFFER_SIZE * SD_BUFFER_SIZE;
+    _preallocated = rounded > 0 && _file.preAllocate(rounded);
+
+    _active = 0;
+    _fill = 0;
+    _pending = false;
+    _fileOffset = 0;
+    _flushIntervalMs = flushIntervalMs;
+    _lastFlushTime = millis();
+    memset(&_stats, 0, sizeof(_stats));
+
+    _open = true;
+    return true;
+}
+
+// ===== Record Input =====
+
+bool SectorLogger::append(const void* data, size_t length) {
+    if (!_open || length == 0) return false;
+
+    size_t space = SD_BUFFER_SIZE - _fill;
+
+    // Record spills into the other buffer, which must already be committed
+    if (length > SD_BUFFER_SIZE || (length >= space && _pending)) {
+        _stats.recordsDropped++;
+        return false;
+    }
+
+    const uint8_t* src = (const uint8_t*)data;
+    size_t first = length < space ? length : space;
+    memcpy(&_buffers[_active][_fill], src, first);
+    _fill += first;
+
+    if (_fill == SD_BUFFER_SIZE) {
+        // Hand the full buffer to poll() and continue in the other one
+        _pending = true;
+        _active ^= 1;
+        _fill = length - first;
+        memcpy(_buffers[_active], src + first, _fill);
+    }
+
+    _stats.recordsLogged++;
+    _stats.bytesLogged += length;
+    return true;
+}
+
+// ===== Card Writes =====
+
+void SectorLogger::poll() {
+    if (!_open) return;
+
+    if (_pending) {
+        commitPending();
+    }
+
+    if (_flushIntervalMs > 0 && millis() - _lastFlushTime >= _flushIntervalMs) {
+        _lastFlushTime = millis();
+        flushPartial();
+    }
+}
+
+bool SectorLogger::rewriteHead(const void* data, size_t length) {
+    if (!_open || length == 0 || length > SD_BUFFER_SIZE || length % SD_SECTOR_SIZE != 0) {
+        return false;
+    }
+
+    if (_fileOffset == 0) {
+        // First buffer not committed yet: patch it in RAM
+        uint8_t index = _pending ? (_active ^ 1) : _active;
+        if (!_pending && _fill < length) {
+            return false;
+        }
+        memcpy(_buffers[index], data, length);
+        return true;
+    }
+
+    _file.seekSet(0);
+    bool ok = writeSectors((const uint8_t*)data, length);
+    _file.seekSet(_fileOffset);
+    return ok;
+}
+
+bool SectorLogger::writeSectors(const uint8_t* data, size_t length) {
+    uint32_t start = micros();
+    size_t written = _file.write(data, length);
+    uint32_t elapsed = micros() - start;
+
+    _stats.lastWriteUs = elapsed;
+    if (elapsed > _stats.maxWriteUs) {
+        _stats.maxWriteUs = elapsed;
+    }
+
+    if (written != length) {
+        _stats.writeErrors++;
+        return false;
+    }
+    return true;
+}
+
+bool SectorLogger::commitPending() {
+    const uint8_t* buffer = _buffers[_active ^ 1];
+    bool ok = writeSectors(buffer, SD_BUFFER_SIZE);
+
+    // Keep the offset in step with the data even on error so later sectors
+    // land where a reader expects them
+    _fileOffset += SD_BUFFER_SIZE;
+    _pending = false;
+    _stats.bufferWrites++;
+    return ok;
+}
+
+bool SectorLogger::flushPartial() {
+    uint32_t start = micros();
+    bool ok = true;
+
+    if (_fill > 0) {
+        // Write the sectors holding partial data (zero padded), then seek
+        // back so the next commit rewrites them with the full buffer
+        size_t sectors = (_fill + SD_SECTOR_SIZE - 1) / SD_SECTOR_SIZE;
+        size_t length = sectors * SD_SECTOR_SIZE;
+        memset(&_buffers[_active][_fill], 0, length - _fill);
+
+        ok = writeSectors(_buffers[_active], length);
+        _file.seekSet(_fileOffset);
+    }
+    _file.flush();
+
+    uint32_t elapsed = micros() - start;
+    if (elapsed > _stats.maxFlushUs) {
+        _stats.maxFlushUs = elapsed;
+    }
+    _stats.flushes++;
+    return ok;
+}
+
+void SectorLogger::close() {
+    if (!_open) return;
+
+    if (_pending) {
+        commitPending();
+    }
+    if (_fill > 0) {
+        size_t sectors = (_fill + SD_SECTOR_SIZE - 1) / SD_SECTOR_SIZE;
+        memset(&_buffers[_active][_fill], 0, sectors * SD_SECTOR_SIZE - _fill);
+        writeSectors(_buffers[_active], sectors * SD_SECTOR_SIZE);
+    }
+
+    // Drop the padding and any unused preallocated clusters
+    _file.truncate(_fileOffset + _fill);
+    _file.close();
+
+    _fileOffset += _fill;
+    _fill = 0;
+    _open = false;
+}
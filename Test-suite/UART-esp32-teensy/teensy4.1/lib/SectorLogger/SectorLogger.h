@@ -0,0 +1,89 @@
+#ifndef SECTOR_LOGGER_H
+#define SECTOR_LOGGER_H
+
+#include <Arduino.h>
+#include <SD.h>
+
+// ============================================================================
+// Sector-buffered SD Logger
+// ============================================================================
+// Keeps one preallocated log file open and writes it in whole, 512-byte
+// aligned sectors from a pair of RAM buffers. Records are appended to the
+// active buffer; a full buffer is handed over and committed by poll(), so the
+// caller never waits on the card. Partial data is flushed on a fixed cadence
+// by writing the tail sector and seeking back, which keeps every write
+// sector-aligned.
+
+#define SD_SECTOR_SIZE 512
+
+#ifndef SD_BUFFER_SECTORS
+#define SD_BUFFER_SECTORS 16  // 8 KB per buffer, 16 KB total
+#endif
+
+#define SD_BUFFER_SIZE (SD_BUFFER_SECTORS * SD_SECTOR_SIZE)
+
+struct SectorLoggerStats {
+    uint32_t recordsLogged;   // Records accepted into a buffer
+    uint32_t recordsDropped;  // Records rejected (both buffers busy)
+    uint64_t bytesLogged;     // Payload bytes accepted
+    uint32_t bufferWrites;    // Full buffers committed to the card
+    uint32_t flushes;         // Interval flushes performed
+    uint32_t writeErrors;     // Short or failed card writes
+    uint32_t lastWriteUs;     // Latency of the most recent card write
+    uint32_t maxWriteUs;      // Worst-case card write latency
+    uint32_t maxFlushUs;      // Worst-case interval flush latency
+};
+
+class SectorLogger {
+public:
+    SectorLogger();
+
+    // Create the log file and preallocate preallocBytes of contiguous space.
+    // Falls back to a normal (growing) file if preallocation fails.
+    bool begin(const char* filename, uint64_t preallocBytes, uint32_t flushIntervalMs);
+
+    // Append one record. Never touches the card; returns false if dropped.
+    bool append(const void* data, size_t length);
+    bool append(const char* text) { return append(text, strlen(text)); }
+
+    // Overwrite the start of the file (e.g. a header sector) in place.
+    // length must be a whole number of sectors and already appended.
+    bool rewriteHead(const void* data, size_t length);
+
+    // Commit full buffers and run the interval flush. Call from loop().
+    void poll();
+
+    // Write remaining data, trim preallocated space and close the file.
+    void close();
+
+    // Status
+    bool isOpen() const { return _open; }
+    bool isPreallocated() const { return _preallocated; }
+    const char* getFilename() const { return _filename; }
+    uint64_t getFileOffset() const { return _fileOffset; }
+    const SectorLoggerStats& getStats() const { return _stats; }
+
+private:
+    bool writeSectors(const uint8_t* data, size_t length);
+    bool commitPending();
+    bool flushPartial();
+
+    FsFile _file;
+    char _filename[32];
+    bool _open;
+    bool _preallocated;
+
+    // Double buffer: _active receives records, _pending awaits commit
+    alignas(SD_SECTOR_SIZE) uint8_t _buffers[2][SD_BUFFER_SIZE];
+    uint8_t _active;
+    size_t _fill;
+    bool _pending;
+
+    uint64_t _fileOffset;       // Sector-aligned end of committed data
+    uint32_t _flushIntervalMs;
+    uint32_t _lastFlushTime;
+
+    SectorLoggerStats _stats;
+};
+
+#endif // SECTOR_LOGGER_H
@@ -0,0 +1,119 @@
+#include "UartFramer.h"
+#include <string.h>
+
+UartFramer::UartFramer() {
+    reset();
+}
+
+void UartFramer::reset() {
+    _buffer[0] = '\0';
+    _length = 0;
+    _state = WAIT_START;
+    _checksum = 0;
+    _received = 0;
+    _emitted = false;
+    _restartPending = false;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// ===== Byte Input =====
+
+FrameStatus UartFramer::push(char c) {
+    // Release the frame handed out by the previous call
+    if (_emitted) {
+        _emitted = false;
+        _length = 0;
+        _buffer[0] = '\0';
+        if (_restartPending) {
+            _restartPending = false;
+            startFrame();
+        }
+    }
+
+    // '$' is a hard frame start regardless of state
+    if (c == '$') {
+        if (_state != WAIT_START) {
+            _restartPending = true;
+            return finish(FRAME_TRUNCATED);
+        }
+        startFrame();
+        return FRAME_NONE;
+    }
+
+    switch (_state) {
+        case WAIT_START:
+            if (c != '\r' && c != '\n') {
+                _stats.bytesDiscarded++;
+            }
+            return FRAME_NONE;
+
+        case BODY:
+            if (c == '*') {
+                append(c);
+                _state = CHECKSUM_HI;
+                return FRAME_NONE;
+            }
+            // Line end or non-printable byte before the checksum
+            if (c < 0x20 || c > 0x7E) {
+                return finish(FRAME_TRUNCATED);
+            }
+            if (_length >= FRAMER_MAX_FRAME - 3) {
+                return finish(FRAME_OVERFLOW);
+            }
+            append(c);
+            _checksum ^= (uint8_t)c;
+            return FRAME_NONE;
+
+        case CHECKSUM_HI:
+        case CHECKSUM_LO: {
+            int value = hexValue(c);
+            if (value < 0) {
+                return finish(FRAME_TRUNCATED);
+            }
+            append(c);
+            _received = (uint8_t)((_received << 4) | value);
+            if (_state == CHECKSUM_HI) {
+                _state = CHECKSUM_LO;
+                return FRAME_NONE;
+            }
+            return finish(_received == _checksum ? FRAME_VALID : FRAME_BAD_CHECKSUM);
+        }
+    }
+
+    return FRAME_NONE;
+}
+
+// ===== Internal Helpers =====
+
+void UartFramer::startFrame() {
+    _length = 0;
+    _checksum = 0;
+    _received = 0;
+    append('$');
+    _state = BODY;
+}
+
+void UartFramer::append(char c) {
+    _buffer[_length++] = c;
+    _buffer[_length] = '\0';
+}
+
+FrameStatus UartFramer::finish(FrameStatus status) {
+    switch (status) {
+        case FRAME_VALID:        _stats.framesValid++; break;
+        case FRAME_BAD_CHECKSUM: _stats.framesBadChecksum++; break;
+        case FRAME_TRUNCATED:    _stats.fragmentsTruncated++; break;
+        case FRAME_OVERFLOW:     _stats.framesOverflow++; break;
+        default: break;
+    }
+    _state = WAIT_START;
+    _emitted = true;
+    return status;
+}
+
+int UartFramer::hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
@@ -0,0 +1,80 @@
+#ifndef UART_FRAMER_H
+#define UART_FRAMER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// Resynchronizing UART Stream Framer
+// ============================================================================
+// Incremental state machine for $<BODY>*<CS> frames. A '$' always starts a
+// new frame, so a frame that lost its tail is reported as a truncated
+// fragment instead of swallowing the valid frame that follows it. Line
+// endings are optional and only terminate an unfinished fragment.
+//
+// Has no Arduino dependencies so the same code can replay captured logs on a
+// host machine.
+
+#ifndef FRAMER_MAX_FRAME
+#define FRAMER_MAX_FRAME 128  // Longest accepted frame including $ and *CS
+#endif
+
+enum FrameStatus : uint8_t {
+    FRAME_NONE = 0,        // Byte consumed, no frame completed
+    FRAME_VALID,           // Complete frame, checksum matches
+    FRAME_BAD_CHECKSUM,    // Complete frame, checksum mismatch
+    FRAME_TRUNCATED,       // Fragment cut short by '$', line end or noise
+    FRAME_OVERFLOW,        // Frame longer than FRAMER_MAX_FRAME
+    FRAME_BINARY           // ThrustLink binary payload, CRC valid (UartIngest)
+};
+
+struct FramerStats {
+    uint32_t framesValid;
+    uint32_t framesBadChecksum;
+    uint32_t fragmentsTruncated;
+    uint32_t framesOverflow;
+    uint32_t bytesDiscarded;   // Bytes outside any frame (excluding CR/LF)
+};
+
+class UartFramer {
+public:
+    UartFramer();
+
+    // Drop any partial frame and clear statistics
+    void reset();
+
+    // Feed one received byte. When the result is not FRAME_NONE, frame()
+    // holds the completed frame or fragment until the next push().
+    FrameStatus push(char c);
+
+    // Last completed frame/fragment (null-terminated)
+    const char* frame() const { return _buffer; }
+    size_t frameLength() const { return _length; }
+
+    const FramerStats& getStats() const { return _stats; }
+
+private:
+    enum State : uint8_t {
+        WAIT_START,    // Looking for '$'
+        BODY,          // Collecting body, XOR-ing into _checksum
+        CHECKSUM_HI,   // First hex digit after '*'
+        CHECKSUM_LO    // Second hex digit after '*'
+    };
+
+    void startFrame();
+    void append(char c);
+    FrameStatus finish(FrameStatus status);
+    static int hexValue(char c);
+
+    char _buffer[FRAMER_MAX_FRAME + 1];
+    size_t _length;
+    State _state;
+    uint8_t _checksum;        // Running XOR of body bytes
+    uint8_t _received;        // Checksum digits received so far
+    bool _emitted;            // Buffer holds a finished frame
+    bool _restartPending;     // A '$' ended the last fragment
+
+    FramerStats _stats;
+};
+
+#endif // UART_FRAMER_H
@@ -0,0 +1,135 @@
+#include "UartIngest.h"
+
+// Static instance pointer for the timer callback
+UartIngest* UartIngest::_instance = nullptr;
+
+UartIngest::UartIngest()
+    : _serial(nullptr)
+    , _binaryLength(0)
+    , _inBinary(false)
+    , _binaryFrames(0)
+    , _binaryErrors(0)
+    , _maxIsrMicros(0)
+{
+    _instance = this;
+}
+
+bool UartIngest::begin(HardwareSerial& serial, uint32_t intervalUs) {
+    _serial = &serial;
+
+    // Run below the UART interrupt so RX bytes are always taken first
+    _timer.priority(128);
+    return _timer.begin(timerISR, intervalUs);
+}
+
+void UartIngest::end() {
+    _timer.end();
+}
+
+void UartIngest::timerISR() {
+    if (_instance) {
+        _instance->service();
+    }
+}
+
+// ===== Producer (timer interrupt context) =====
+
+void UartIngest::service() {
+    uint32_t start = micros();
+    uint16_t budget = UART_INGEST_MAX_BYTES;
+
+    while (budget-- > 0 && _serial->available()) {
+        uint8_t c = (uint8_t)_serial->read();
+
+        if (c == THRUSTLINK_DELIMITER) {
+            // Ends the binary frame in progress and starts the next one
+            if (_inBinary && _binaryLength > 0) {
+                finishBinary();
+            }
+            _inBinary = true;
+            _binaryLength = 0;
+            continue;
+        }
+
+        if (_inBinary) {
+            if (_binaryLength < sizeof(_binary)) {
+                _binary[_binaryLength++] = c;
+                continue;
+            }
+            // Too long for a binary frame: this is ASCII after a stray 0x00
+            replayBinary(false);
+        }
+
+        pushAscii((char)c);
+    }
+
+    uint32_t elapsed = micros() - start;
+    if (elapsed > _maxIsrMicros) {
+        _maxIsrMicros = elapsed;
+    }
+}
+
+FrameStatus UartIngest::pushAscii(char c) {
+    FrameStatus status = _framer.push(c);
+    if (status != FRAME_NONE) {
+        pushRecord(status, _framer.frame(), _framer.frameLength());
+    }
+    return status;
+}
+
+bool UartIngest::tryBinary(const uint8_t* encoded, size_t length) {
+    uint8_t payload[THRUSTLINK_MAX_ENCODED];
+    size_t decoded = thrustLinkUnframe(encoded, length, payload);
+    if (decoded == 0 || decoded > THRUSTLINK_MAX_PAYLOAD) {
+        return false;
+    }
+    _binaryFrames++;
+    pushRecord(FRAME_BINARY, payload, decoded);
+    return true;
+}
+
+void UartIngest::finishBinary() {
+    if (tryBinary(_binary, _binaryLength)) {
+        _binaryLength = 0;
+        return;
+    }
+
+    // Not binary: ASCII that followed a binary frame or stray 0x00. Only a
+    // buffer that yields no ASCII frame either counts as a binary error.
+    if (!replayBinary(true)) {
+        _binaryErrors++;
+    }
+}
+
+bool UartIngest::replayBinary(bool terminated) {
+    bool framed = false;
+    _inBinary = false;
+
+    for (size_t i = 0; i < _binaryLength; i++) {
+        FrameStatus status = pushAscii((char)_binary[i]);
+        if (status != FRAME_VALID && status != FRAME_BAD_CHECKSUM) continue;
+        framed = true;
+
+        // The sender may switch to binary right after an ASCII frame
+        size_t next = i + 1;
+        while (next < _binaryLength && (_binary[next] == '\r' || _binary[next] == '\n')) {
+            next++;
+        }
+        if (terminated && next < _binaryLength && tryBinary(&_binary[next], _binaryLength - next)) {
+            break;
+        }
+    }
+
+    _binaryLength = 0;
+    return framed;
+}
+
+void UartIngest::pushRecord(uint8_t status, const void* data, size_t length) {
+    UartRecord record;
+    record.rxMicros = micros();
+    record.status = status;
+    record.length = (uint8_t)length;
+    memcpy(record.text, data, length);
+    record.text[length] = '\0';
+    _queue.push(record);  // Counted as a drop if loop() fell behind
+}
@@ -0,0 +1,92 @@
+#ifndef UART_INGEST_H
+#define UART_INGEST_H
+
+#include <Arduino.h>
+#include "UartFramer.h"
+#include "SpscQueue.h"
+#include "ThrustLink.h"
+
+// ============================================================================
+// Interrupt-driven UART Ingest
+// ============================================================================
+// An IntervalTimer drains the serial RX ring through UartFramer and pushes
+// every completed frame/fragment into a lock-free SPSC queue. loop() pops the
+// records and does the slow work (debug output, SD logging, ACKs), so a
+// storage stall only fills the queue instead of overrunning the UART.
+//
+// ASCII and ThrustLink binary frames are auto-detected on the same stream:
+// a 0x00 byte (never sent in ASCII) switches to collecting binary bytes up
+// to the next 0x00. If those bytes do not decode with a valid CRC, or no
+// delimiter arrives within THRUSTLINK_MAX_ENCODED bytes, they are replayed
+// through the ASCII framer, so a stray 0x00 from line noise costs nothing.
+
+#ifndef UART_INGEST_INTERVAL_US
+#define UART_INGEST_INTERVAL_US 250  // Timer period for draining Serial1
+#endif
+
+#ifndef UART_INGEST_MAX_BYTES
+#define UART_INGEST_MAX_BYTES 512    // Bytes handled per timer tick (bounds ISR time)
+#endif
+
+#ifndef UART_RECORD_QUEUE_SIZE
+#define UART_RECORD_QUEUE_SIZE 256   // Records (power of two)
+#endif
+
+static_assert(THRUSTLINK_MAX_PAYLOAD <= FRAMER_MAX_FRAME, "Binary payload must fit a UartRecord");
+
+// One framed message handed from the ingest interrupt to loop()
+struct UartRecord {
+    uint32_t rxMicros;                   // micros() when the frame completed
+    uint8_t status;                      // FrameStatus from the framer
+    uint8_t length;                      // Length of text (excluding '\0')
+    char text[FRAMER_MAX_FRAME + 1];     // Frame or fragment text, or the
+                                         // decoded payload for FRAME_BINARY
+};
+
+class UartIngest {
+public:
+    UartIngest();
+
+    // Start draining the given serial port from a timer interrupt
+    bool begin(HardwareSerial& serial, uint32_t intervalUs = UART_INGEST_INTERVAL_US);
+    void end();
+
+    // Consumer side: take the next record (call from loop())
+    bool pop(UartRecord& record) { return _queue.pop(record); }
+
+    // Status
+    const FramerStats& getFramerStats() const { return _framer.getStats(); }
+    size_t getQueueDepth() const { return _queue.size(); }
+    size_t getQueueCapacity() const { return _queue.capacity(); }
+    uint32_t getQueueHighWater() const { return _queue.getHighWater(); }
+    uint32_t getQueueDrops() const { return _queue.getDrops(); }
+    uint32_t getMaxIsrMicros() const { return _maxIsrMicros; }
+    uint32_t getBinaryFrames() const { return _binaryFrames; }
+    uint32_t getBinaryErrors() const { return _binaryErrors; }
+
+private:
+    void service();
+    FrameStatus pushAscii(char c);
+    bool tryBinary(const uint8_t* encoded, size_t length);
+    void finishBinary();
+    bool replayBinary(bool terminated);
+    void pushRecord(uint8_t status, const void* data, size_t length);
+    static void timerISR();
+
+    HardwareSerial* _serial;
+    IntervalTimer _timer;
+    UartFramer _framer;
+
+    // Binary frame collection (bytes after a 0x00 delimiter)
+    uint8_t _binary[THRUSTLINK_MAX_ENCODED];
+    size_t _binaryLength;
+    bool _inBinary;
+    uint32_t _binaryFrames;
+    uint32_t _binaryErrors;
+    SpscQueue<UartRecord, UART_RECORD_QUEUE_SIZE> _queue;
+    volatile uint32_t _maxIsrMicros;
+
+    static UartIngest* _instance;
+};
+
+#endif // UART_INGEST_H
@@ -2,9 +2,27 @@
 #include <SD.h>
 #include <SPI.h>
 #include "board_config.h"
+#include "SectorLogger.h"
+#include "UartIngest.h"
+#include "DataMessage.h"
+#include "LinkStats.h"
+#include "BaudNegotiator.h"
+#if SD_LOG_BINARY
+#include "BinaryLogWriter.h"
+#endif
 
 // Global objects
-File logFile;
+SectorLogger sdLog;
+UartIngest ingest;
+LinkStats linkStats;
+BaudNegotiator baud;
+
+#if SD_LOG_BINARY
+BinaryLogWriter binLog;
+#endif
+
+// Extra memory for the interrupt-fed Serial1 RX ring
+uint8_t uartRxRing[UART_RX_RING_SIZE];
 
 // Quick blink helper
 void blinkLED(int times, int delayMs = 100) {
@@ -23,73 +41,115 @@ uint32_t messagesValid = 0;
 uint32_t messagesInvalid = 0;
 uint32_t lastStatsTime = 0;
 
-// Receive buffer
-char rxBuffer[RX_BUFFER_SIZE];
-uint16_t rxIndex = 0;
-
-// Calculate XOR checksum
-uint8_t calculateChecksum(const char* data, size_t length) {
-    uint8_t checksum = 0;
-    for (size_t i = 0; i < length; i++) {
-        checksum ^= (uint8_t)data[i];
-    }
-    return checksum;
-}
-
-// Validate message checksum
-// Format: $<DEVICE>,<MSG_ID>,<TYPE>,<SENSOR>,<VALUE>,<UNIT>,<TIMESTAMP>*<CHECKSUM>
-bool validateChecksum(const char* message) {
-    // Find the asterisk separator
-    const char* asterisk = strchr(message, '*');
-    if (!asterisk || message[0] != '$') {
-        return false;
-    }
-
-    // Extract the received checksum (2 hex digits after *)
-    char checksumStr[3] = {0};
-    strncpy(checksumStr, asterisk + 1, 2);
-    uint8_t receivedChecksum = (uint8_t)strtol(checksumStr, NULL, 16);
-
-    // Calculate checksum of message body (between $ and *)
-    size_t bodyLength = asterisk - message - 1;  // Exclude $
-    uint8_t calculatedChecksum = calculateChecksum(message + 1, bodyLength);
-
-    return receivedChecksum == calculatedChecksum;
-}
+uint32_t binaryBatches = 0;
+uint32_t binaryUnknownDevice = 0;
+uint32_t acksSent = 0;
+uint32_t lastAckTime = 0;
+uint32_t ackedReceived[LINK_MAX_DEVICES] = {0};
 
+#if !ACK_WINDOWED
 // Send ACK response to ESP32
 void sendAck(uint32_t msgId, bool valid) {
     char ackBuffer[TX_BUFFER_SIZE];
     const char* status = valid ? "OK" : "ERR";
     snprintf(ackBuffer, sizeof(ackBuffer), "ACK,%04lu,%s\n", msgId % 10000, status);
     UART_SERIAL.print(ackBuffer);
+    acksSent++;
+}
+#endif
+
+// Send one windowed ACK per device: $ACKW,<DEVICE>,<CUM>,<MISSING>*CS
+// Skipped for a device with nothing new and no holes to report
+void sendWindowAcks() {
+    for (uint8_t i = 0; i < linkStats.getDeviceCount(); i++) {
+        const DeviceLinkStats& dev = linkStats.getDevice(i);
+        uint16_t cumulative;
+        uint32_t missing;
+        if (!linkStats.getAckWindow(i, cumulative, missing)) continue;
+        if (missing == 0 && dev.received == ackedReceived[i]) continue;
+        ackedReceived[i] = dev.received;
+
+        char ackBuffer[TX_BUFFER_SIZE];
+        int length = snprintf(ackBuffer, sizeof(ackBuffer), "$ACKW,%s,%04u,%08lX",
+                              dev.name, cumulative, (unsigned long)missing);
+        if (length <= 0 || (size_t)length + 4 >= sizeof(ackBuffer)) continue;
+
+        uint8_t checksum = 0;
+        for (int c = 1; c < length; c++) {
+            checksum ^= (uint8_t)ackBuffer[c];
+        }
+        snprintf(ackBuffer + length, sizeof(ackBuffer) - length, "*%02X\n", checksum);
+        UART_SERIAL.print(ackBuffer);
+        acksSent++;
+    }
 }
 
-// Log message to SD card
-void logToSD(const char* message, bool valid) {
+// Log a received frame or fragment to SD card
+// Only copies into the sector buffer; card writes happen in sdLog.poll()
+void logToSD(const UartRecord& record) {
     if (!sdReady) return;
 
-    // Open file in append mode
-    logFile = SD.open(LOG_FILENAME, FILE_WRITE);
-    if (logFile) {
-        // Add timestamp and validity marker
-        logFile.print(millis());
-        logFile.print(",");
-        logFile.print(valid ? "VALID" : "INVALID");
-        logFile.print(",");
-        logFile.println(message);
-        logFile.close();
-
-        DEBUG_SERIAL.print("[SD] Logged: ");
-        DEBUG_SERIAL.println(valid ? "VALID" : "INVALID");
-
-        // Blink LED on successful write
-        blinkLED(1, 50);
-    } else {
-        DEBUG_SERIAL.println("[SD] ERROR: Failed to open log file");
+    bool isFrame = record.status == FRAME_VALID || record.status == FRAME_BAD_CHECKSUM;
+
+#if SD_LOG_BINARY
+    // Fixed 16-byte record; see BinaryLogFormat.h
+    bool ok = isFrame
+        ? binLog.logFrame(record.rxMicros, record.text, record.status == FRAME_VALID)
+        : binLog.logFragment(record.rxMicros);
+#else
+    // Add timestamp and validity marker
+    const char* marker = !isFrame ? "TRUNCATED"
+                       : record.status == FRAME_VALID ? "VALID" : "INVALID";
+    char line[LOG_LINE_SIZE];
+    int length = snprintf(line, sizeof(line), "%lu,%s,%s\n",
+                          millis(), marker, record.text);
+    if (length <= 0) return;
+    if ((size_t)length >= sizeof(line)) length = sizeof(line) - 1;
+
+    bool ok = sdLog.append(line, length);
+#endif
+
+    if (!ok) {
+        DEBUG_SERIAL.println("[SD] ERROR: Log buffer full, record dropped");
     }
 }
 
+// Create the next free numbered log file and write its header. Never
+// reuses a name: SectorLogger truncates, so an existing log would be lost
+bool openLogFile() {
+    char filename[32];
+    bool found = false;
+    for (uint16_t i = 0; i <= LOG_FILE_MAX_INDEX; i++) {
+        snprintf(filename, sizeof(filename), "%s%03u%s", LOG_FILE_PREFIX, i, LOG_FILE_EXT);
+        if (!SD.exists(filename)) {
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        DEBUG_SERIAL.printf("[SD] ERROR: %s000-%03u%s all exist, not logging (free up the card)\n",
+                            LOG_FILE_PREFIX, LOG_FILE_MAX_INDEX, LOG_FILE_EXT);
+        return false;
+    }
+
+    uint64_t preallocBytes = (uint64_t)SD_PREALLOC_MB * 1024 * 1024;
+    if (!sdLog.begin(filename, preallocBytes, SD_FLUSH_INTERVAL_MS)) {
+        return false;
+    }
+
+#if SD_LOG_BINARY
+    return binLog.begin(sdLog, UART_BAUD);
+#else
+    char header[96];
+    snprintf(header, sizeof(header),
+             "=== UART Log Started ===\nBoot time: %lu\n", millis());
+    sdLog.append(header);
+    sdLog.append("Format: timestamp,validity,message\n");
+    sdLog.append("========================\n");
+    return true;
+#endif
+}
+
 // Extract message ID from message
 uint32_t extractMessageId(const char* message) {
     // Format: $<DEVICE>,<MSG_ID>,...
@@ -101,30 +161,212 @@ uint32_t extractMessageId(const char* message) {
     return strtoul(idStr, NULL, 10);
 }
 
-// Process a complete received message
-void processMessage(const char* message) {
+// Process a complete received message (checksum already checked by framer)
+void processMessage(const UartRecord& record, bool valid) {
+    const char* message = record.text;
     messagesReceived++;
 
+#if DEBUG_PRINT_FRAMES
     DEBUG_SERIAL.print("[RX] ");
     DEBUG_SERIAL.println(message);
-
-    // Validate checksum
-    bool valid = validateChecksum(message);
+#endif
 
     if (valid) {
         messagesValid++;
+#if DEBUG_PRINT_FRAMES
         DEBUG_SERIAL.println("[OK] Checksum valid");
+#endif
+
+        // Sequence gaps and latency, timed at arrival rather than dequeue
+        DataMessage msg;
+        if (parseDataMessage(message, msg)) {
+            uint32_t rxMillis = millis() - (micros() - record.rxMicros) / 1000;
+            linkStats.update(msg.device, (uint16_t)msg.messageId, msg.timestamp, rxMillis);
+        }
     } else {
         messagesInvalid++;
+#if DEBUG_PRINT_FRAMES
         DEBUG_SERIAL.println("[ERR] Checksum invalid");
+#endif
     }
 
-    // Log to SD card
-    logToSD(message, valid);
-
+#if !ACK_WINDOWED
     // Send ACK back to ESP32
     uint32_t msgId = extractMessageId(message);
     sendAck(msgId, valid);
+#endif
+}
+
+// Binary senders, learned from their DESCRIPTOR frames
+struct BinaryDevice {
+    bool known;
+    ThrustLinkDescriptor desc;
+    uint32_t lastTimestampUs;
+    uint32_t timestampWraps;   // Extends the 32-bit sender micros()
+};
+BinaryDevice binaryDevices[BINARY_MAX_DEVICE_IDS];
+
+void handleRecord(const UartRecord& record);
+
+// Convert a binary sample into the equivalent ASCII frame and handle it, so
+// logging, link statistics and ACKs treat both formats alike
+void handleBinarySample(const ThrustLinkSample& sample, uint32_t rxMicros) {
+    if (sample.device >= BINARY_MAX_DEVICE_IDS || !binaryDevices[sample.device].known) {
+        binaryUnknownDevice++;
+        return;
+    }
+
+    BinaryDevice& dev = binaryDevices[sample.device];
+    if (sample.timestampUs < dev.lastTimestampUs &&
+        dev.lastTimestampUs - sample.timestampUs > 0x80000000UL) {
+        dev.timestampWraps++;
+    }
+    dev.lastTimestampUs = sample.timestampUs;
+    uint64_t senderUs = ((uint64_t)dev.timestampWraps << 32) | sample.timestampUs;
+
+    // Exact milli-unit value, no float rounding
+    char value[16];
+    int32_t milli = sample.valueMilli;
+    uint32_t magnitude = milli < 0 ? (uint32_t)(-(int64_t)milli) : (uint32_t)milli;
+    snprintf(value, sizeof(value), "%s%lu.%03lu", milli < 0 ? "-" : "",
+             (unsigned long)(magnitude / 1000), (unsigned long)(magnitude % 1000));
+
+    UartRecord frame;
+    size_t length = formatDataMessage(frame.text, sizeof(frame.text), dev.desc.name,
+                                      sample.sequence, dev.desc.sensor, value, dev.desc.unit,
+                                      (uint32_t)(senderUs / 1000));
+    if (length == 0) return;
+
+    frame.rxMicros = rxMicros;
+    frame.status = FRAME_VALID;
+    frame.length = (uint8_t)length;
+    handleRecord(frame);
+}
+
+// Dispatch a decoded binary payload: descriptor, single sample or batch
+void handleBinary(const UartRecord& record) {
+    const uint8_t* payload = (const uint8_t*)record.text;
+
+    if (baud.handleTest(payload, record.length)) {
+        return;
+    }
+
+    ThrustLinkDescriptor desc;
+    if (thrustLinkParseDescriptor(payload, record.length, desc)) {
+        if (desc.device < BINARY_MAX_DEVICE_IDS) {
+            BinaryDevice& dev = binaryDevices[desc.device];
+            if (!dev.known || strcmp(dev.desc.name, desc.name) != 0) {
+                DEBUG_SERIAL.printf("[BIN] Device %u: %s %s (%s)\n",
+                                    desc.device, desc.name, desc.sensor, desc.unit);
+            }
+            dev.desc = desc;
+            dev.known = true;
+        }
+        return;
+    }
+
+    ThrustLinkSample sample;
+    if (thrustLinkParseSample(payload, record.length, sample)) {
+        handleBinarySample(sample, record.rxMicros);
+        return;
+    }
+
+    // A batch arrives with its last sample; earlier samples get arrival
+    // times back-dated by their sender-side offsets
+    static ThrustLinkSample batch[THRUSTLINK_BATCH_MAX_SAMPLES];
+    uint8_t count = thrustLinkParseBatch(payload, record.length, batch);
+    if (count > 0) {
+        binaryBatches++;
+        uint32_t lastUs = batch[count - 1].timestampUs;
+        for (uint8_t i = 0; i < count; i++) {
+            handleBinarySample(batch[i], record.rxMicros - (lastUs - batch[i].timestampUs));
+        }
+    }
+}
+
+// Handle a frame or fragment queued by the ingest interrupt
+void handleRecord(const UartRecord& record) {
+    if (record.status == FRAME_BINARY) {
+        handleBinary(record);
+        return;
+    }
+
+    // Baud negotiation lines are link control, not data
+    if (record.status == FRAME_VALID && baud.handleControl(record.text)) {
+        return;
+    }
+
+    logToSD(record);
+
+    switch (record.status) {
+        case FRAME_VALID:
+            processMessage(record, true);
+            break;
+
+        case FRAME_BAD_CHECKSUM:
+            processMessage(record, false);
+            break;
+
+        case FRAME_TRUNCATED:
+        case FRAME_OVERFLOW:
+            // Keep fragments for forensics but never ACK them
+#if DEBUG_PRINT_FRAMES
+            DEBUG_SERIAL.print("[FRAG] ");
+            DEBUG_SERIAL.println(record.text);
+#endif
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Print per-device sequence and timing statistics
+void printLinkStats() {
+    for (uint8_t i = 0; i < linkStats.getDeviceCount(); i++) {
+        const DeviceLinkStats& dev = linkStats.getDevice(i);
+        uint32_t expected = dev.received + dev.lost;
+        float lossRate = expected > 0 ? (float)dev.lost / expected * 100.0f : 0.0f;
+
+        DEBUG_SERIAL.printf("--- Link: %s ---\n", dev.name);
+        DEBUG_SERIAL.printf("  Received:        %lu\n", dev.received);
+        DEBUG_SERIAL.printf("  Lost:            %lu (%.2f%%)\n", dev.lost, lossRate);
+        DEBUG_SERIAL.printf("  Duplicates:      %lu\n", dev.duplicates);
+        DEBUG_SERIAL.printf("  Late fills:      %lu\n", dev.late);
+        DEBUG_SERIAL.printf("  Resyncs:         %lu\n", dev.resyncs);
+        DEBUG_SERIAL.print("  Gap histogram:  ");
+        for (uint8_t b = 0; b < LINK_GAP_BUCKETS; b++) {
+            DEBUG_SERIAL.printf(" %u%s:%lu", LinkStats::bucketLowerBound(b),
+                                b == LINK_GAP_BUCKETS - 1 ? "+" : "", dev.gapHistogram[b]);
+        }
+        DEBUG_SERIAL.println();
+        DEBUG_SERIAL.printf("  Latency:         %.1f ms avg, %.1f ms max\n",
+                            dev.latencyMs, dev.maxLatencyMs);
+        DEBUG_SERIAL.printf("  Clock drift:     %.1f ppm\n", dev.driftPpm);
+    }
+}
+
+// Record link statistics in the log (binary: header sector, text: footer)
+void writeLinkStatsToLog(bool closing) {
+    if (!sdReady) return;
+
+#if SD_LOG_BINARY
+    binLog.updateLinkStats(linkStats);
+#else
+    if (!closing) return;
+
+    char line[LOG_LINE_SIZE];
+    sdLog.append("=== Link Stats ===\n");
+    sdLog.append("Format: device,received,lost,duplicates,late,latency_ms,max_latency_ms,drift_ppm\n");
+    for (uint8_t i = 0; i < linkStats.getDeviceCount(); i++) {
+        const DeviceLinkStats& dev = linkStats.getDevice(i);
+        snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,%.1f,%.1f,%.1f\n",
+                 dev.name, dev.received, dev.lost, dev.duplicates, dev.late,
+                 dev.latencyMs, dev.maxLatencyMs, dev.driftPpm);
+        sdLog.append(line);
+    }
+    sdLog.append("==================\n");
+#endif
 }
 
 // Print statistics
@@ -138,10 +380,70 @@ void printStats() {
         float successRate = (float)messagesValid / messagesReceived * 100.0;
         DEBUG_SERIAL.printf("Success rate:      %.1f%%\n", successRate);
     }
+    const FramerStats& frames = ingest.getFramerStats();
+    DEBUG_SERIAL.printf("Truncated frags:   %lu\n", frames.fragmentsTruncated);
+    DEBUG_SERIAL.printf("Oversized frames:  %lu\n", frames.framesOverflow);
+    DEBUG_SERIAL.printf("Discarded bytes:   %lu\n", frames.bytesDiscarded);
+    DEBUG_SERIAL.printf("Queue high-water:  %lu / %u\n",
+                        ingest.getQueueHighWater(), (unsigned)ingest.getQueueCapacity());
+    DEBUG_SERIAL.printf("Queue drops:       %lu\n", ingest.getQueueDrops());
+    DEBUG_SERIAL.printf("Ingest ISR max:    %lu us\n", ingest.getMaxIsrMicros());
+    DEBUG_SERIAL.printf("Binary frames:     %lu (%lu batches, %lu CRC errors, %lu unknown device)\n",
+                        ingest.getBinaryFrames(), binaryBatches, ingest.getBinaryErrors(),
+                        binaryUnknownDevice);
+    DEBUG_SERIAL.printf("ACKs sent:         %lu (%s)\n", acksSent,
+                        ACK_WINDOWED ? "windowed" : "per message");
+    const BaudStats& baudStats = baud.getStats();
+    DEBUG_SERIAL.printf("UART baud:         %lu (%lu requests, %lu commits, %lu fallbacks)\n",
+                        baud.getBaud(), baudStats.requests, baudStats.commits,
+                        baudStats.fallbacks);
+    DEBUG_SERIAL.printf("Baud test fails:   %lu (%lu timeouts)\n",
+                        baudStats.testFailures, baudStats.timeouts);
+    printLinkStats();
+    if (sdReady) {
+        const SectorLoggerStats& log = sdLog.getStats();
+        DEBUG_SERIAL.printf("SD file:           %s%s\n", sdLog.getFilename(),
+                            sdLog.isOpen() ? "" : " (closed)");
+        DEBUG_SERIAL.printf("SD records:        %lu (%lu dropped)\n",
+                            log.recordsLogged, log.recordsDropped);
+        DEBUG_SERIAL.printf("SD bytes:          %llu\n", log.bytesLogged);
+        DEBUG_SERIAL.printf("SD buffer writes:  %lu (%lu errors)\n",
+                            log.bufferWrites, log.writeErrors);
+        DEBUG_SERIAL.printf("SD write latency:  %lu us last, %lu us max\n",
+                            log.lastWriteUs, log.maxWriteUs);
+        DEBUG_SERIAL.printf("SD flush latency:  %lu us max\n", log.maxFlushUs);
+    }
     DEBUG_SERIAL.println("================================");
     DEBUG_SERIAL.println();
 }
 
+// Handle single-character commands from the USB serial monitor
+void handleDebugCommands() {
+    if (!DEBUG_SERIAL.available()) return;
+
+    char cmd = DEBUG_SERIAL.read();
+    switch (cmd) {
+        case 's':
+        case 'S':
+            printStats();
+            break;
+
+        case 'x':
+        case 'X':
+            // Finalize the log so the card can be removed safely
+            if (sdReady) {
+                writeLinkStatsToLog(true);
+                sdLog.close();
+                sdReady = false;
+                DEBUG_SERIAL.printf("[SD] Log closed: %s\n", sdLog.getFilename());
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
 void setup() {
     // Initialize LED first for visual feedback
     pinMode(LED_PIN, OUTPUT);
@@ -155,12 +457,12 @@ void setup() {
     DEBUG_SERIAL.println("================================");
     DEBUG_SERIAL.println("Teensy 4.1 UART Receiver");
     DEBUG_SERIAL.println("================================");
-    DEBUG_SERIAL.printf("UART Baud Rate: %d\n", UART_BAUD);
-    DEBUG_SERIAL.printf("Log File: %s\n", LOG_FILENAME);
+    DEBUG_SERIAL.printf("UART Baud Rate: %d (negotiable up to %d)\n", UART_BAUD, UART_MAX_BAUD);
     DEBUG_SERIAL.println("================================");
 
-    // Initialize UART from ESP32
+    // Initialize UART from ESP32 with an enlarged RX ring
     UART_SERIAL.begin(UART_BAUD);
+    UART_SERIAL.addMemoryForRead(uartRxRing, sizeof(uartRxRing));
 
     // Initialize SD card
     DEBUG_SERIAL.print("Initializing SD card... ");
@@ -171,52 +473,67 @@ void setup() {
         // 3 quick blinks = SD card initialized successfully
         blinkLED(3);
 
-        // Create/open log file and write header
-        logFile = SD.open(LOG_FILENAME, FILE_WRITE);
-        if (logFile) {
-            logFile.println("=== UART Log Started ===");
-            logFile.print("Boot time: ");
-            logFile.println(millis());
-            logFile.println("Format: timestamp,validity,message");
-            logFile.println("========================");
-            logFile.close();
-            DEBUG_SERIAL.println("Log file ready");
+        // Create preallocated log file and write header
+        if (openLogFile()) {
+            DEBUG_SERIAL.printf("Log file ready: %s (%s)\n", sdLog.getFilename(),
+                                sdLog.isPreallocated() ? "preallocated" : "not preallocated");
+        } else {
+            sdReady = false;
+            DEBUG_SERIAL.println("ERROR: Failed to create log file");
         }
     } else {
         DEBUG_SERIAL.println("FAILED");
         DEBUG_SERIAL.println("WARNING: Continuing without SD logging");
     }
 
+    // Start interrupt-driven ingest last so no frame is queued before the
+    // log file exists
+    ingest.begin(UART_SERIAL);
+    baud.begin(UART_SERIAL, ingest, UART_BAUD);
+
     DEBUG_SERIAL.println();
+    DEBUG_SERIAL.println("Commands: s = stats, x = close log file");
     DEBUG_SERIAL.println("Waiting for data from ESP32...");
     DEBUG_SERIAL.println();
 }
 
 void loop() {
-    // Read UART data
-    while (UART_SERIAL.available()) {
-        char c = UART_SERIAL.read();
-
-        if (c == '\n' || c == '\r') {
-            if (rxIndex > 0) {
-                rxBuffer[rxIndex] = '\0';
-                processMessage(rxBuffer);
-                rxIndex = 0;
-            }
-        } else if (rxIndex < RX_BUFFER_SIZE - 1) {
-            rxBuffer[rxIndex++] = c;
-        } else {
-            // Buffer overflow - reset
-            DEBUG_SERIAL.println("[ERR] Buffer overflow");
-            rxIndex = 0;
+    // Drain frames parsed by the ingest interrupt, committing full sectors
+    // as they fill so a backlog never overruns the SD buffers
+    UartRecord record;
+    while (ingest.pop(record)) {
+        handleRecord(record);
+        if (sdReady) {
+            sdLog.poll();
         }
     }
 
+    // Run the periodic flush
+    if (sdReady) {
+        sdLog.poll();
+    }
+
+    // Baud handshake timeouts and link-quality fallback
+    baud.poll();
+
+#if ACK_WINDOWED
+    // Acknowledge everything received since the last window; hold ACKs
+    // while the port is changing rate
+    if (!baud.isNegotiating() && millis() - lastAckTime >= ACK_INTERVAL_MS) {
+        lastAckTime = millis();
+        sendWindowAcks();
+    }
+#endif
+
+    // Debug commands over USB
+    handleDebugCommands();
+
     // Print statistics periodically
     if (millis() - lastStatsTime >= STATS_INTERVAL_MS) {
         lastStatsTime = millis();
         if (messagesReceived > 0) {
             printStats();
+            writeLinkStatsToLog(false);
         }
     }
 }
@@ -0,0 +1,140 @@
+// ============================================================================
+// Binary SD Log Converter
+// ============================================================================
+// Expands a uart_log_NNN.bin file written by the Teensy receiver into the
+// text log layout, so existing tools (thrust_visualizer.py) keep working:
+//   <local_ms>,<VALID|INVALID>,$<DEVICE>,<MSG_ID>,DATA,<SENSOR>,<VALUE>,<UNIT>,<TIMESTAMP>*<CS>
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -I ../lib/BinaryLog -o binlog2txt binlog2txt.cpp
+// Usage:
+//   ./binlog2txt uart_log_000.bin > uart_log_000.txt
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "BinaryLogFormat.h"
+
+static uint8_t xorChecksum(const char* data, size_t length) {
+    uint8_t checksum = 0;
+    for (size_t i = 0; i < length; i++) {
+        checksum ^= (uint8_t)data[i];
+    }
+    return checksum;
+}
+
+static bool isZeroRecord(const BinLogRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    for (size_t i = 0; i < sizeof(record); i++) {
+        if (bytes[i] != 0) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <log.bin> [output.txt]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+    FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Cannot create %s\n", argv[2]);
+        fclose(in);
+        return 1;
+    }
+
+    BinLogHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, BINLOG_MAGIC, sizeof(header.magic)) != 0) {
+        fprintf(stderr, "%s: not a binary UART log\n", argv[1]);
+        return 1;
+    }
+    if (header.version != BINLOG_VERSION || header.recordSize != sizeof(BinLogRecord)) {
+        fprintf(stderr, "%s: unsupported version %u (record size %u)\n",
+                argv[1], header.version, header.recordSize);
+        return 1;
+    }
+    if (header.headerSize > sizeof(header)) {
+        fseek(in, header.headerSize, SEEK_SET);
+    }
+
+    // Link statistics as of the last header rewrite
+    for (uint8_t i = 0; i < header.deviceCount && i < BINLOG_MAX_DEVICES; i++) {
+        const BinLogDevice& device = header.devices[i];
+        fprintf(stderr, "%.16s: %u received, %u lost, %u duplicates, %u ms latency, %d ppm drift\n",
+                device.name, (unsigned)device.received, (unsigned)device.lost,
+                (unsigned)device.duplicates, (unsigned)device.latencyMs, (int)device.driftPpm);
+    }
+
+    fprintf(out, "=== UART Log Started ===\n");
+    fprintf(out, "Boot time: %u\n", (unsigned)header.bootMillis);
+    fprintf(out, "Format: timestamp,validity,message\n");
+    fprintf(out, "========================\n");
+
+    // micros() wraps every ~71.6 minutes; records are in arrival order
+    uint64_t wrapOffset = 0;
+    uint32_t lastMicros = header.bootMicros;
+    uint32_t records = 0;
+    uint32_t skipped = 0;
+
+    BinLogRecord record;
+    while (fread(&record, sizeof(record), 1, in) == 1) {
+        if (isZeroRecord(record)) break;  // Flush padding
+
+        if (record.localMicros < lastMicros) {
+            wrapOffset += 1ULL << 32;
+        }
+        lastMicros = record.localMicros;
+        uint64_t elapsedUs = wrapOffset + record.localMicros - header.bootMicros;
+        unsigned long long localMs = header.bootMillis + elapsedUs / 1000;
+        records++;
+
+        if (record.flags & BINLOG_FLAG_TRUNCATED) {
+            fprintf(out, "%llu,TRUNCATED,\n", localMs);
+            continue;
+        }
+
+        uint8_t device = (record.flags & BINLOG_DEVICE_MASK) >> BINLOG_DEVICE_SHIFT;
+        if ((record.flags & BINLOG_FLAG_UNPARSED) ||
+            device >= header.deviceCount || record.sensorId >= header.sensorCount) {
+            fprintf(out, "%llu,INVALID,\n", localMs);
+            skipped++;
+            continue;
+        }
+
+        const BinLogSensor& sensor = header.sensors[record.sensorId];
+        char name[sizeof(sensor.name) + 1] = {0};
+        char unit[sizeof(sensor.unit) + 1] = {0};
+        char deviceName[sizeof(header.devices[0].name) + 1] = {0};
+        memcpy(name, sensor.name, sizeof(sensor.name));
+        memcpy(unit, sensor.unit, sizeof(sensor.unit));
+        memcpy(deviceName, header.devices[device].name, sizeof(header.devices[0].name));
+
+        // Rebuild the original message and its checksum
+        char body[128];
+        int length = snprintf(body, sizeof(body), "$%s,%04u,DATA,%s,%.*f,%s,%u",
+                              deviceName, (unsigned)record.sequence, name,
+                              (int)sensor.decimals, (double)record.value, unit,
+                              (unsigned)record.senderTimestamp);
+        if (length <= 0 || (size_t)length >= sizeof(body)) {
+            skipped++;
+            continue;
+        }
+
+        bool valid = (record.flags & BINLOG_FLAG_VALID) != 0;
+        fprintf(out, "%llu,%s,%s*%02X\n", localMs, valid ? "VALID" : "INVALID",
+                body, xorChecksum(body + 1, length - 1));
+    }
+
+    fprintf(stderr, "%u records converted (%u without fields)\n", records, skipped);
+
+    fclose(in);
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,377 @@
+// ============================================================================
+// UartFramer Replay Test and Benchmark
+// ============================================================================
+// Checks the resynchronizing framer on a host:
+//   1. replays a captured text log (uart_log.txt) as the byte stream the
+//      receiver saw, each line's message followed by '\n'
+//   2. replays a synthetic stream with injected faults: garbage between
+//      frames (printable and not), truncated frames, '$' inside a payload,
+//      corrupted checksums and oversized frames
+// Every emitted frame and fragment, the counters and the discarded bytes are
+// compared with a reference that classifies the stream one '$' segment at a
+// time. For the synthetic stream every clean frame must come back verbatim,
+// and each injected fault must show in its counter. Then push() is timed on
+// the replayed stream.
+// Exits 1 when a check fails.
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -I ../lib/UartFramer -o framer_replay framer_replay.cpp
+//       ../lib/UartFramer/UartFramer.cpp
+//   (one command; see README)
+// Usage:
+//   ./framer_replay [uart_log.txt]
+//   ./framer_replay ../../../1Feb-motar-test-data/uart_log.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "UartFramer.h"
+
+#define SYNTH_FRAMES 20000
+#define BENCH_PASSES 20
+
+static int failures = 0;
+
+static double nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void check(bool ok, const char* what) {
+    printf("  %-44s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+}
+
+// ===== Emitted Frames =====
+struct Emitted {
+    FrameStatus status;
+    std::string text;
+};
+
+struct Result {
+    std::vector<Emitted> frames;
+    FramerStats stats;
+};
+
+static Result runFramer(const std::string& stream) {
+    UartFramer framer;
+    Result result;
+    for (size_t i = 0; i < stream.size(); i++) {
+        FrameStatus status = framer.push(stream[i]);
+        if (status != FRAME_NONE) {
+            Emitted frame = { status, std::string(framer.frame(), framer.frameLength()) };
+            result.frames.push_back(frame);
+        }
+    }
+    result.stats = framer.getStats();
+    return result;
+}
+
+// ===== Reference =====
+// Scans the stream a '$' segment at a time rather than byte by byte:
+//   - a '$' always starts a frame
+//   - the body runs to '*', a '$' or a byte outside 0x20..0x7E; its 125th
+//     byte (FRAMER_MAX_FRAME - 3) is an overflow
+//   - '*' and two hex digits complete it, anything else truncates it
+//   - bytes outside frames except CR/LF are discarded
+static bool isHex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+}
+
+static Result runReference(const std::string& s) {
+    Result result;
+    memset(&result.stats, 0, sizeof(result.stats));
+    const size_t maxBody = FRAMER_MAX_FRAME - 4;
+    size_t n = s.size();
+    size_t i = 0;
+
+    while (i < n) {
+        if (s[i] != '$') {
+            if (s[i] != '\r' && s[i] != '\n') result.stats.bytesDiscarded++;
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        size_t j = i + 1;
+        uint8_t checksum = 0;
+        while (j < n && s[j] != '*' && s[j] != '$' && s[j] >= 0x20 && s[j] <= 0x7E &&
+               j - start - 1 < maxBody) {
+            checksum ^= (uint8_t)s[j];
+            j++;
+        }
+        if (j >= n) break;                          // Unfinished at the end
+
+        Emitted frame;
+        if (s[j] == '$') {                          // Cut by the next frame
+            frame.status = FRAME_TRUNCATED;
+            frame.text = s.substr(start, j - start);
+            i = j;
+        } else if (s[j] != '*' && s[j] >= 0x20 && s[j] <= 0x7E) {
+            frame.status = FRAME_OVERFLOW;          // The byte is dropped
+            frame.text = s.substr(start, j - start);
+            i = j + 1;
+        } else if (s[j] != '*') {                   // Line end or noise, dropped
+            frame.status = FRAME_TRUNCATED;
+            frame.text = s.substr(start, j - start);
+            i = j + 1;
+        } else {
+            size_t k = j + 1;
+            while (k < n && k < j + 3 && isHex(s[k])) k++;
+            if (k == j + 3) {
+                unsigned value = (unsigned)strtoul(s.substr(j + 1, 2).c_str(), NULL, 16);
+                frame.status = value == checksum ? FRAME_VALID : FRAME_BAD_CHECKSUM;
+                frame.text = s.substr(start, k - start);
+                i = k;
+            } else if (k >= n) {
+                break;
+            } else {
+                frame.status = FRAME_TRUNCATED;
+                frame.text = s.substr(start, k - start);
+                i = s[k] == '$' ? k : k + 1;        // A non-hex byte is dropped
+            }
+        }
+
+        switch (frame.status) {
+            case FRAME_VALID:        result.stats.framesValid++; break;
+            case FRAME_BAD_CHECKSUM: result.stats.framesBadChecksum++; break;
+            case FRAME_TRUNCATED:    result.stats.fragmentsTruncated++; break;
+            case FRAME_OVERFLOW:     result.stats.framesOverflow++; break;
+            default: break;
+        }
+        result.frames.push_back(frame);
+    }
+    return result;
+}
+
+static bool sameFrames(const Result& a, const Result& b) {
+    if (a.frames.size() != b.frames.size()) {
+        printf("  frame count %zu vs reference %zu\n", a.frames.size(), b.frames.size());
+        return false;
+    }
+    for (size_t i = 0; i < a.frames.size(); i++) {
+        if (a.frames[i].status != b.frames[i].status || a.frames[i].text != b.frames[i].text) {
+            printf("  frame %zu differs: %d \"%s\" vs reference %d \"%s\"\n", i,
+                   a.frames[i].status, a.frames[i].text.c_str(),
+                   b.frames[i].status, b.frames[i].text.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sameStats(const FramerStats& a, const FramerStats& b) {
+    return a.framesValid == b.framesValid && a.framesBadChecksum == b.framesBadChecksum &&
+           a.fragmentsTruncated == b.fragmentsTruncated && a.framesOverflow == b.framesOverflow &&
+           a.bytesDiscarded == b.bytesDiscarded;
+}
+
+static void printStats(const char* name, const FramerStats& stats) {
+    printf("  %-10s valid %lu, bad checksum %lu, truncated %lu, overflow %lu, discarded %lu B\n",
+           name, (unsigned long)stats.framesValid, (unsigned long)stats.framesBadChecksum,
+           (unsigned long)stats.fragmentsTruncated, (unsigned long)stats.framesOverflow,
+           (unsigned long)stats.bytesDiscarded);
+}
+
+// ===== Captured Log =====
+// Rebuilds the received stream: "<ms>,<VALID|INVALID|TRUNCATED>,<message>"
+// lines give the message; header lines are skipped
+static bool loadLog(const char* path, std::string& stream, uint32_t& lines,
+                    std::vector<std::string>& validLines) {
+    FILE* in = fopen(path, "r");
+    if (!in) return false;
+    char line[1024];
+    lines = 0;
+    while (fgets(line, sizeof(line), in)) {
+        if (line[0] < '0' || line[0] > '9') continue;
+        char* first = strchr(line, ',');
+        if (!first) continue;
+        char* second = strchr(first + 1, ',');
+        if (!second) continue;
+        char* message = second + 1;
+        message[strcspn(message, "\r\n")] = '\0';
+        // The old receiver only checked a line's last checksum, so a few
+        // VALID lines hold merged frames; keep the single-frame ones
+        if (second - first - 1 == 5 && strncmp(first + 1, "VALID", 5) == 0 &&
+            strchr(message + 1, '$') == NULL) {
+            validLines.push_back(message);
+        }
+        stream += message;
+        stream += '\n';
+        lines++;
+    }
+    fclose(in);
+    return true;
+}
+
+static void replayLog(const char* path, std::string& stream) {
+    uint32_t lines;
+    std::vector<std::string> validLines;
+    if (!loadLog(path, stream, lines, validLines)) {
+        printf("Cannot read %s, skipping the log replay\n\n", path);
+        return;
+    }
+
+    printf("Log %s: %lu lines, %lu single frames marked VALID by the line-based receiver\n", path,
+           (unsigned long)lines, (unsigned long)validLines.size());
+    Result framer = runFramer(stream);
+    Result reference = runReference(stream);
+    printStats("framer", framer.stats);
+    printStats("reference", reference.stats);
+    printf("  %lu frames recovered beyond the VALID lines (%lu resyncs on '$')\n",
+           (unsigned long)(framer.stats.framesValid - validLines.size()),
+           (unsigned long)framer.stats.fragmentsTruncated);
+    check(sameFrames(framer, reference), "emitted frames match the reference");
+    check(sameStats(framer.stats, reference.stats), "counters match the reference");
+    // Each single-frame VALID line comes back as a valid frame, in order
+    size_t next = 0;
+    for (size_t i = 0; i < framer.frames.size() && next < validLines.size(); i++) {
+        if (framer.frames[i].status == FRAME_VALID && framer.frames[i].text == validLines[next]) {
+            next++;
+        }
+    }
+    check(next == validLines.size(), "every VALID line recovered");
+    printf("\n");
+}
+
+// ===== Synthetic Faults =====
+static uint32_t rngState = 1;
+
+static uint32_t rng(uint32_t range) {
+    rngState = rngState * 1664525UL + 1013904223UL;
+    return (rngState >> 8) % range;
+}
+
+static std::string makeFrame(uint32_t sequence, int32_t milli) {
+    char body[96];
+    snprintf(body, sizeof(body), "thrust_test,%04lu,DATA,THST,%ld.%03ld,N,%lu",
+             (unsigned long)(sequence % 10000), (long)(milli / 1000), (long)abs(milli % 1000),
+             (unsigned long)(sequence * 12));
+    uint8_t checksum = 0;
+    for (const char* p = body; *p; p++) checksum ^= (uint8_t)*p;
+    char frame[112];
+    snprintf(frame, sizeof(frame), "$%s*%02X", body, checksum);
+    return frame;
+}
+
+static void replaySynthetic() {
+    std::string stream;
+    std::vector<std::string> clean;
+    uint32_t garbageBytes = 0, truncated = 0, dollars = 0, corrupted = 0, oversized = 0;
+
+    for (uint32_t i = 0; i < SYNTH_FRAMES; i++) {
+        std::string frame = makeFrame(i, (int32_t)rng(4000000) - 1000000);
+        switch (rng(10)) {
+            case 0: {                               // Garbage before the frame
+                uint32_t count = 1 + rng(20);
+                for (uint32_t g = 0; g < count; g++) {
+                    char c;
+                    do { c = (char)rng(256); } while (c == '$' || c == '\r' || c == '\n');
+                    stream += c;
+                }
+                garbageBytes += count;
+                stream += frame;
+                clean.push_back(frame);
+                break;
+            }
+            case 1:                                 // Lost tail, next frame follows
+                stream += frame.substr(0, 1 + rng(frame.size() - 1));
+                truncated++;
+                break;
+            case 2: {                               // '$' inside the body
+                size_t at = 1 + rng(frame.size() - 5);
+                stream += frame.substr(0, at) + "$" + frame.substr(at);
+                dollars++;
+                // The tail keeps the whole frame's checksum, so it is valid
+                // when the cut-off head XORs to zero (always for "$" alone)
+                uint8_t headXor = 0;
+                for (size_t h = 1; h < at; h++) headXor ^= (uint8_t)frame[h];
+                if (headXor == 0) clean.push_back("$" + frame.substr(at));
+                break;
+            }
+            case 3: {                               // Corrupted checksum digit
+                std::string bad = frame;
+                char& digit = bad[bad.size() - 1];
+                digit = digit == '0' ? '1' : '0';
+                stream += bad;
+                corrupted++;
+                break;
+            }
+            case 4: {                               // Oversized frame
+                std::string big = "$";
+                big.append(FRAMER_MAX_FRAME + rng(64), 'X');
+                stream += big + "*00";
+                oversized++;
+                break;
+            }
+            default:
+                stream += frame;
+                clean.push_back(frame);
+                break;
+        }
+        if (rng(2)) stream += rng(2) ? "\r\n" : "\n";
+    }
+    stream += '\n';
+
+    printf("Synthetic: %u frames, %lu clean, %lu garbage bytes, %lu truncated, "
+           "%lu with '$' inside, %lu bad checksums, %lu oversized\n", SYNTH_FRAMES,
+           (unsigned long)clean.size(), (unsigned long)garbageBytes, (unsigned long)truncated,
+           (unsigned long)dollars, (unsigned long)corrupted, (unsigned long)oversized);
+    Result framer = runFramer(stream);
+    Result reference = runReference(stream);
+    printStats("framer", framer.stats);
+    check(sameFrames(framer, reference), "emitted frames match the reference");
+    check(sameStats(framer.stats, reference.stats), "counters match the reference");
+
+    std::vector<std::string> valid;
+    for (size_t i = 0; i < framer.frames.size(); i++) {
+        if (framer.frames[i].status == FRAME_VALID) valid.push_back(framer.frames[i].text);
+    }
+    check(valid == clean, "every clean frame recovered, nothing else");
+    // A '$' splits a frame into a truncated head and a tail that mostly
+    // fails its checksum
+    check(framer.stats.fragmentsTruncated >= truncated + dollars, "truncations and '$' resyncs counted");
+    check(framer.stats.framesBadChecksum >= corrupted, "corrupted checksums counted");
+    check(framer.stats.framesOverflow == oversized, "oversized frames counted");
+    check(framer.stats.bytesDiscarded >= garbageBytes, "garbage bytes discarded");
+    printf("\n");
+}
+
+// ===== Benchmark =====
+static void benchmark(const std::string& stream) {
+    UartFramer framer;
+    uint32_t frames = 0;
+    double best = 0.0;
+    for (int pass = 0; pass < BENCH_PASSES; pass++) {
+        framer.reset();
+        double start = nowNs();
+        for (size_t i = 0; i < stream.size(); i++) {
+            if (framer.push(stream[i]) != FRAME_NONE) frames++;
+        }
+        double ns = (nowNs() - start) / stream.size();
+        if (pass == 0 || ns < best) best = ns;
+    }
+    printf("push(): %.2f ns/byte (best of %d x %zu bytes), %.0f MB/s; "
+           "3 Mbaud is 0.3 MB/s\n", best, BENCH_PASSES, stream.size(), 1e3 / best);
+    if (frames == 0) printf("(no frames)\n");
+}
+
+int main(int argc, char** argv) {
+    std::string stream;
+    if (argc > 1) {
+        replayLog(argv[1], stream);
+    }
+    replaySynthetic();
+
+    if (stream.empty()) {
+        for (uint32_t i = 0; i < SYNTH_FRAMES; i++) stream += makeFrame(i, (int32_t)i) + "\n";
+    }
+    benchmark(stream);
+
+    printf("%s\n", failures ? "FAILED" : "All checks passed");
+    return failures ? 1 : 0;
+}
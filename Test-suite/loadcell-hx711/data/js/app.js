@@ -3,6 +3,8 @@ class ThrustDashboard {
     constructor() {
         this.recording = false;
         this.dataLog = [];
+        this.calibrationState = 'idle';
+        this.calibrationOwner = false;   // This page started the calibration
 
         // Initialize components
         this.initComponents();
@@ -25,8 +27,10 @@ class ThrustDashboard {
             btnStartStop: document.getElementById('btnStartStop'),
             btnReset: document.getElementById('btnReset'),
             btnExport: document.getElementById('btnExport'),
+            btnCapture: document.getElementById('btnCapture'),
             btnCalibrate: document.getElementById('btnCalibrate'),
             calibrationWeight: document.getElementById('calibrationWeight'),
+            calibrationStatus: document.getElementById('calibrationStatus'),
             ipAddress: document.getElementById('ipAddress')
         };
 
@@ -71,15 +75,29 @@ class ThrustDashboard {
             });
         }
 
-        // Calibrate button
+        // Burn capture button: full-rate samples from the stand itself
+        if (this.elements.btnCapture) {
+            this.elements.btnCapture.addEventListener('click', () => {
+                this.downloadCapture();
+            });
+        }
+
+        // Calibrate button: first press reads the empty stand, later presses
+        // (after the zero reading) read the entered weights
         if (this.elements.btnCalibrate) {
             this.elements.btnCalibrate.addEventListener('click', () => {
-                const weight = parseFloat(this.elements.calibrationWeight.value);
-                if (weight > 0) {
-                    wsHandler.calibrate(weight);
+                if (this.calibrationState === 'weight_wait' || this.calibrationState === 'result') {
+                    const weight = parseFloat(this.elements.calibrationWeight.value);
+                    if (weight > 0) {
+                        wsHandler.calibrate('weight', weight);
+                        this.showFeedback(this.elements.btnCalibrate, 'Calibrating...');
+                    } else {
+                        alert('Please enter a valid weight in grams');
+                    }
+                } else if (confirm('Remove all load from the stand, then press OK')) {
+                    this.calibrationOwner = true;
+                    wsHandler.calibrate('start');
                     this.showFeedback(this.elements.btnCalibrate, 'Calibrating...');
-                } else {
-                    alert('Please enter a valid weight in grams');
                 }
             });
         }
@@ -149,6 +167,11 @@ class ThrustDashboard {
             }
         });
 
+        // Calibration progress (from this or any other client, or serial)
+        wsHandler.onCalibration((msg) => {
+            this.updateCalibrationUI(msg);
+        });
+
         // Handle clear signal (sent before tare/reset completes)
         wsHandler.onClear(() => {
             this.resetLocal();
@@ -185,6 +208,31 @@ class ThrustDashboard {
         }
     }
 
+    updateCalibrationUI(msg) {
+        this.calibrationState = msg.state;
+
+        if (this.elements.calibrationStatus) {
+            this.elements.calibrationStatus.textContent = msg.message;
+        }
+        if (this.elements.btnCalibrate) {
+            this.elements.btnCalibrate.textContent =
+                msg.state === 'weight_wait' || msg.state === 'result' ? 'SET WEIGHT' : 'CALIBRATE';
+        }
+
+        // After each point: measure another weight, or apply (saved on the
+        // ESP32) / discard
+        if (msg.state === 'result' && this.calibrationOwner) {
+            if (confirm(`${msg.message}\n\nAdd another known weight?`)) {
+                return;
+            }
+            const apply = confirm('Apply and save the calibration?');
+            wsHandler.calibrate(apply ? 'apply' : 'cancel');
+        }
+        if (msg.state === 'idle') {
+            this.calibrationOwner = false;
+        }
+    }
+
     resetLocal() {
         thrustChart.reset();
         metricsDisplay.reset();
@@ -243,6 +291,41 @@ class ThrustDashboard {
 
         console.log(`Exported ${data.length} data points`);
     }
+
+    // Fetched whole before saving, so re-arming cannot cut the file short
+    async downloadCapture() {
+        let csv;
+        try {
+            const response = await fetch('/api/capture.csv');
+            if (!response.ok) {
+                alert('Burn capture not available');
+                return;
+            }
+            csv = await response.text();
+        } catch (e) {
+            alert('Burn capture download failed');
+            return;
+        }
+
+        if (!csv.includes('time_s,force_N')) {
+            alert('No completed burn capture yet');
+            return;
+        }
+
+        const blob = new Blob([csv], { type: 'text/csv' });
+        const url = URL.createObjectURL(blob);
+        const a = document.createElement('a');
+        a.href = url;
+        a.download = `burn_capture_${Date.now()}.csv`;
+        document.body.appendChild(a);
+        a.click();
+        document.body.removeChild(a);
+        URL.revokeObjectURL(url);
+
+        if (confirm('Capture saved. Re-arm for the next burn?')) {
+            wsHandler.arm();
+        }
+    }
 }
 
 // Initialize on DOM ready
@@ -7,7 +7,7 @@ class ThrustChart {
         this.maxDataPoints = 1600; // ~20 seconds at 80Hz
         this.peakValue = 0;
         this.peakTime = 0;
-        this.updateCounter = 0;
+        this.lastRender = 0;
 
         this.initChart();
     }
@@ -167,11 +167,11 @@ class ThrustChart {
             this.data.shift();
         }
 
-        // Batch update chart every 8 samples (~10Hz visual update at 80Hz data rate)
-        // All data points are stored for accuracy, chart renders less frequently
-        this.updateCounter++;
-        if (this.updateCounter >= 8) {
-            this.updateCounter = 0;
+        // Render at most 10 times a second, however fast the samples arrive
+        // (a burn streams them all). All data points are stored for accuracy
+        const now = performance.now();
+        if (now - this.lastRender >= 100) {
+            this.lastRender = now;
             this.updateChart();
         }
     }
@@ -219,7 +219,7 @@ class ThrustChart {
         this.data = [];
         this.peakValue = 0;
         this.peakTime = 0;
-        this.updateCounter = 0;
+        this.lastRender = 0;
 
         if (this.chart) {
             this.chart.updateSeries([{
@@ -12,7 +12,8 @@ class WebSocketHandler {
             onDisconnect: null,
             onAck: null,
             onInit: null,
-            onClear: null
+            onClear: null,
+            onCalibration: null
         };
     }
 
@@ -65,6 +66,16 @@ class WebSocketHandler {
                     }
                     break;
 
+                case 'batch':
+                    // Every sample of a burn, several per message
+                    if (this.callbacks.onData) {
+                        const count = Math.min(msg.t.length, msg.f.length);
+                        for (let i = 0; i < count; i++) {
+                            this.callbacks.onData(msg.t[i], msg.f[i]);
+                        }
+                    }
+                    break;
+
                 case 'metrics':
                     if (this.callbacks.onMetrics) {
                         this.callbacks.onMetrics(msg);
@@ -85,6 +96,12 @@ class WebSocketHandler {
                     }
                     break;
 
+                case 'calibration':
+                    if (this.callbacks.onCalibration) {
+                        this.callbacks.onCalibration(msg);
+                    }
+                    break;
+
                 case 'clear':
                     console.log('Clear signal received');
                     if (this.callbacks.onClear) {
@@ -115,7 +132,7 @@ class WebSocketHandler {
         }, delay);
     }
 
-    send(command, value = null) {
+    send(command, value = null, extra = null) {
         if (!this.ws || this.ws.readyState !== WebSocket.OPEN) {
             console.warn('WebSocket not connected');
             return false;
@@ -125,6 +142,9 @@ class WebSocketHandler {
         if (value !== null) {
             msg.value = value;
         }
+        if (extra) {
+            Object.assign(msg, extra);
+        }
 
         this.ws.send(JSON.stringify(msg));
         return true;
@@ -147,8 +167,18 @@ class WebSocketHandler {
         return this.send('reset');
     }
 
-    calibrate(weightGrams) {
-        return this.send('calibrate', weightGrams);
+    // Burn capture: fire now / clear and wait for the next burn
+    trigger() {
+        return this.send('trigger');
+    }
+
+    arm() {
+        return this.send('arm');
+    }
+
+    // step: 'start' (stand empty), 'weight' (value = grams), 'apply', 'cancel'
+    calibrate(step, value = null) {
+        return this.send('calibrate', value, { step: step });
     }
 
     // Event registration
@@ -180,6 +210,10 @@ class WebSocketHandler {
         this.callbacks.onClear = callback;
     }
 
+    onCalibration(callback) {
+        this.callbacks.onCalibration = callback;
+    }
+
     isConnected() {
         return this.ws && this.ws.readyState === WebSocket.OPEN;
     }
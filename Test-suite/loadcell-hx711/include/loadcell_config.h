@@ -7,7 +7,21 @@
 // High-speed (80Hz) thrust measurement for rocket motor testing
 // Output in Newtons, bidirectional (tension/compression)
 
+// ===== ADC Backend =====
+// LoadCellModule is LoadCellModuleT<backend>, picked here at compile time:
+//   LOADCELL_ADC_HX711    HX711 (10/80 SPS), 1-4 channels on a shared SCK
+//   LOADCELL_ADC_ADS1220  ADS1220 over SPI (20-2000 SPS), 1 channel
+//   LOADCELL_ADC_SIM      Plays a thrust curve (SimulatedAdc), no hardware
+#define LOADCELL_ADC_HX711 0
+#define LOADCELL_ADC_ADS1220 1
+#define LOADCELL_ADC_SIM 2
+
+#ifndef LOADCELL_ADC
+#define LOADCELL_ADC LOADCELL_ADC_HX711
+#endif
+
 // ===== Pin Validation =====
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
 #ifndef LOADCELL_DOUT_PIN
 #error "LOADCELL_DOUT_PIN not defined. Check platformio.ini build_flags"
 #endif
@@ -15,6 +29,7 @@
 #ifndef LOADCELL_SCK_PIN
 #error "LOADCELL_SCK_PIN not defined. Check platformio.ini build_flags"
 #endif
+#endif
 
 #ifndef BOARD_NAME
 #error "BOARD_NAME not defined. Check platformio.ini build_flags"
@@ -31,6 +46,11 @@
 //   - Cut RATE pin trace to GND, OR
 //   - Bridge RATE pin to VCC
 // Default 10Hz is too slow for thrust curves!
+#ifndef HX711_80HZ_MODE
+#define HX711_80HZ_MODE 1
+#endif
+
+#define HX711_SPS (HX711_80HZ_MODE ? 80.0f : 10.0f)
 
 // ===== Serial Configuration =====
 // High-speed serial for 80Hz output without bottleneck
@@ -50,6 +70,258 @@
 #define CALIBRATION_FACTOR 1496.0f  // Calibrate for your setup!
 #endif
 
+// ===== Multi-Channel Stands =====
+// 2-4 HX711s share LOADCELL_SCK_PIN and are clocked out in lockstep, one
+// DOUT each (all below GPIO32 or all GPIO32+). Each frame carries every
+// channel; forceNewtons is the sum of the channels in LOADCELL_AXIAL_MASK,
+// so e.g. a side-force cell can be logged without adding to thrust.
+// Example 3-cell stand:
+//   -D LOADCELL_CHANNELS=3
+//   -D LOADCELL_DOUT_PINS="{16, 18, 19}"
+//   -D LOADCELL_CAL_FACTORS="{1500.0f, 1480.0f, 1510.0f}"
+#ifndef LOADCELL_CHANNELS
+#define LOADCELL_CHANNELS 1
+#endif
+
+#ifndef LOADCELL_DOUT_PINS
+#define LOADCELL_DOUT_PINS { LOADCELL_DOUT_PIN }
+#endif
+
+#ifndef LOADCELL_CAL_FACTORS
+#define LOADCELL_CAL_FACTORS { CALIBRATION_FACTOR }
+#endif
+
+#ifndef LOADCELL_AXIAL_MASK
+#define LOADCELL_AXIAL_MASK 0xFF           // Bit per channel summed into thrust
+#endif
+
+// ===== ADS1220 Backend =====
+// SCLK/MISO/MOSI on the default SPI pins (18/19/23)
+#ifndef ADS1220_CS_PIN
+#define ADS1220_CS_PIN 15
+#endif
+
+#ifndef ADS1220_DRDY_PIN
+#define ADS1220_DRDY_PIN 16
+#endif
+
+// 20/45/90/175/330/600/1000/2000
+#ifndef ADS1220_SPS
+#define ADS1220_SPS 1000
+#endif
+
+// ===== Simulated Backend =====
+// Curve file path ("" = built-in curve). On the ESP32 LittleFS files are
+// under /littlefs, e.g. "/littlefs/motor.eng" (upload with uploadfs)
+#ifndef SIM_ADC_CURVE_FILE
+#define SIM_ADC_CURVE_FILE ""
+#endif
+
+#ifndef SIM_ADC_SAMPLE_HZ
+#define SIM_ADC_SAMPLE_HZ 1000.0f
+#endif
+
+#ifndef SIM_ADC_NOISE_COUNTS
+#define SIM_ADC_NOISE_COUNTS 150.0f       // RMS, ~0.1 N at 1500 counts/N
+#endif
+
+#if LOADCELL_ADC == LOADCELL_ADC_ADS1220 && LOADCELL_CHANNELS != 1
+#error "The ADS1220 backend reads one channel"
+#endif
+
+// ===== Acquisition Mode =====
+// 1 = DRDY interrupt: the DOUT falling edge (data ready) timestamps the
+//     sample with micros(), clocks it out inside the ISR and pushes it into
+//     a lock-free ring; loop() drains the ring via readIfReady()
+// 0 = polled: readIfReady() checks DOUT from loop() and stamps after the read
+#ifndef HX711_DRDY_INTERRUPT
+#define HX711_DRDY_INTERRUPT 0
+#endif
+
+// Only HX711 reads are interrupt-safe; other backends are polled
+#if LOADCELL_ADC != LOADCELL_ADC_HX711
+#undef HX711_DRDY_INTERRUPT
+#define HX711_DRDY_INTERRUPT 0
+#endif
+
+#ifndef HX711_SAMPLE_QUEUE_SIZE
+#define HX711_SAMPLE_QUEUE_SIZE 64       // Power of two (~0.8 s at 80 Hz)
+#endif
+
+// DOUT held low this long without an interrupt means an edge was missed
+// (e.g. DOUT already low when the ISR was armed); the sample is then read
+// from loop() to re-arm the edge
+#define HX711_DRDY_STALL_US 250000        // Longer than 2 periods at 10 Hz
+
+// ===== Acquisition Task (dual core) =====
+// 1 = sampling and conversion run in their own task pinned to
+//     HX711_ACQ_TASK_CORE at a priority above loop(); samples reach loop()
+//     through a FreeRTOS queue. Build with ARDUINO_RUNNING_CORE=0 so loop()
+//     (dashboard, Teensy UART, serial) shares core 0 with WiFi and AsyncTCP
+//     and core 1 is left to acquisition.
+#ifndef HX711_ACQ_TASK
+#define HX711_ACQ_TASK 0
+#endif
+
+#ifndef HX711_ACQ_TASK_CORE
+#define HX711_ACQ_TASK_CORE 1
+#endif
+
+#ifndef HX711_ACQ_TASK_PRIORITY
+#define HX711_ACQ_TASK_PRIORITY 20         // Above loop() (1) and AsyncTCP
+#endif
+
+#define HX711_ACQ_TASK_STACK 4096          // Bytes
+#define HX711_DATA_QUEUE_SIZE 64           // Converted samples for loop()
+
+// The ADS1220 is read over SPI, which can't run in an ISR. With the task,
+// its DRDY falling edge only stamps micros() and wakes the task, which
+// reads the conversion; without it, loop() polls DRDY
+#if HX711_ACQ_TASK && LOADCELL_ADC == LOADCELL_ADC_ADS1220
+#define ADS1220_DRDY_NOTIFY 1
+#else
+#define ADS1220_DRDY_NOTIFY 0
+#endif
+
+#if HX711_ACQ_TASK && defined(ARDUINO_RUNNING_CORE)
+static_assert(ARDUINO_RUNNING_CORE != HX711_ACQ_TASK_CORE,
+              "loop() should not share a core with the acquisition task");
+#endif
+
+// ===== Force Filter =====
+// Chain applied to the force stream when built with ENABLE_FORCE_FILTER,
+// e.g. "median=5,lowpass=20,avg=4" (see ForceFilter.h). Changeable at
+// runtime with the 'f' command. The raw force stays in the CSV next to the
+// filtered one and is what goes to the Teensy logger.
+#ifndef FORCE_FILTER_SPEC
+#define FORCE_FILTER_SPEC "median=5,lowpass=20"
+#endif
+
+// Per-sample cost budget for the whole chain; exceeding it is reported once
+#define FORCE_FILTER_BUDGET_US 20
+
+// ===== Stand Dynamics =====
+// 'm' records a tap or step on the stand once |force| moves by
+// STAND_ID_TRIGGER_N, identifies its natural frequency and damping
+// (StandIdentifier) and puts "comp=F/Z" at the head of the filter chain.
+// The stand has to ring below ~1/6 of the sample rate to be measured
+#ifndef STAND_ID_TRIGGER_N
+#define STAND_ID_TRIGGER_N 1.0f
+#endif
+
+#ifndef STAND_ID_WINDOW_MS
+#define STAND_ID_WINDOW_MS 1500            // Capped to STAND_ID_MAX_SAMPLES
+#endif
+
+#define STAND_ID_TIMEOUT_MS 60000          // Waiting for the tap
+
+// ===== Sample Rate Monitor =====
+// Every frame's timestamp goes through SampleRateMonitor. At boot the rate
+// is measured for one window (up to SAMPLE_RATE_BOOT_CHECK_MS) before
+// output starts, then checked every window. Below SAMPLE_RATE_WARN_FRACTION
+// of the nominal rate (70 Hz of 80 Hz) a warning is printed.
+#define SAMPLE_RATE_BOOT_CHECK_MS 3000
+
+#ifndef SAMPLE_RATE_WARN_FRACTION
+#define SAMPLE_RATE_WARN_FRACTION 0.875f
+#endif
+
+// ===== Burn Capture =====
+// With ENABLE_BURN_CAPTURE every raw sample also goes into a RAM ring (8
+// bytes each). A burn is kept from CAPTURE_PRETRIGGER_MS before the trigger
+// to CAPTURE_POSTTRIGGER_MS after burn-out, whatever the live outputs did.
+// Download with 'd' or GET /api/capture.csv.
+#ifndef CAPTURE_BUFFER_SAMPLES
+#define CAPTURE_BUFFER_SAMPLES 8192        // ~100 s at 80 Hz, ~8 s at 1 kHz
+#endif
+
+#ifndef CAPTURE_TRIGGER_N
+#define CAPTURE_TRIGGER_N 5.0f             // Burn-out is half of it
+#endif
+
+#ifndef CAPTURE_PRETRIGGER_MS
+#define CAPTURE_PRETRIGGER_MS 3000
+#endif
+
+#ifndef CAPTURE_POSTTRIGGER_MS
+#define CAPTURE_POSTTRIGGER_MS 2000
+#endif
+
+#define CAPTURE_HEAP_RESERVE 40000         // Bytes left free for WiFi/AsyncTCP
+
+// ===== Output QoS =====
+// With ENABLE_OUTPUT_QOS the outputs follow the burn state: during a burn
+// the dashboard gets every sample and status prints wait, while idle the
+// serial CSV is cut to about OUTPUT_QOS_IDLE_CSV_HZ (0 = every sample)
+#ifndef OUTPUT_QOS_BURN_N
+#define OUTPUT_QOS_BURN_N 5.0f             // Burn threshold floor (5% of peak above it)
+#endif
+
+#ifndef OUTPUT_QOS_HOLD_MS
+#define OUTPUT_QOS_HOLD_MS 1000            // Burn mode kept after the last sample above
+#endif
+
+#ifndef OUTPUT_QOS_IDLE_CSV_HZ
+#define OUTPUT_QOS_IDLE_CSV_HZ 10.0f
+#endif
+
+// ===== Thrust Analytics =====
+// With ENABLE_THRUST_ANALYTICS every burn of the (filtered) force is
+// characterized as it happens (ThrustAnalytics): from |force| reaching
+// ANALYTICS_BURN_START_N until it has stayed below ANALYTICS_BURN_END_N for
+// ANALYTICS_BURN_END_HOLD_MS. The report (rise, action time, impulse class,
+// ...) prints once the burn is over; 'l' shows it again
+#ifndef ANALYTICS_BURN_START_N
+#define ANALYTICS_BURN_START_N 5.0f
+#endif
+
+#ifndef ANALYTICS_BURN_END_N
+#define ANALYTICS_BURN_END_N 2.5f
+#endif
+
+#ifndef ANALYTICS_BURN_END_HOLD_MS
+#define ANALYTICS_BURN_END_HOLD_MS 200
+#endif
+
+#define ANALYTICS_MAX_GAP_MS 500           // Longer intervals are not integrated
+
+// ===== Dual-Rate Sampling =====
+// With ENABLE_DUAL_RATE the HX711 RATE pin is wired to HX711_RATE_PIN
+// (shared by every channel) instead of being strapped. The stand runs at
+// DUAL_RATE_SLOW_SPS (less noise) while idle, taring and calibrating and at
+// DUAL_RATE_FAST_SPS once armed ('a') or when |force| rises through
+// DUAL_RATE_TRIGGER_N, back to slow DUAL_RATE_HOLD_MS after the force drops
+// or after DUAL_RATE_ARM_TIMEOUT_MS armed without a burn. HX711_80HZ_MODE
+// is ignored. The simulated backend switches the same way.
+#ifndef DUAL_RATE_SLOW_SPS
+#define DUAL_RATE_SLOW_SPS 10.0f
+#endif
+
+#ifndef DUAL_RATE_FAST_SPS
+#define DUAL_RATE_FAST_SPS 80.0f
+#endif
+
+#ifndef DUAL_RATE_TRIGGER_N
+#define DUAL_RATE_TRIGGER_N 2.0f           // Fallback when not armed: first 100 ms at 10 SPS
+#endif
+
+#ifndef DUAL_RATE_HOLD_MS
+#define DUAL_RATE_HOLD_MS 3000
+#endif
+
+#ifndef DUAL_RATE_ARM_TIMEOUT_MS
+#define DUAL_RATE_ARM_TIMEOUT_MS 600000UL  // 10 min
+#endif
+
+#ifdef ENABLE_DUAL_RATE
+#if LOADCELL_ADC == LOADCELL_ADC_HX711 && !defined(HX711_RATE_PIN)
+#error "ENABLE_DUAL_RATE needs HX711_RATE_PIN (the GPIO wired to the HX711 RATE pin)"
+#endif
+#if LOADCELL_ADC == LOADCELL_ADC_ADS1220
+#error "ENABLE_DUAL_RATE is for the HX711; the ADS1220 rate is set by ADS1220_SPS"
+#endif
+#endif
+
 // ===== Tare Configuration =====
 #define TARE_READINGS 20  // Number of readings for tare (zero) operation
 
@@ -7,6 +7,8 @@
 // UART communication from ESP32 to Teensy for thrust data streaming
 // Uses same protocol as UART-esp32-teensy project for compatibility
 
+#include "loadcell_config.h"
+
 // ===== Pin Configuration (Serial2 remapped) =====
 // GPIO16 is used by HX711 DOUT, so we remap Serial2 pins
 #ifndef TEENSY_UART_TX_PIN
@@ -26,6 +28,114 @@
 #define SENSOR_NAME "THST"
 #define SENSOR_UNIT "N"
 
+// ===== Binary Framing (opt-in) =====
+// 1 = ThrustLink binary frames (shared/ThrustLink): COBS + CRC16, 32-bit
+//     sequence, us timestamp, int32 milli-Newtons; 18 bytes per sample
+// 0 = ASCII $...*CS messages (~45 bytes per sample)
+// The Teensy receiver auto-detects either format.
+#ifndef TEENSY_UART_BINARY
+#define TEENSY_UART_BINARY 0
+#endif
+
+#ifndef TEENSY_UART_DEVICE_ID
+#define TEENSY_UART_DEVICE_ID 1            // Binary device ID (names come from descriptors)
+#endif
+
+#ifndef TEENSY_UART_DESCRIPTOR_INTERVAL_MS
+#define TEENSY_UART_DESCRIPTOR_INTERVAL_MS 1000  // Resend device/sensor names
+#endif
+
+// Batching (binary only): up to BATCH_SAMPLES samples share one frame with a
+// base sequence/timestamp and delta-encoded (dt, dvalue) pairs; a partial
+// batch is flushed once its first sample is BATCH_MAX_MS old. 16 samples
+// at 1 kHz cost ~4 bytes each. 1 = one SAMPLE frame per sample.
+#ifndef TEENSY_UART_BATCH_SAMPLES
+#define TEENSY_UART_BATCH_SAMPLES 16
+#endif
+
+#ifndef TEENSY_UART_BATCH_MAX_MS
+#define TEENSY_UART_BATCH_MAX_MS 20        // Added latency bound
+#endif
+
+// ===== Baud Negotiation =====
+// Starts at TEENSY_UART_BAUD, then negotiates the highest rate from
+// THRUSTLINK_BAUD_RATES (3M, 2M, 921600, 460800) that passes a CRC-checked
+// test pattern; set equal to TEENSY_UART_BAUD to disable.
+#ifndef TEENSY_UART_MAX_BAUD
+#define TEENSY_UART_MAX_BAUD 3000000
+#endif
+
+#ifndef TEENSY_UART_LINK_TIMEOUT_MS
+#define TEENSY_UART_LINK_TIMEOUT_MS 1000   // No ACK at a negotiated rate -> fallback
+#endif
+
+#ifndef TEENSY_UART_RENEGOTIATE_MS
+#define TEENSY_UART_RENEGOTIATE_MS 10000   // Retry when no rate could be agreed
+#endif
+
+// ===== Transmit Queue =====
+// Frames are queued in RAM and handed to the UART driver only as far as its
+// TX ring has room, so sendThrustData() never blocks the HX711 loop. When
+// the queue is full, the overflow policy decides which frame is dropped;
+// dropped samples stay in the history and are recovered by retransmission.
+#define TEENSY_UART_DROP_OLDEST 0
+#define TEENSY_UART_DROP_NEWEST 1
+
+#ifndef TEENSY_UART_TX_POLICY
+#define TEENSY_UART_TX_POLICY TEENSY_UART_DROP_OLDEST
+#endif
+
+#ifndef TEENSY_UART_TX_QUEUE_SIZE
+#define TEENSY_UART_TX_QUEUE_SIZE 4096     // Bytes (~90 ASCII samples)
+#endif
+
+#ifndef TEENSY_UART_TX_RING_SIZE
+#define TEENSY_UART_TX_RING_SIZE 1024      // UART driver TX ring (bytes)
+#endif
+
+// ===== Windowed ACK / Retransmission =====
+// The Teensy periodically sends $ACKW,<DEVICE>,<CUM>,<MISSING>*CS: the highest
+// contiguous message ID and a hex bitmap of holes after it. Recently sent
+// samples are kept so only the holes are retransmitted.
+//
+// Samples taken while a new rate is negotiated are held in the same history
+// and sent, oldest first, once the link is ready again; the next attempt
+// waits until they are out. One attempt holds samples for at most
+// TEENSY_UART_NEGOTIATION_HOLD_MS: an unanswered $BAUDREQ (300 ms), or the
+// settle time (20 ms) plus an unanswered test pattern (300 ms), 620 ms in
+// all. The history must hold TEENSY_UART_MAX_SPS samples for that long
+// (50 at 80 SPS, 620 at 1 kHz, 1240 at 2 kHz); TeensyUART.h checks it.
+// Held samples the history overwrites anyway are counted as heldLost.
+#define TEENSY_UART_NEGOTIATION_HOLD_MS (2 * THRUSTLINK_BAUD_STEP_TIMEOUT_MS + THRUSTLINK_BAUD_SETTLE_MS)
+
+#ifndef TEENSY_UART_MAX_SPS
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
+#define TEENSY_UART_MAX_SPS 80
+#elif LOADCELL_ADC == LOADCELL_ADC_ADS1220
+#define TEENSY_UART_MAX_SPS ADS1220_SPS
+#else
+#define TEENSY_UART_MAX_SPS SIM_ADC_SAMPLE_HZ
+#endif
+#endif
+
+#ifndef TEENSY_UART_HISTORY_SIZE
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
+#define TEENSY_UART_HISTORY_SIZE 256    // Sent samples kept (~3 s at 80 Hz)
+#elif LOADCELL_ADC == LOADCELL_ADC_ADS1220 && ADS1220_SPS > 1000
+#define TEENSY_UART_HISTORY_SIZE 2048   // ~1 s at 2 kHz
+#else
+#define TEENSY_UART_HISTORY_SIZE 1024   // ~1 s at 1 kHz
+#endif
+#endif
+
+#ifndef TEENSY_UART_RETX_MAX
+#define TEENSY_UART_RETX_MAX 16         // Retransmits per received ACK
+#endif
+
+#ifndef TEENSY_UART_RETX_HOLDOFF_MS
+#define TEENSY_UART_RETX_HOLDOFF_MS 100 // Min time before resending a sample
+#endif
+
 // ===== Wiring Guide =====
 // ESP32           Teensy 4.1
 // =====           ==========
@@ -24,6 +24,12 @@
 #define WS_METRICS_RATE_HZ 4
 #define WS_METRICS_INTERVAL_MS (1000 / WS_METRICS_RATE_HZ)
 
+// Burn-aware streaming (WebDashboard::setStreamMode): data rate while idle,
+// and how a burn's full-rate samples are batched into messages
+#define WS_IDLE_DATA_INTERVAL_MS 200
+#define WS_BURN_FLUSH_MS 25
+#define WS_BURN_BATCH_SAMPLES 40
+
 // ===== Dashboard Features =====
 // Burn detection threshold (percentage of peak)
 #define BURN_THRESHOLD_PERCENT 5.0f
@@ -0,0 +1,140 @@
+#include "ADS1220Adc.h"
+
+// Commands
+#define ADS1220_CMD_POWERDOWN 0x02
+#define ADS1220_CMD_RESET 0x06
+#define ADS1220_CMD_START 0x08
+#define ADS1220_CMD_RREG 0x20       // | (reg << 2) | (count - 1)
+#define ADS1220_CMD_WREG 0x40
+
+// Register 0: AIN0-AIN1, gain 128, PGA on
+#define ADS1220_REG0 0x0E
+// Register 1: data rate (bits 7:5), mode (4:3), continuous (2)
+#define ADS1220_MODE_NORMAL 0x00
+#define ADS1220_MODE_TURBO 0x10
+#define ADS1220_CONTINUOUS 0x04
+// Register 2: external reference REFP0/REFN0, no 50/60 Hz filter
+#define ADS1220_REG2 0x40
+// Register 3: IDACs off, DRDY pin only
+#define ADS1220_REG3 0x00
+
+struct ADS1220Rate {
+    uint16_t sps;
+    uint8_t reg1;
+};
+
+// Normal mode up to 1000 SPS, turbo for 2000
+static const ADS1220Rate ADS1220_RATES[] = {
+    {20,   (0 << 5) | ADS1220_MODE_NORMAL},
+    {45,   (1 << 5) | ADS1220_MODE_NORMAL},
+    {90,   (2 << 5) | ADS1220_MODE_NORMAL},
+    {175,  (3 << 5) | ADS1220_MODE_NORMAL},
+    {330,  (4 << 5) | ADS1220_MODE_NORMAL},
+    {600,  (5 << 5) | ADS1220_MODE_NORMAL},
+    {1000, (6 << 5) | ADS1220_MODE_NORMAL},
+    {2000, (6 << 5) | ADS1220_MODE_TURBO},
+};
+
+// ===== Constructor =====
+ADS1220Adc::ADS1220Adc() :
+    _csPin(0),
+    _drdyPin(0),
+    _sampleRateHz(0.0f),
+    _spi(ADS1220_SPI_HZ, MSBFIRST, SPI_MODE1)
+{
+}
+
+// ===== Initialization =====
+bool ADS1220Adc::begin(uint8_t csPin, uint8_t drdyPin, uint16_t sps) {
+    _csPin = csPin;
+    _drdyPin = drdyPin;
+    pinMode(_csPin, OUTPUT);
+    digitalWrite(_csPin, HIGH);
+    pinMode(_drdyPin, INPUT_PULLUP);
+    SPI.begin();
+
+    command(ADS1220_CMD_RESET);
+    delay(1);                       // >= 50 us + 32 t(CLK) after RESET
+
+    const uint8_t count = sizeof(ADS1220_RATES) / sizeof(ADS1220_RATES[0]);
+    const ADS1220Rate* rate = &ADS1220_RATES[count - 1];
+    for (uint8_t i = 0; i < count; i++) {
+        if (ADS1220_RATES[i].sps >= sps) {
+            rate = &ADS1220_RATES[i];
+            break;
+        }
+    }
+
+    uint8_t config[4] = {ADS1220_REG0, (uint8_t)(rate->reg1 | ADS1220_CONTINUOUS),
+                         ADS1220_REG2, ADS1220_REG3};
+    writeRegisters(config);
+
+    // An absent chip reads back as all 0x00 or all 0xFF
+    uint8_t check[4];
+    readRegisters(check);
+    if (memcmp(config, check, sizeof(config)) != 0) return false;
+
+    _sampleRateHz = rate->sps;
+    command(ADS1220_CMD_START);
+    return true;
+}
+
+// ===== Reading =====
+void ADS1220Adc::readAll(int32_t* values) {
+    while (!isReady()) {
+        delayMicroseconds(10);
+    }
+
+    // Continuous mode: the conversion is shifted out directly, no RDATA
+    SPI.beginTransaction(_spi);
+    digitalWrite(_csPin, LOW);
+    uint32_t raw = (uint32_t)SPI.transfer(0xFF) << 16;
+    raw |= (uint32_t)SPI.transfer(0xFF) << 8;
+    raw |= SPI.transfer(0xFF);
+    digitalWrite(_csPin, HIGH);
+    SPI.endTransaction();
+
+    // Sign-extend the 24-bit two's complement value
+    values[0] = (int32_t)(raw << 8) >> 8;
+}
+
+// ===== Power Management =====
+void ADS1220Adc::powerDown() {
+    command(ADS1220_CMD_POWERDOWN);
+}
+
+void ADS1220Adc::powerUp() {
+    // Any START/SYNC wakes the device and restarts conversions
+    command(ADS1220_CMD_START);
+}
+
+// ===== SPI =====
+void ADS1220Adc::command(uint8_t cmd) {
+    SPI.beginTransaction(_spi);
+    digitalWrite(_csPin, LOW);
+    SPI.transfer(cmd);
+    digitalWrite(_csPin, HIGH);
+    SPI.endTransaction();
+}
+
+void ADS1220Adc::writeRegisters(const uint8_t* values) {
+    SPI.beginTransaction(_spi);
+    digitalWrite(_csPin, LOW);
+    SPI.transfer(ADS1220_CMD_WREG | 0x03);  // Registers 0-3
+    for (uint8_t i = 0; i < 4; i++) {
+        SPI.transfer(values[i]);
+    }
+    digitalWrite(_csPin, HIGH);
+    SPI.endTransaction();
+}
+
+void ADS1220Adc::readRegisters(uint8_t* values) {
+    SPI.beginTransaction(_spi);
+    digitalWrite(_csPin, LOW);
+    SPI.transfer(ADS1220_CMD_RREG | 0x03);
+    for (uint8_t i = 0; i < 4; i++) {
+        values[i] = SPI.transfer(0xFF);
+    }
+    digitalWrite(_csPin, HIGH);
+    SPI.endTransaction();
+}
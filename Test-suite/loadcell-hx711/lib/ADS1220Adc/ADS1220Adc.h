@@ -0,0 +1,65 @@
+#ifndef ADS1220_ADC_H
+#define ADS1220_ADC_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+// ============================================================================
+// ADS1220 ADC Backend
+// ============================================================================
+// ADC policy for LoadCellModuleT on a TI ADS1220: 24-bit delta-sigma over
+// SPI at 20-2000 SPS, for ignition transients the HX711's 80 SPS misses.
+// One bridge on AIN0/AIN1, PGA gain 128, ratiometric reference on
+// REFP0/REFN0 (tie them to the bridge excitation), continuous conversion.
+// Reads use SPI and cannot run in an interrupt: the DRDY edge handler only
+// wakes the acquisition task (ADS1220_DRDY_NOTIFY), otherwise DRDY is polled.
+//
+// Wiring (ESP32 VSPI):
+//   SCLK -> GPIO18, DOUT/DRDY -> GPIO19 (MISO), DIN -> GPIO23 (MOSI),
+//   CS -> csPin, DRDY -> drdyPin
+
+#define ADS1220_SPI_HZ 4000000      // t(SCLK) >= 150 ns
+
+class ADS1220Adc {
+public:
+    ADS1220Adc();
+
+    // Reset, configure and start continuous conversion at the closest rate
+    // at or above sps (max 2000). False if the register read-back fails.
+    bool begin(uint8_t csPin, uint8_t drdyPin, uint16_t sps);
+
+    // ===== ADC Policy =====
+    uint8_t getChannelCount() const { return 1; }
+    float getSampleRate() const { return _sampleRateHz; }
+    bool setSampleRate(float hz) { return false; }     // Fixed by begin()
+    uint32_t getSettlingUs() const { return 0; }
+    bool isReady() const { return digitalRead(_drdyPin) == LOW; }
+    void readAll(int32_t* values);          // Blocking
+    uint32_t nowUs() const { return micros(); }
+    unsigned long nowMs() const { return millis(); }
+    void idle() { delay(1); }
+    void powerDown();
+    void powerUp();
+
+    // ===== DRDY Edge =====
+    // Falls once per conversion, read or not; the handler must not use SPI
+    void attachDataReady(void (*handler)()) {
+        attachInterrupt(digitalPinToInterrupt(_drdyPin), handler, FALLING);
+    }
+
+    void detachDataReady() {
+        detachInterrupt(digitalPinToInterrupt(_drdyPin));
+    }
+
+private:
+    void command(uint8_t cmd);
+    void writeRegisters(const uint8_t* values);
+    void readRegisters(uint8_t* values);
+
+    uint8_t _csPin;
+    uint8_t _drdyPin;
+    float _sampleRateHz;
+    SPISettings _spi;
+};
+
+#endif // ADS1220_ADC_H
@@ -0,0 +1,256 @@
+#include "BurnCapture.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// readCsv() cursor after the "no capture" line
+#define CAPTURE_LINE_LOST 0xFFFFFFFFUL
+
+// ===== Constructor =====
+BurnCapture::BurnCapture() :
+    _buffer(nullptr),
+    _capacity(0),
+    _head(0),
+    _filled(0),
+    _triggerN(5.0f),
+    _burnoutN(2.5f),
+    _preUs(2000000UL),
+    _postUs(2000000UL),
+    _state(CAPTURE_OFF),
+    _source(CAPTURE_TRIGGER_NONE),
+    _armRequest(false),
+    _triggerRequest(false),
+    _wasBelow(false),
+    _arming(false),
+    _reading(false),
+    _readUs(0),
+    _start(0),
+    _captured(0),
+    _preSamples(0),
+    _triggerUs(0),
+    _lastAboveUs(0),
+    _peakN(0.0f),
+    _truncated(false)
+{
+}
+
+BurnCapture::~BurnCapture() {
+    free(_buffer);
+}
+
+// ===== Setup =====
+uint32_t BurnCapture::begin(uint32_t maxSamples, uint32_t minSamples) {
+    free(_buffer);
+    _buffer = nullptr;
+    _capacity = 0;
+
+    for (uint32_t n = maxSamples; n >= minSamples && n > 0; n /= 2) {
+        _buffer = (CaptureSample*)malloc(n * sizeof(CaptureSample));
+        if (_buffer) {
+            _capacity = n;
+            break;
+        }
+    }
+    if (!_buffer) {
+        _state = CAPTURE_OFF;
+        return 0;
+    }
+
+    _armRequest = true;
+    _state = CAPTURE_ARMED;
+    return _capacity;
+}
+
+void BurnCapture::configure(float triggerN, uint32_t preTriggerMs, uint32_t postTriggerMs) {
+    _triggerN = fabsf(triggerN);
+    _burnoutN = _triggerN * 0.5f;
+    _preUs = preTriggerMs * 1000UL;
+    _postUs = postTriggerMs * 1000UL;
+}
+
+// ===== Per Frame =====
+bool BurnCapture::record(float forceN, uint32_t timestampUs, bool allowForceTrigger) {
+    if (!_buffer) return false;
+
+    CaptureState previous = _state;
+    if (_armRequest && applyArm(timestampUs)) {
+        _armRequest = false;
+    }
+
+    if (_state == CAPTURE_COMPLETE) {
+        _triggerRequest = false;
+        return _state != previous;
+    }
+
+    // Overwrite the oldest sample
+    _buffer[_head] = { timestampUs, forceN };
+    _head = _head + 1 == _capacity ? 0 : _head + 1;
+    if (_filled < _capacity) _filled++;
+
+    float absForce = fabsf(forceN);
+
+    if (_state == CAPTURE_ARMED) {
+        bool crossed = allowForceTrigger && _wasBelow && absForce >= _triggerN;
+        // A load applied while triggering is off (a calibration weight)
+        // has to come off again before it can trigger
+        if (!allowForceTrigger) _wasBelow = false;
+        else if (absForce < _triggerN) _wasBelow = true;
+
+        if (_triggerRequest) {
+            _triggerRequest = false;
+            startCapture(timestampUs, CAPTURE_TRIGGER_COMMAND);
+        } else if (crossed) {
+            startCapture(timestampUs, CAPTURE_TRIGGER_FORCE);
+        }
+        return _state != previous;
+    }
+
+    // Triggered: the capture grows by one sample
+    _triggerRequest = false;
+    _captured++;
+    if (absForce > _peakN) _peakN = absForce;
+    if (absForce >= _burnoutN) _lastAboveUs = timestampUs;
+
+    if (timestampUs - _lastAboveUs >= _postUs) {
+        _state = CAPTURE_COMPLETE;
+    } else if (_captured == _capacity) {
+        // The next write would overwrite the first captured sample
+        _truncated = true;
+        _state = CAPTURE_COMPLETE;
+    }
+    return _state != previous;
+}
+
+// Re-arm, unless a download is reading the capture
+bool BurnCapture::applyArm(uint32_t timestampUs) {
+    _arming.store(true);
+    // The sample may be older than the last read; that still counts as held
+    bool held = _reading.load() &&
+                (int32_t)(timestampUs - _readUs.load()) < (int32_t)CAPTURE_READ_LEASE_US;
+    if (!held) {
+        _head = 0;
+        _filled = 0;
+        _captured = 0;
+        _preSamples = 0;
+        _source = CAPTURE_TRIGGER_NONE;
+        _wasBelow = false;
+        _truncated = false;
+        _state = CAPTURE_ARMED;
+        _reading.store(false);
+    }
+    _arming.store(false);
+    return !held;
+}
+
+// The sample just written is the trigger sample; keep everything back to
+// preTriggerMs before it
+void BurnCapture::startCapture(uint32_t timestampUs, CaptureTrigger source) {
+    uint32_t count = 1;
+    uint32_t index = _head == 0 ? _capacity - 1 : _head - 1;
+    while (count < _filled) {
+        uint32_t previous = index == 0 ? _capacity - 1 : index - 1;
+        if (timestampUs - _buffer[previous].timestampUs > _preUs) break;
+        index = previous;
+        count++;
+    }
+
+    _start = index;
+    _captured = count;
+    _preSamples = count - 1;
+    _triggerUs = timestampUs;
+    _lastAboveUs = timestampUs;
+    _source = source;
+
+    _peakN = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        float absForce = fabsf(getSample(i).forceN);
+        if (absForce > _peakN) _peakN = absForce;
+    }
+
+    _state = _captured == _capacity ? CAPTURE_COMPLETE : CAPTURE_TRIGGERED;
+    _truncated = _state == CAPTURE_COMPLETE;
+}
+
+// ===== Status =====
+const char* BurnCapture::getStateName() const {
+    switch (_state) {
+        case CAPTURE_OFF:       return "off";
+        case CAPTURE_ARMED:     return "armed";
+        case CAPTURE_TRIGGERED: return "triggered";
+        case CAPTURE_COMPLETE:  return "complete";
+    }
+    return "unknown";
+}
+
+float BurnCapture::getDurationS() const {
+    if (_captured < 2) return 0.0f;
+    return (getSample(_captured - 1).timestampUs - getSample(0).timestampUs) * 1e-6f;
+}
+
+const CaptureSample& BurnCapture::getSample(uint32_t index) const {
+    uint32_t i = _start + index;
+    if (i >= _capacity) i -= _capacity;
+    return _buffer[i];
+}
+
+float BurnCapture::getTimeS(uint32_t index) const {
+    return (int32_t)(getSample(index).timestampUs - _triggerUs) * 1e-6f;
+}
+
+// ===== Export =====
+size_t BurnCapture::formatCsv(char* out, size_t maxLen, uint32_t* line) const {
+    size_t length = 0;
+
+    if (*line == 0) {
+        int n = snprintf(out, maxLen,
+                         "# Burn capture: %s trigger, %lu samples (%lu pre-trigger)%s\n"
+                         "# Trigger %.2f N, pre %lu ms, post %lu ms, peak %.3f N\n"
+                         "time_s,force_N\n",
+                         _source == CAPTURE_TRIGGER_COMMAND ? "command" : "force",
+                         (unsigned long)_captured, (unsigned long)_preSamples,
+                         _truncated ? ", truncated (buffer full)" : "",
+                         _triggerN, (unsigned long)(_preUs / 1000), (unsigned long)(_postUs / 1000),
+                         _peakN);
+        if (n < 0 || (size_t)n >= maxLen) return 0;
+        length = n;
+        (*line)++;
+    }
+
+    while (*line <= _captured) {
+        // Exact us: a float of seconds loses them after ~10 s
+        uint32_t index = *line - 1;
+        int32_t us = (int32_t)(getSample(index).timestampUs - _triggerUs);
+        uint32_t magnitude = us < 0 ? -(uint32_t)us : (uint32_t)us;
+        char row[40];
+        int n = snprintf(row, sizeof(row), "%s%lu.%06lu,%.4f\n", us < 0 ? "-" : "",
+                         (unsigned long)(magnitude / 1000000UL), (unsigned long)(magnitude % 1000000UL),
+                         getSample(index).forceN);
+        if (n < 0 || length + n >= maxLen) break;
+        for (int i = 0; i < n; i++) {
+            out[length + i] = row[i];
+        }
+        length += n;
+        (*line)++;
+    }
+    return length;
+}
+
+size_t BurnCapture::readCsv(char* out, size_t maxLen, uint32_t* line, uint32_t nowUs) {
+    if (*line == CAPTURE_LINE_LOST) return 0;
+
+    _readUs.store(nowUs);
+    _reading.store(true);
+    if (!_arming.load() && _state == CAPTURE_COMPLETE) {
+        size_t length = formatCsv(out, maxLen, line);
+        if (length == 0) _reading.store(false);
+        return length;
+    }
+
+    // Nothing to read, or re-armed after the reader went quiet
+    _reading.store(false);
+    int n = *line == 0 ? snprintf(out, maxLen, "# No completed capture (state %s)\n", getStateName())
+                       : snprintf(out, maxLen, "# Capture re-armed during the download; file incomplete\n");
+    *line = CAPTURE_LINE_LOST;
+    if (n < 0) return 0;
+    return (size_t)n < maxLen ? n : maxLen - 1;
+}
@@ -0,0 +1,129 @@
+#ifndef BURN_CAPTURE_H
+#define BURN_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// ============================================================================
+// Pre-Trigger Burn Capture
+// ============================================================================
+// Every full-rate sample goes into a RAM ring, whatever the live outputs
+// do. While armed the ring keeps rolling. A trigger keeps the last
+// preTriggerMs of it and captures on, until |force| has stayed below half
+// the trigger level for postTriggerMs:
+//   - force trigger: |force| rises through triggerN (it has to be below the
+//     level once after arming, so a weight left on the stand cannot fire it)
+//   - command trigger: trigger(), e.g. from serial or the dashboard
+// The capture is then frozen until arm(). If it would overwrite its own
+// first sample it stops early and is marked truncated.
+//
+// record() runs in loop(). trigger() and arm() only set flags and may be
+// called from any context; record() acts on them. Read the samples only
+// while the state is CAPTURE_COMPLETE, when nothing writes to them; from
+// another task, use readCsv(), which keeps arm() waiting until it is done.
+// Arduino-free.
+
+// A download silent this long has gone away; a held arm() then goes ahead
+#ifndef CAPTURE_READ_LEASE_US
+#define CAPTURE_READ_LEASE_US 5000000UL
+#endif
+
+enum CaptureState : uint8_t {
+    CAPTURE_OFF,                // No buffer
+    CAPTURE_ARMED,              // Rolling, waiting for a trigger
+    CAPTURE_TRIGGERED,          // Capturing until burn-out + post window
+    CAPTURE_COMPLETE            // Frozen, exportable
+};
+
+enum CaptureTrigger : uint8_t {
+    CAPTURE_TRIGGER_NONE,
+    CAPTURE_TRIGGER_FORCE,
+    CAPTURE_TRIGGER_COMMAND
+};
+
+struct CaptureSample {
+    uint32_t timestampUs;
+    float forceN;
+};
+
+class BurnCapture {
+public:
+    BurnCapture();
+    ~BurnCapture();
+
+    // Allocates up to maxSamples (8 bytes each), halving on failure down to
+    // minSamples; returns the capacity, 0 if even that did not fit. Armed
+    uint32_t begin(uint32_t maxSamples, uint32_t minSamples = 1024);
+    void configure(float triggerN, uint32_t preTriggerMs, uint32_t postTriggerMs);
+
+    void arm() { _triggerRequest = false; _armRequest = true; }
+    void trigger() { _triggerRequest = true; }
+
+    // Every frame; true if the state changed
+    bool record(float forceN, uint32_t timestampUs, bool allowForceTrigger = true);
+
+    // ===== Status =====
+    CaptureState getState() const { return _state; }
+    const char* getStateName() const;
+    CaptureTrigger getTriggerSource() const { return _source; }
+    uint32_t getCapacity() const { return _capacity; }
+    uint32_t getSampleCount() const { return _captured; }     // Capture so far
+    uint32_t getPreTriggerSamples() const { return _preSamples; }
+    bool isTruncated() const { return _truncated; }
+    float getPeakN() const { return _peakN; }
+    float getDurationS() const;                                 // First to last sample
+    float getTriggerN() const { return _triggerN; }
+    uint32_t getPreTriggerMs() const { return _preUs / 1000; }
+    uint32_t getPostTriggerMs() const { return _postUs / 1000; }
+
+    // index 0 = first pre-trigger sample
+    const CaptureSample& getSample(uint32_t index) const;
+    // Seconds from the trigger (negative before it)
+    float getTimeS(uint32_t index) const;
+
+    // CSV export in pieces: fills out with whole lines starting at *line
+    // (0 = header) and advances it; returns the length, 0 when done
+    size_t formatCsv(char* out, size_t maxLen, uint32_t* line) const;
+    // formatCsv() for another task (the web server). Each call claims the
+    // capture, and record() holds a pending arm() back until the last
+    // chunk or CAPTURE_READ_LEASE_US without a call. If there is no
+    // complete capture to read, the chunk is a "#" line saying so
+    size_t readCsv(char* out, size_t maxLen, uint32_t* line, uint32_t nowUs);
+
+private:
+    void startCapture(uint32_t timestampUs, CaptureTrigger source);
+    bool applyArm(uint32_t timestampUs);    // False while a download holds it
+
+    CaptureSample* _buffer;
+    uint32_t _capacity;
+    uint32_t _head;             // Next write
+    uint32_t _filled;           // Valid samples in the ring
+
+    float _triggerN;
+    float _burnoutN;
+    uint32_t _preUs;
+    uint32_t _postUs;
+
+    CaptureState _state;
+    CaptureTrigger _source;
+    volatile bool _armRequest;
+    volatile bool _triggerRequest;
+    bool _wasBelow;             // Force was under the trigger level since arming
+
+    // Each side sets its flag before checking the other's, so an arm and a
+    // download starting together cannot both go ahead
+    std::atomic<bool> _arming;
+    std::atomic<bool> _reading;
+    std::atomic<uint32_t> _readUs;          // Last readCsv() call
+
+    uint32_t _start;            // Ring index of the first captured sample
+    uint32_t _captured;
+    uint32_t _preSamples;
+    uint32_t _triggerUs;
+    uint32_t _lastAboveUs;      // Last sample at or above the burn-out level
+    float _peakN;
+    bool _truncated;
+};
+
+#endif // BURN_CAPTURE_H
@@ -0,0 +1,55 @@
+#include "CalibrationStore.h"
+#include <Preferences.h>
+#include <string.h>
+
+// ===== Storage =====
+bool CalibrationStore::load(uint8_t channel, CalibrationTable& table) {
+    Preferences prefs;
+    if (!prefs.begin(CALIBRATION_NVS_NAMESPACE, true)) return false;
+
+    char name[8];
+    key(channel, name);
+    Record record;
+    bool ok = prefs.getBytesLength(name) == sizeof(record) &&
+              prefs.getBytes(name, &record, sizeof(record)) == sizeof(record);
+    prefs.end();
+
+    if (!ok || record.version != CALIBRATION_NVS_VERSION) return false;
+    // setPoints() re-validates, so a damaged record leaves the table alone
+    return table.setPoints(record.points, record.count);
+}
+
+bool CalibrationStore::save(uint8_t channel, const CalibrationTable& table) {
+    if (table.isLinear()) return false;
+
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.version = CALIBRATION_NVS_VERSION;
+    record.count = table.getPointCount();
+    for (uint8_t i = 0; i < record.count; i++) {
+        record.points[i] = table.getPoint(i);
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(CALIBRATION_NVS_NAMESPACE, false)) return false;
+    char name[8];
+    key(channel, name);
+    bool ok = prefs.putBytes(name, &record, sizeof(record)) == sizeof(record);
+    prefs.end();
+    return ok;
+}
+
+bool CalibrationStore::erase(uint8_t channel) {
+    Preferences prefs;
+    if (!prefs.begin(CALIBRATION_NVS_NAMESPACE, false)) return false;
+    char name[8];
+    key(channel, name);
+    bool ok = prefs.remove(name);
+    prefs.end();
+    return ok;
+}
+
+void CalibrationStore::key(uint8_t channel, char* out) {
+    memcpy(out, "cal0", 5);
+    out[3] = (char)('0' + channel);
+}
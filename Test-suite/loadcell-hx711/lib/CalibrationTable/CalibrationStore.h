@@ -0,0 +1,38 @@
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include <Arduino.h>
+#include "CalibrationTable.h"
+
+// ============================================================================
+// Calibration Persistence (NVS)
+// ============================================================================
+// Keeps one CalibrationTable per channel in the ESP32 NVS partition through
+// Preferences, so an applied calibration survives a power cycle. Only the
+// points are stored; segment slopes are rebuilt on load. A stored table
+// replaces the build-flag factor for its channel at boot.
+//
+// NVS writes pause the flash cache for a few ms: save() belongs to
+// operator actions (apply), never to the sample path.
+
+#define CALIBRATION_NVS_NAMESPACE "loadcell"
+#define CALIBRATION_NVS_VERSION 1
+
+class CalibrationStore {
+public:
+    bool load(uint8_t channel, CalibrationTable& table);
+    bool save(uint8_t channel, const CalibrationTable& table);
+    bool erase(uint8_t channel);
+
+private:
+    struct Record {
+        uint8_t version;
+        uint8_t count;
+        uint8_t reserved[2];
+        CalibrationPoint points[CAL_TABLE_MAX_POINTS];
+    };
+
+    static void key(uint8_t channel, char* out);   // "cal0".."cal3"
+};
+
+#endif // CALIBRATION_STORE_H
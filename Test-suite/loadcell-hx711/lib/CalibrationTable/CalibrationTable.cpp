@@ -0,0 +1,90 @@
+#include "CalibrationTable.h"
+
+// ===== Constructor =====
+CalibrationTable::CalibrationTable() :
+    _pointCount(0),
+    _linear(true),
+    _factor(1.0f),
+    _binShift(0)
+{
+    setLinear(1.0f);
+}
+
+// ===== Setup =====
+void CalibrationTable::setLinear(float countsPerNewton) {
+    if (countsPerNewton < 0.0f) countsPerNewton = -countsPerNewton;
+    if (countsPerNewton == 0.0f) countsPerNewton = 1.0f;
+
+    // One point well out on the same line as the factor
+    _points[0].counts = 1000000;
+    _points[0].forceN = 1000000.0f / countsPerNewton;
+    _pointCount = 1;
+    _linear = true;
+    build();
+    _factor = countsPerNewton;
+    _slope[0] = 1.0f / countsPerNewton;
+}
+
+bool CalibrationTable::setPoints(const CalibrationPoint* points, uint8_t count) {
+    if (count == 0 || count > CAL_TABLE_MAX_POINTS) return false;
+
+    // Insertion sort of the magnitudes
+    CalibrationPoint sorted[CAL_TABLE_MAX_POINTS];
+    for (uint8_t i = 0; i < count; i++) {
+        CalibrationPoint p = points[i];
+        if (p.counts < 0) p.counts = -p.counts;
+        if (p.forceN < 0.0f) p.forceN = -p.forceN;
+        if (p.counts == 0 || !(p.forceN > 0.0f)) return false;
+
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1].counts > p.counts) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = p;
+    }
+
+    for (uint8_t i = 1; i < count; i++) {
+        if (sorted[i].counts == sorted[i - 1].counts) return false;
+        if (!(sorted[i].forceN > sorted[i - 1].forceN)) return false;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        _points[i] = sorted[i];
+    }
+    _pointCount = count;
+    _linear = false;
+    build();
+    return true;
+}
+
+// Segment k runs from point k-1 (the origin for k = 0) to point k; the
+// last segment continues past the last point
+void CalibrationTable::build() {
+    uint32_t prevCounts = 0;
+    float prevForce = 0.0f;
+    for (uint8_t k = 0; k < _pointCount; k++) {
+        uint32_t counts = (uint32_t)_points[k].counts;
+        _knot[k] = prevCounts;
+        _slope[k] = (_points[k].forceN - prevForce) / (float)(counts - prevCounts);
+        _intercept[k] = prevForce - _slope[k] * (float)prevCounts;
+        prevCounts = counts;
+        prevForce = _points[k].forceN;
+    }
+    _knot[_pointCount] = UINT32_MAX;
+    _factor = (float)_points[_pointCount - 1].counts / _points[_pointCount - 1].forceN;
+
+    // Bins span up to the start of the last segment
+    uint32_t span = _knot[_pointCount - 1];
+    _binShift = 0;
+    while (_binShift < 31 && (span >> _binShift) >= CAL_TABLE_BINS) {
+        _binShift++;
+    }
+
+    uint8_t segment = 0;
+    for (uint32_t bin = 0; bin < CAL_TABLE_BINS; bin++) {
+        uint32_t start = bin << _binShift;
+        while (start >= _knot[segment + 1]) segment++;
+        _binSegment[bin] = segment;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef CALIBRATION_TABLE_H
+#define CALIBRATION_TABLE_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Multi-Point Calibration Table
+// ============================================================================
+// Piecewise-linear map from tared ADC counts to Newtons through the origin
+// and up to CAL_TABLE_MAX_POINTS known weights. Loads are symmetric: the
+// table is built on |counts| and the sign of the reading is kept, the same
+// as a single calibration factor (so inverted cells still read negative).
+//
+// Every segment stores its slope and intercept, so evaluate() is one
+// multiply-add after finding the segment. The segment comes from a
+// CAL_TABLE_BINS-entry lookup indexed by a shift of the counts, plus a
+// compare against the next knot: constant time for any table whose
+// segments are wider than one bin, which is the normal case.
+//
+// A single point (or setLinear()) is the classic factor in counts/N.
+
+#define CAL_TABLE_MAX_POINTS 8      // Known weights per channel (zero is implicit)
+#define CAL_TABLE_BINS 64
+
+struct CalibrationPoint {
+    int32_t counts;                 // ADC counts above the zero reading
+    float forceN;                   // Known load in Newtons
+};
+
+class CalibrationTable {
+public:
+    CalibrationTable();
+
+    // One straight line, countsPerNewton must be non-zero (|value| is used)
+    void setLinear(float countsPerNewton);
+    // Points in any order and sign; false (table unchanged) if two points
+    // share a count or the force does not rise with the count
+    bool setPoints(const CalibrationPoint* points, uint8_t count);
+
+    inline float evaluate(int32_t counts) const {
+        // Sign without branches: readings near zero flip sign with noise
+        int32_t sign = counts >> 31;                        // 0 or -1
+        uint32_t magnitude = (uint32_t)((counts ^ sign) - sign);
+        uint32_t bin = magnitude >> _binShift;
+        if (bin > CAL_TABLE_BINS - 1) bin = CAL_TABLE_BINS - 1;
+
+        uint8_t segment = _binSegment[bin];
+        while (magnitude >= _knot[segment + 1]) segment++;
+
+        float force = _slope[segment] * (float)magnitude + _intercept[segment];
+        return force * (float)(sign | 1);
+    }
+
+    bool isLinear() const { return _linear; }           // From setLinear()
+    uint8_t getPointCount() const { return _pointCount; }
+    const CalibrationPoint& getPoint(uint8_t index) const { return _points[index]; }
+    // Overall sensitivity in counts/N (last point, or the linear factor)
+    float getFactor() const { return _factor; }
+
+private:
+    void build();
+
+    CalibrationPoint _points[CAL_TABLE_MAX_POINTS];     // Sorted, positive
+    uint8_t _pointCount;
+    bool _linear;
+    float _factor;
+
+    // Segment k covers [_knot[k], _knot[k + 1]); the last one is open-ended
+    uint32_t _knot[CAL_TABLE_MAX_POINTS + 1];
+    float _slope[CAL_TABLE_MAX_POINTS];
+    float _intercept[CAL_TABLE_MAX_POINTS];
+    uint8_t _binSegment[CAL_TABLE_BINS];
+    uint8_t _binShift;
+};
+
+#endif // CALIBRATION_TABLE_H
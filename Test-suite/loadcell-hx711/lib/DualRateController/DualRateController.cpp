@@ -0,0 +1,183 @@
+#include "DualRateController.h"
+#include <math.h>
+#include <string.h>
+
+// ===== Constructor =====
+DualRateController::DualRateController(LoadCellModule& loadCell) :
+    _loadCell(loadCell),
+    _eventCallback(nullptr),
+    _slowHz(10.0f),
+    _fastHz(80.0f),
+    _triggerN(2.0f),
+    _holdUs(3000000UL),
+    _armTimeoutUs(600000000UL),
+    _mode(RATE_IDLE),
+    _lastUs(0),
+    _modeStartUs(0),
+    _lastAboveUs(0),
+    _wasBelow(false),
+    _history(),
+    _historyIndex(0),
+    _historyCount(0),
+    _slowMean(),
+    _fastSum(),
+    _fastCount(0),
+    _learning(false)
+{
+}
+
+void DualRateController::configure(float slowHz, float fastHz, float triggerN, uint32_t holdMs,
+                                   uint32_t armTimeoutMs) {
+    _slowHz = slowHz;
+    _fastHz = fastHz;
+    _triggerN = triggerN;
+    _holdUs = holdMs * 1000UL;
+    _armTimeoutUs = armTimeoutMs * 1000UL;
+}
+
+// ===== Commands =====
+bool DualRateController::arm() {
+    if (_mode == RATE_FIRING) return false;
+    if (_mode == RATE_ARMED) {
+        // Again: the timeout starts over
+        _modeStartUs = _lastUs;
+        return true;
+    }
+
+    // The shift is only measured against a full history of the quiet stand
+    _learning = _historyCount == DUAL_RATE_SHIFT_READINGS;
+    if (_learning) {
+        for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+            long sum = 0;
+            for (uint8_t i = 0; i < DUAL_RATE_SHIFT_READINGS; i++) {
+                sum += _history[i][ch];
+            }
+            _slowMean[ch] = sum / DUAL_RATE_SHIFT_READINGS;
+            _fastSum[ch] = 0;
+        }
+        _fastCount = 0;
+    }
+    return switchTo(RATE_ARMED);
+}
+
+void DualRateController::disarm() {
+    if (_mode != RATE_IDLE) switchTo(RATE_IDLE);
+}
+
+// ===== Sample Stream =====
+void DualRateController::update(const ThrustData& data, bool holdSlow) {
+    _lastUs = data.timestampUs;
+    bool above = fabsf(data.forceNewtons) >= _triggerN;
+
+    switch (_mode) {
+        case RATE_IDLE:
+            for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+                _history[_historyIndex][ch] = data.channelRaw[ch];
+            }
+            _historyIndex = (_historyIndex + 1) % DUAL_RATE_SHIFT_READINGS;
+            if (_historyCount < DUAL_RATE_SHIFT_READINGS) _historyCount++;
+
+            // Rising edge only: a load left on the stand is not a burn
+            if (holdSlow) {
+                _wasBelow = false;
+            } else if (!above) {
+                _wasBelow = true;
+            } else if (_wasBelow) {
+                _lastAboveUs = _lastUs;
+                switchTo(RATE_FIRING);
+            }
+            break;
+
+        case RATE_ARMED:
+            if (holdSlow) {
+                switchTo(RATE_IDLE);
+                break;
+            }
+            if (above) {
+                if (_learning) {
+                    _learning = false;
+                    emit(RATE_EVENT_SHIFT_REJECTED);
+                }
+                // Already fast: the mode changes, the rate stays
+                _mode = RATE_FIRING;
+                _modeStartUs = _lastUs;
+                _lastAboveUs = _lastUs;
+                break;
+            }
+            if (_learning) {
+                learnShift(data);
+            }
+            if (_lastUs - _modeStartUs >= _armTimeoutUs) {
+                switchTo(RATE_IDLE);
+            }
+            break;
+
+        case RATE_FIRING:
+            if (above) {
+                _lastAboveUs = _lastUs;
+            } else if (_lastUs - _lastAboveUs >= _holdUs) {
+                switchTo(RATE_IDLE);
+            }
+            break;
+    }
+}
+
+// Frames reaching update() have settled at the fast rate (the module drops
+// the others)
+void DualRateController::learnShift(const ThrustData& data) {
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        _fastSum[ch] += data.channelRaw[ch];
+    }
+    if (++_fastCount < DUAL_RATE_SHIFT_READINGS) return;
+    _learning = false;
+
+    long shift[LOADCELL_CHANNELS];
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        shift[ch] = _fastSum[ch] / DUAL_RATE_SHIFT_READINGS - _slowMean[ch];
+        if (labs(shift[ch]) > DUAL_RATE_SHIFT_LIMIT) {
+            emit(RATE_EVENT_SHIFT_REJECTED);
+            return;
+        }
+    }
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        _loadCell.setRateShift(ch, shift[ch]);
+    }
+    emit(RATE_EVENT_SHIFT_LEARNED);
+}
+
+bool DualRateController::switchTo(DualRateMode mode) {
+    bool fast = mode != RATE_IDLE;
+    if (!_loadCell.setSampleRate(fast ? _fastHz : _slowHz)) {
+        _learning = false;
+        emit(RATE_EVENT_FAILED);
+        return false;
+    }
+
+    _mode = mode;
+    _modeStartUs = _lastUs;
+    if (!fast) {
+        // The history restarts from the settled slow rate
+        _historyIndex = 0;
+        _historyCount = 0;
+        _learning = false;
+        _wasBelow = false;
+    }
+    emit(fast ? RATE_EVENT_FAST : RATE_EVENT_SLOW);
+    return true;
+}
+
+void DualRateController::emit(DualRateEvent event) {
+    if (_eventCallback) {
+        _eventCallback(*this, event);
+    }
+}
+
+// ===== Status =====
+const char* DualRateController::getModeName() const {
+    switch (_mode) {
+        case RATE_IDLE:   return "idle";
+        case RATE_ARMED:  return "armed";
+        case RATE_FIRING: return "firing";
+    }
+    return "unknown";
+}
@@ -0,0 +1,101 @@
+#ifndef DUAL_RATE_CONTROLLER_H
+#define DUAL_RATE_CONTROLLER_H
+
+#include <stdint.h>
+#include "LoadCellModule.h"
+
+// ============================================================================
+// Dual-Rate Sampling Controller
+// ============================================================================
+// Picks the ADC rate from what the stand is doing, for ADCs that can
+// switch (HX711 with RATE on a GPIO, the simulated ADC):
+//   RATE_IDLE    slow rate: lower noise for idle, tare and calibration
+//   RATE_ARMED   fast rate by arm(), waiting for the burn
+//   RATE_FIRING  fast rate: |force| rose through the trigger (from idle
+//                too, as a fallback), until it has been below for holdMs
+// Armed without a burn for armTimeoutMs goes back to slow.
+//
+// The zero differs slightly between rates. arm() on a quiet stand measures
+// it: the mean of the last DUAL_RATE_SHIFT_READINGS slow frames against the
+// first settled fast ones. The difference becomes the module's rate shift,
+// so one tare holds at both rates. A force trigger from idle switches
+// under load and keeps the last shift.
+//
+// update() takes every ThrustData that loop() reads. holdSlow (e.g. a tare
+// or calibration running) sends an armed stand back to slow and blocks the
+// force trigger, so calibration weights do not count as a burn; a burn in
+// progress is never interrupted.
+
+#define DUAL_RATE_SHIFT_READINGS 8
+#define DUAL_RATE_SHIFT_LIMIT 5000      // Counts; a larger shift means the load moved
+
+enum DualRateMode : uint8_t {
+    RATE_IDLE,
+    RATE_ARMED,
+    RATE_FIRING
+};
+
+enum DualRateEvent : uint8_t {
+    RATE_EVENT_FAST,            // Now at the fast rate (armed or firing)
+    RATE_EVENT_SLOW,
+    RATE_EVENT_SHIFT_LEARNED,   // Zero shift between the rates measured
+    RATE_EVENT_SHIFT_REJECTED,  // Load moved while measuring; last shift kept
+    RATE_EVENT_FAILED           // The ADC did not switch
+};
+
+class DualRateController;
+typedef void (*DualRateEventCallback)(const DualRateController& controller, DualRateEvent event);
+
+class DualRateController {
+public:
+    explicit DualRateController(LoadCellModule& loadCell);
+
+    void onEvent(DualRateEventCallback callback) { _eventCallback = callback; }
+    void configure(float slowHz, float fastHz, float triggerN, uint32_t holdMs, uint32_t armTimeoutMs);
+
+    // ===== Commands (loop() context) =====
+    bool arm();             // False while firing or if the ADC cannot switch
+    void disarm();          // Slow now, also mid-burn
+
+    // Every frame
+    void update(const ThrustData& data, bool holdSlow = false);
+
+    // ===== Status =====
+    DualRateMode getMode() const { return _mode; }
+    const char* getModeName() const;
+    bool isFast() const { return _mode != RATE_IDLE; }
+    float getSlowRate() const { return _slowHz; }
+    float getFastRate() const { return _fastHz; }
+    float getTriggerN() const { return _triggerN; }
+
+private:
+    bool switchTo(DualRateMode mode);
+    void learnShift(const ThrustData& data);
+    void emit(DualRateEvent event);
+
+    LoadCellModule& _loadCell;
+    DualRateEventCallback _eventCallback;
+
+    float _slowHz;
+    float _fastHz;
+    float _triggerN;
+    uint32_t _holdUs;
+    uint32_t _armTimeoutUs;
+
+    DualRateMode _mode;
+    uint32_t _lastUs;           // Last frame
+    uint32_t _modeStartUs;
+    uint32_t _lastAboveUs;
+    bool _wasBelow;
+
+    // Last slow frames, then the first fast frames after arm()
+    long _history[DUAL_RATE_SHIFT_READINGS][LOADCELL_CHANNELS];
+    uint8_t _historyIndex;
+    uint8_t _historyCount;
+    long _slowMean[LOADCELL_CHANNELS];
+    long _fastSum[LOADCELL_CHANNELS];
+    uint8_t _fastCount;
+    bool _learning;
+};
+
+#endif // DUAL_RATE_CONTROLLER_H
@@ -0,0 +1,335 @@
+#include "ForceFilter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define Q30_ONE (1L << 30)
+
+static int32_t toQ30(double value) {
+    return (int32_t)lround(value * Q30_ONE);
+}
+
+// ===== Configuration =====
+ForceFilterChain::ForceFilterChain() : _stageCount(0) {
+    memset(_stages, 0, sizeof(_stages));
+}
+
+bool ForceFilterChain::configure(const char* spec, float sampleRateHz) {
+    ForceFilterStage stages[FORCE_FILTER_MAX_STAGES];
+    uint8_t count = 0;
+
+    char buffer[64];
+    strncpy(buffer, spec ? spec : "", sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    char* save = NULL;
+    for (char* token = strtok_r(buffer, ", ", &save); token; token = strtok_r(NULL, ", ", &save)) {
+        if (strcmp(token, "off") == 0) continue;
+
+        char* equals = strchr(token, '=');
+        if (!equals || count >= FORCE_FILTER_MAX_STAGES) return false;
+        *equals = '\0';
+
+        // One value, or up to three separated by '/' (comp)
+        float params[3];
+        uint8_t paramCount = 0;
+        for (char* p = equals + 1;; p++) {
+            char* end;
+            params[paramCount++] = strtof(p, &end);
+            if (end == p) return false;
+            if (*end == '\0') break;
+            if (*end != '/' || paramCount == 3) return false;
+            p = end;
+        }
+
+        if (strcmp(token, "comp") == 0) {
+            if (paramCount < 2) return false;
+            float bandwidthHz = paramCount == 3 ? params[2] : 0.0f;
+            if (!initCompensation(stages[count], params[0], params[1], bandwidthHz, sampleRateHz)) {
+                return false;
+            }
+            count++;
+            continue;
+        }
+        if (paramCount != 1) return false;
+        float param = params[0];
+
+        ForceFilterType type;
+        if (strcmp(token, "median") == 0) {
+            type = FILTER_MEDIAN;
+        } else if (strcmp(token, "lowpass") == 0) {
+            type = FILTER_LOWPASS;
+        } else if (strcmp(token, "avg") == 0) {
+            type = FILTER_AVERAGE;
+        } else {
+            return false;
+        }
+
+        if (!initStage(stages[count], type, param, sampleRateHz)) return false;
+        count++;
+    }
+
+    memcpy(_stages, stages, sizeof(ForceFilterStage) * count);
+    _stageCount = count;
+    return true;
+}
+
+bool ForceFilterChain::initStage(ForceFilterStage& stage, ForceFilterType type, float param,
+                                 float sampleRateHz) {
+    memset(&stage, 0, sizeof(stage));
+    stage.type = type;
+
+    switch (type) {
+        case FILTER_MEDIAN:
+            if (param < 3 || param > FORCE_FILTER_MEDIAN_MAX || ((int)param % 2) == 0) return false;
+            stage.length = (uint8_t)param;
+            return true;
+
+        case FILTER_AVERAGE:
+            if (param < 2 || param > FORCE_FILTER_AVG_MAX) return false;
+            stage.length = (uint8_t)param;
+            return true;
+
+        case FILTER_LOWPASS: {
+            if (sampleRateHz <= 0 || param <= 0 || param >= sampleRateHz * 0.45f) return false;
+            stage.cutoffHz = param;
+
+            // RBJ cookbook low-pass, Q = 1/sqrt(2) (Butterworth)
+            double w0 = 2.0 * M_PI * param / sampleRateHz;
+            double alpha = sin(w0) / (2.0 * M_SQRT1_2);
+            double cosw0 = cos(w0);
+            double a0 = 1.0 + alpha;
+            stage.b0 = toQ30((1.0 - cosw0) / 2.0 / a0);
+            stage.b1 = toQ30((1.0 - cosw0) / a0);
+            stage.b2 = stage.b0;
+            stage.a1 = toQ30(-2.0 * cosw0 / a0);
+            stage.a2 = toQ30((1.0 - alpha) / a0);
+            return true;
+        }
+
+        case FILTER_COMPENSATE:
+            break;  // initCompensation()
+    }
+    return false;
+}
+
+// Matched-z: the numerator's zeros sit on the stand's poles, the new poles
+// are a Butterworth pair at the target bandwidth; unity gain at DC
+bool ForceFilterChain::initCompensation(ForceFilterStage& stage, float naturalHz, float dampingRatio,
+                                        float bandwidthHz, float sampleRateHz) {
+    memset(&stage, 0, sizeof(stage));
+    stage.type = FILTER_COMPENSATE;
+    stage.cutoffHz = naturalHz;
+    stage.dampingRatio = dampingRatio;
+    stage.bandwidthHz = bandwidthHz;
+
+    float targetHz = bandwidthHz > 0.0f ? bandwidthHz : naturalHz * FORCE_FILTER_COMP_SPEEDUP;
+    if (sampleRateHz <= 0 || naturalHz <= 0 || naturalHz >= sampleRateHz * 0.45f) return false;
+    if (dampingRatio <= 0 || dampingRatio >= 1 || bandwidthHz < 0) return false;
+    if (targetHz >= sampleRateHz * 0.45f) return false;
+
+    double t = 1.0 / sampleRateHz;
+    double wn = 2.0 * M_PI * naturalHz;
+    double r = exp(-dampingRatio * wn * t);
+    double c1 = -2.0 * r * cos(wn * t * sqrt(1.0 - (double)dampingRatio * dampingRatio));
+    double c2 = r * r;
+
+    double wc = 2.0 * M_PI * targetHz;
+    double rc = exp(-M_SQRT1_2 * wc * t);
+    double a1 = -2.0 * rc * cos(wc * t * M_SQRT1_2);
+    double a2 = rc * rc;
+
+    double gain = (1.0 + a1 + a2) / (1.0 + c1 + c2);
+    double limit = (double)(1L << (31 - FORCE_FILTER_COMP_Q));
+    if (gain * 2.0 >= limit) return false;
+
+    double scale = (double)(1L << FORCE_FILTER_COMP_Q);
+    stage.b0 = (int32_t)lround(gain * scale);
+    stage.b1 = (int32_t)lround(gain * c1 * scale);
+    stage.b2 = (int32_t)lround(gain * c2 * scale);
+    stage.a1 = toQ30(a1);
+    stage.a2 = toQ30(a2);
+    return true;
+}
+
+void ForceFilterChain::setSampleRate(float sampleRateHz) {
+    for (uint8_t i = 0; i < _stageCount; i++) {
+        ForceFilterStage& stage = _stages[i];
+        bool valid;
+        float cutoffHz = stage.cutoffHz;
+        if (stage.type == FILTER_LOWPASS) {
+            valid = initStage(stage, FILTER_LOWPASS, cutoffHz, sampleRateHz);
+            stage.cutoffHz = cutoffHz;
+        } else if (stage.type == FILTER_COMPENSATE) {
+            float dampingRatio = stage.dampingRatio;
+            float bandwidthHz = stage.bandwidthHz;
+            valid = initCompensation(stage, cutoffHz, dampingRatio, bandwidthHz, sampleRateHz);
+        } else {
+            continue;
+        }
+        if (!valid) {
+            // Unity biquad: y = x exactly, same cost
+            stage.b0 = stage.type == FILTER_COMPENSATE ? (1L << FORCE_FILTER_COMP_Q) : Q30_ONE;
+            stage.b1 = stage.b2 = stage.a1 = stage.a2 = 0;
+        }
+    }
+    reset();
+}
+
+void ForceFilterChain::describe(char* out, size_t size) const {
+    if (size == 0) return;
+    out[0] = '\0';
+    if (_stageCount == 0) {
+        snprintf(out, size, "off");
+        return;
+    }
+
+    size_t used = 0;
+    for (uint8_t i = 0; i < _stageCount && used < size; i++) {
+        const ForceFilterStage& stage = _stages[i];
+        const char* separator = i > 0 ? "," : "";
+        int written = 0;
+        switch (stage.type) {
+            case FILTER_MEDIAN:
+                written = snprintf(out + used, size - used, "%smedian=%u", separator, stage.length);
+                break;
+            case FILTER_LOWPASS:
+                written = snprintf(out + used, size - used, "%slowpass=%g", separator, (double)stage.cutoffHz);
+                break;
+            case FILTER_AVERAGE:
+                written = snprintf(out + used, size - used, "%savg=%u", separator, stage.length);
+                break;
+            case FILTER_COMPENSATE:
+                written = snprintf(out + used, size - used, "%scomp=%g/%g", separator,
+                                   (double)stage.cutoffHz, (double)stage.dampingRatio);
+                if (written >= 0 && stage.bandwidthHz > 0 && used + written < size) {
+                    used += written;
+                    written = snprintf(out + used, size - used, "/%g", (double)stage.bandwidthHz);
+                }
+                break;
+        }
+        if (written < 0) break;
+        used += written;
+    }
+}
+
+void ForceFilterChain::reset() {
+    for (uint8_t i = 0; i < _stageCount; i++) {
+        ForceFilterStage& stage = _stages[i];
+        stage.index = 0;
+        stage.count = 0;
+        stage.sum = 0;
+        stage.x1 = stage.x2 = stage.y1 = stage.y2 = 0;
+    }
+}
+
+// ===== Processing =====
+float ForceFilterChain::process(float forceNewtons) {
+    if (_stageCount == 0) return forceNewtons;
+    int32_t value = (int32_t)lroundf(forceNewtons * FORCE_FILTER_SCALE);
+    return processFixed(value) / (float)FORCE_FILTER_SCALE;
+}
+
+int32_t ForceFilterChain::processFixed(int32_t value) {
+    for (uint8_t i = 0; i < _stageCount; i++) {
+        ForceFilterStage& stage = _stages[i];
+        switch (stage.type) {
+            case FILTER_MEDIAN:  value = runMedian(stage, value); break;
+            case FILTER_LOWPASS: value = runLowpass(stage, value); break;
+            case FILTER_AVERAGE: value = runAverage(stage, value); break;
+            case FILTER_COMPENSATE: value = runCompensation(stage, value); break;
+        }
+    }
+    return value;
+}
+
+int32_t ForceFilterChain::runMedian(ForceFilterStage& stage, int32_t value) {
+    stage.window[stage.index] = value;
+    if (++stage.index == stage.length) stage.index = 0;
+    if (stage.count < stage.length) stage.count++;
+
+    // Insertion sort of at most 9 values
+    int32_t sorted[FORCE_FILTER_MEDIAN_MAX];
+    for (uint8_t i = 0; i < stage.count; i++) {
+        int32_t v = stage.window[i];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    return sorted[stage.count / 2];
+}
+
+int32_t ForceFilterChain::runLowpass(ForceFilterStage& stage, int32_t value) {
+    // Start from steady state at the first sample instead of ringing up from 0
+    if (stage.count == 0) {
+        stage.x1 = stage.x2 = stage.y1 = stage.y2 = value;
+        stage.count = 1;
+    }
+
+    int64_t acc = (int64_t)stage.b0 * value
+                + (int64_t)stage.b1 * stage.x1
+                + (int64_t)stage.b2 * stage.x2
+                - (int64_t)stage.a1 * stage.y1
+                - (int64_t)stage.a2 * stage.y2;
+    int32_t out = (int32_t)((acc + (Q30_ONE >> 1)) >> 30);
+
+    stage.x2 = stage.x1;
+    stage.x1 = value;
+    stage.y2 = stage.y1;
+    stage.y1 = out;
+    return out;
+}
+
+int32_t ForceFilterChain::runAverage(ForceFilterStage& stage, int32_t value) {
+    if (stage.count == stage.length) {
+        stage.sum -= stage.window[stage.index];
+    } else {
+        // ceil(2^32 / count), only while the window fills
+        stage.count++;
+        stage.recip = 0xFFFFFFFFUL / stage.count + 1;
+    }
+    stage.window[stage.index] = value;
+    stage.sum += value;
+    if (++stage.index == stage.length) stage.index = 0;
+
+    if (stage.count == 1) return value;
+
+    // Round half away from zero: (|sum| + count/2) / count as a 32x32->64
+    // multiply by the reciprocal, which is exact or one too high. A 64-bit
+    // division only if the sum has left int32
+    if (stage.sum > INT32_MIN && stage.sum <= INT32_MAX) {
+        int32_t sum = (int32_t)stage.sum;
+        uint32_t dividend = (sum < 0 ? -(uint32_t)sum : (uint32_t)sum) + stage.count / 2;
+        uint32_t mean = (uint32_t)(((uint64_t)dividend * stage.recip) >> 32);
+        if (mean * stage.count > dividend) mean--;
+        return sum < 0 ? -(int32_t)mean : (int32_t)mean;
+    }
+    int64_t half = stage.count / 2;
+    return (int32_t)((stage.sum >= 0 ? stage.sum + half : stage.sum - half) / stage.count);
+}
+
+int32_t ForceFilterChain::runCompensation(ForceFilterStage& stage, int32_t value) {
+    // Start from steady state, as the low-pass does
+    if (stage.count == 0) {
+        stage.x1 = stage.x2 = stage.y1 = stage.y2 = value;
+        stage.count = 1;
+    }
+
+    // Numerator in Q8.24, lifted to the Q2.30 of the feedback terms
+    int64_t acc = ((int64_t)stage.b0 * value
+                 + (int64_t)stage.b1 * stage.x1
+                 + (int64_t)stage.b2 * stage.x2) * (1 << (30 - FORCE_FILTER_COMP_Q))
+                - (int64_t)stage.a1 * stage.y1
+                - (int64_t)stage.a2 * stage.y2;
+    int32_t out = (int32_t)((acc + (Q30_ONE >> 1)) >> 30);
+
+    stage.x2 = stage.x1;
+    stage.x1 = value;
+    stage.y2 = stage.y1;
+    stage.y1 = out;
+    return out;
+}
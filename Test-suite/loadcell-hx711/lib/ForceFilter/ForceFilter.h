@@ -0,0 +1,109 @@
+#ifndef FORCE_FILTER_H
+#define FORCE_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// Force Filter Chain
+// ============================================================================
+// Per-sample filter pipeline for the force stream, configured at runtime
+// from a short spec string, e.g. "median=5,lowpass=20,avg=4":
+//   median=N   Median of the last N samples (odd, 3-9): rejects spikes
+//   lowpass=F  2nd-order Butterworth IIR low-pass at F Hz (biquad, F below
+//              0.45 x sample rate)
+//   avg=N      Moving average of the last N samples (2-32)
+//   comp=F/Z[/B]  Stand dynamic compensation: inverts a mass-spring-damper
+//              ringing at natural frequency F Hz with damping ratio Z
+//              (0-1, see StandIdentifier) and leaves a 2nd-order
+//              Butterworth response at B Hz (default
+//              FORCE_FILTER_COMP_SPEEDUP x F), both below 0.45 x sample
+//              rate. Noise above F is amplified up to (B/F)^2
+//   off        No filtering (output = input)
+// Stages run in the order given, up to FORCE_FILTER_MAX_STAGES.
+//
+// Everything after configure() is fixed point: samples are int32 in
+// 1/FORCE_FILTER_SCALE N (0.1 mN, +-214 kN), biquad coefficients are
+// Q2.30 with a 64-bit accumulator (the comp stage's numerator is Q8.24,
+// as its gain reaches (B/F)^2), the moving average keeps an exact running
+// sum and divides it exactly by multiplying with a 32-bit reciprocal of
+// the window. No floats or 64-bit divisions per sample except the
+// conversion in process(float); a 32-bit division per sample while an
+// average window fills, and a 64-bit one if its sum leaves int32 (+-214 kN
+// in total).
+//
+// Has no Arduino dependencies so it can also be built natively to run
+// recorded logs through each stage.
+
+#define FORCE_FILTER_MAX_STAGES 4
+#define FORCE_FILTER_MEDIAN_MAX 9
+#define FORCE_FILTER_AVG_MAX 32
+#define FORCE_FILTER_SCALE 10000        // Fixed-point units per Newton
+#define FORCE_FILTER_COMP_SPEEDUP 2.0f  // Default comp bandwidth / natural frequency
+#define FORCE_FILTER_COMP_Q 24          // Comp numerator fraction bits
+
+enum ForceFilterType : uint8_t {
+    FILTER_MEDIAN,
+    FILTER_LOWPASS,
+    FILTER_AVERAGE,
+    FILTER_COMPENSATE
+};
+
+struct ForceFilterStage {
+    ForceFilterType type;
+    uint8_t length;             // Median/average window
+    float cutoffHz;             // Low-pass cutoff; comp natural frequency
+    float dampingRatio;         // Comp only
+    float bandwidthHz;          // Comp only, 0 = default
+
+    // Median/average window
+    int32_t window[FORCE_FILTER_AVG_MAX];
+    uint8_t index;
+    uint8_t count;
+    int64_t sum;
+    uint32_t recip;             // Average: ceil(2^32 / count)
+
+    // Biquad (direct form I)
+    int32_t b0, b1, b2, a1, a2; // Q2.30 (comp b: Q8.24)
+    int32_t x1, x2, y1, y2;
+};
+
+class ForceFilterChain {
+public:
+    ForceFilterChain();
+
+    // Parse a spec (see above) for the given sample rate. On error the
+    // previous chain is kept and false is returned.
+    bool configure(const char* spec, float sampleRateHz);
+
+    // Current chain in spec form ("off" when empty)
+    void describe(char* out, size_t size) const;
+
+    // Same chain at another sample rate (dual-rate ADCs), state cleared. A
+    // low-pass too close to the new Nyquist frequency passes samples through
+    // unchanged there; the spec keeps its cutoff for the next rate
+    void setSampleRate(float sampleRateHz);
+
+    int32_t processFixed(int32_t value);
+    float process(float forceNewtons);
+
+    // Clear filter state (e.g. after a tare) without changing the chain
+    void reset();
+
+    uint8_t getStageCount() const { return _stageCount; }
+    bool isActive() const { return _stageCount > 0; }
+
+private:
+    static bool initStage(ForceFilterStage& stage, ForceFilterType type, float param, float sampleRateHz);
+    static bool initCompensation(ForceFilterStage& stage, float naturalHz, float dampingRatio,
+                                 float bandwidthHz, float sampleRateHz);
+    static int32_t runMedian(ForceFilterStage& stage, int32_t value);
+    static int32_t runLowpass(ForceFilterStage& stage, int32_t value);
+    static int32_t runAverage(ForceFilterStage& stage, int32_t value);
+    static int32_t runCompensation(ForceFilterStage& stage, int32_t value);
+
+    ForceFilterStage _stages[FORCE_FILTER_MAX_STAGES];
+    uint8_t _stageCount;
+};
+
+#endif // FORCE_FILTER_H
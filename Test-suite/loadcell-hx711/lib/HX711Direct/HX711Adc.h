@@ -0,0 +1,88 @@
+#ifndef HX711_ADC_H
+#define HX711_ADC_H
+
+#include <Arduino.h>
+#include "HX711Direct.h"
+
+// ============================================================================
+// HX711 ADC Backend
+// ============================================================================
+// ADC policy for LoadCellModuleT on top of HX711Direct: 1-4 HX711s on a
+// shared SCK, 10/80 SPS. The only backend whose reads are safe inside the
+// DOUT (DRDY) interrupt, so the only one for HX711_DRDY_INTERRUPT.
+//
+// The RATE pin is either strapped (the rate given to begin() is only
+// reported) or wired to a GPIO, shared by every HX711, which
+// setSampleRate() drives: LOW 10 SPS, HIGH 80 SPS. After a change the
+// output needs HX711_SETTLE_PERIODS conversions to settle (datasheet:
+// 400 ms at 10 SPS, 50 ms at 80 SPS).
+
+#define HX711_SETTLE_PERIODS 4
+
+class HX711Adc {
+public:
+    HX711Adc() : _doutPins(), _sampleRateHz(80.0f), _ratePin(-1) {}
+
+    // False if the DOUT pins span both GPIO banks. ratePin -1 = strapped
+    bool begin(const uint8_t* doutPins, uint8_t count, uint8_t sckPin, float sampleRateHz,
+               int8_t ratePin = -1) {
+        if (!_scale.begin(doutPins, count, sckPin)) return false;
+        memcpy(_doutPins, doutPins, count);
+        _sampleRateHz = sampleRateHz;
+        _ratePin = ratePin;
+        if (_ratePin >= 0) {
+            pinMode(_ratePin, OUTPUT);
+            setSampleRate(sampleRateHz);
+        }
+        return true;
+    }
+
+    // Measured cost of the transfers (see HX711Direct)
+    HX711ReadCost getReadCost() const { return _scale.getReadCost(); }
+
+    // ===== ADC Policy =====
+    uint8_t getChannelCount() const { return _scale.getChannelCount(); }
+    float getSampleRate() const { return _sampleRateHz; }
+    // 80 SPS for 80 and above, 10 SPS below; false if RATE is strapped
+    bool setSampleRate(float hz) {
+        if (_ratePin < 0) return false;
+        _sampleRateHz = hz >= 80.0f ? 80.0f : 10.0f;
+        digitalWrite(_ratePin, _sampleRateHz == 80.0f ? HIGH : LOW);
+        return true;
+    }
+    uint32_t getSettlingUs() const { return (uint32_t)(HX711_SETTLE_PERIODS * 1000000.0f / _sampleRateHz); }
+    // Forced inline: also called from the IRAM interrupt handler
+    __attribute__((always_inline)) bool isReady() const { return _scale.is_ready(); }
+    void readAll(int32_t* values) { _scale.readAll(values); }
+    uint32_t nowUs() const { return micros(); }
+    unsigned long nowMs() const { return millis(); }
+    void idle() { delay(1); }
+    void powerDown() { _scale.power_down(); }
+    void powerUp() { _scale.power_up(); }
+
+    // ===== DRDY Interrupt =====
+    void attachDataReady(void (*handler)()) {
+        // One edge per channel; the frame is read on the last one
+        for (uint8_t ch = 0; ch < getChannelCount(); ch++) {
+            attachInterrupt(digitalPinToInterrupt(_doutPins[ch]), handler, FALLING);
+        }
+    }
+
+    void detachDataReady() {
+        for (uint8_t ch = 0; ch < getChannelCount(); ch++) {
+            detachInterrupt(digitalPinToInterrupt(_doutPins[ch]));
+        }
+    }
+
+    __attribute__((always_inline)) void readAllFromISR(int32_t* values) {
+        _scale.readAllFromISR(values);
+    }
+
+private:
+    HX711Direct _scale;
+    uint8_t _doutPins[HX711_MAX_CHANNELS];
+    float _sampleRateHz;
+    int8_t _ratePin;
+};
+
+#endif // HX711_ADC_H
@@ -0,0 +1,178 @@
+#include "HX711Direct.h"
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
+
+// Shared by all instances; held for one SCK high phase at a time
+static portMUX_TYPE hx711Mux = portMUX_INITIALIZER_UNLOCKED;
+
+static inline void IRAM_ATTR waitCycles(uint32_t start, uint32_t cycles) {
+    while (ESP.getCycleCount() - start < cycles) {}
+}
+
+// ===== Constructor =====
+HX711Direct::HX711Direct() :
+    _sckMask(0),
+    _sckSetReg(GPIO_OUT_W1TS_REG),
+    _sckClearReg(GPIO_OUT_W1TC_REG),
+    _channels(0),
+    _doutShift(),
+    _doutMask(0),
+    _doutInReg(GPIO_IN_REG),
+    _gainPulses(1),
+    _cyclesPerUs(240),
+    _highCycles(60),
+    _lowCycles(60),
+    _reads(0),
+    _lastCycles(0),
+    _avgCycles(0),
+    _maxCycles(0),
+    _maxMaskedCycles(0)
+{
+}
+
+// ===== Initialization =====
+void HX711Direct::begin(uint8_t doutPin, uint8_t sckPin, uint8_t gain) {
+    begin(&doutPin, 1, sckPin, gain);
+}
+
+bool HX711Direct::begin(const uint8_t* doutPins, uint8_t count, uint8_t sckPin, uint8_t gain) {
+    if (count == 0 || count > HX711_MAX_CHANNELS) return false;
+    for (uint8_t i = 1; i < count; i++) {
+        if ((doutPins[i] < 32) != (doutPins[0] < 32)) return false;
+    }
+
+    pinMode(sckPin, OUTPUT);
+
+    // GPIO0-31 and GPIO32-39 live in separate register banks
+    if (sckPin < 32) {
+        _sckMask = 1UL << sckPin;
+        _sckSetReg = GPIO_OUT_W1TS_REG;
+        _sckClearReg = GPIO_OUT_W1TC_REG;
+    } else {
+        _sckMask = 1UL << (sckPin - 32);
+        _sckSetReg = GPIO_OUT1_W1TS_REG;
+        _sckClearReg = GPIO_OUT1_W1TC_REG;
+    }
+    _channels = count;
+    _doutMask = 0;
+    _doutInReg = doutPins[0] < 32 ? GPIO_IN_REG : GPIO_IN1_REG;
+    for (uint8_t i = 0; i < count; i++) {
+        pinMode(doutPins[i], INPUT);
+        _doutShift[i] = doutPins[i] % 32;
+        _doutMask |= 1UL << _doutShift[i];
+    }
+
+    // Pulse timing from the actual CPU clock (80/160/240 MHz)
+    _cyclesPerUs = getCpuFrequencyMhz();
+    _highCycles = (_cyclesPerUs * HX711_SCK_HIGH_NS + 999) / 1000;
+    _lowCycles = (_cyclesPerUs * HX711_SCK_LOW_NS + 999) / 1000;
+
+    REG_WRITE(_sckClearReg, _sckMask);
+    set_gain(gain);
+    return true;
+}
+
+void HX711Direct::set_gain(uint8_t gain) {
+    switch (gain) {
+        case 64:  _gainPulses = 3; break;
+        case 32:  _gainPulses = 2; break;
+        default:  _gainPulses = 1; break;   // 128
+    }
+}
+
+// ===== Reading =====
+bool IRAM_ATTR HX711Direct::is_ready() const {
+    return (REG_READ(_doutInReg) & _doutMask) == 0;
+}
+
+long HX711Direct::read() {
+    int32_t values[HX711_MAX_CHANNELS];
+    readAll(values);
+    return values[0];
+}
+
+void HX711Direct::readAll(int32_t* values) {
+    while (!is_ready()) {
+        delay(0);
+    }
+    transfer(values, true);
+}
+
+void IRAM_ATTR HX711Direct::readAllFromISR(int32_t* values) {
+    transfer(values, false);
+}
+
+void IRAM_ATTR HX711Direct::transfer(int32_t* values, bool maskPerBit) {
+    uint32_t start = ESP.getCycleCount();
+    uint32_t maxMasked = 0;
+    uint32_t raw[HX711_MAX_CHANNELS] = {0};
+    uint8_t pulses = 24 + _gainPulses;
+
+    for (uint8_t i = 0; i < pulses; i++) {
+        if (maskPerBit) portENTER_CRITICAL(&hx711Mux);
+        uint32_t high = ESP.getCycleCount();
+        REG_WRITE(_sckSetReg, _sckMask);
+        waitCycles(high, _highCycles);
+        uint32_t in = REG_READ(_doutInReg);     // Every channel at once
+        REG_WRITE(_sckClearReg, _sckMask);
+        uint32_t low = ESP.getCycleCount();
+        if (maskPerBit) portEXIT_CRITICAL(&hx711Mux);
+
+        if (low - high > maxMasked) {
+            maxMasked = low - high;
+        }
+        if (i < 24) {
+            for (uint8_t ch = 0; ch < _channels; ch++) {
+                raw[ch] = (raw[ch] << 1) | ((in >> _doutShift[ch]) & 1);
+            }
+        }
+        waitCycles(low, _lowCycles);
+    }
+
+    // Sign-extend the 24-bit two's complement values
+    for (uint8_t ch = 0; ch < _channels; ch++) {
+        values[ch] = (int32_t)(raw[ch] << 8) >> 8;
+    }
+
+    recordCost(ESP.getCycleCount() - start, maskPerBit ? maxMasked : 0);
+}
+
+// ===== Power Management =====
+void HX711Direct::power_down() {
+    REG_WRITE(_sckClearReg, _sckMask);
+    REG_WRITE(_sckSetReg, _sckMask);
+    delayMicroseconds(70);  // > 60 us with SCK high
+}
+
+void HX711Direct::power_up() {
+    REG_WRITE(_sckClearReg, _sckMask);
+}
+
+// ===== Read Cost =====
+void IRAM_ATTR HX711Direct::recordCost(uint32_t cycles, uint32_t maskedCycles) {
+    _lastCycles = cycles;
+    _avgCycles = _reads == 0 ? cycles : _avgCycles + ((int32_t)(cycles - _avgCycles) >> 4);
+    if (cycles > _maxCycles) {
+        _maxCycles = cycles;
+    }
+    if (maskedCycles > _maxMaskedCycles) {
+        _maxMaskedCycles = maskedCycles;
+    }
+    _reads++;
+}
+
+HX711ReadCost HX711Direct::getReadCost() const {
+    HX711ReadCost cost;
+    float perUs = (float)_cyclesPerUs;
+    cost.reads = _reads;
+    cost.lastUs = _lastCycles / perUs;
+    cost.avgUs = _avgCycles / perUs;
+    cost.maxUs = _maxCycles / perUs;
+    cost.maxMaskedUs = _maxMaskedCycles / perUs;
+    return cost;
+}
+
+void HX711Direct::resetReadCost() {
+    _maxCycles = 0;
+    _maxMaskedCycles = 0;
+}
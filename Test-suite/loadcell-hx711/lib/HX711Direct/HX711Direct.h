@@ -0,0 +1,83 @@
+#ifndef HX711_DIRECT_H
+#define HX711_DIRECT_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// HX711 Direct-Register Driver
+// ============================================================================
+// Replaces the parts of bogde/HX711 that LoadCellModule uses, with the same
+// method names. SCK and DOUT go through the GPIO set/clear/input registers
+// instead of digitalWrite()/digitalRead(). Each SCK phase is timed with the
+// CPU cycle counter, scaled to the CPU clock in begin().
+//
+// Interrupts are masked only while SCK is high, one bit at a time: the HX711
+// powers down if SCK stays high for 60 us. Between bits interrupts run
+// normally. Every transfer is timed so the read cost can be reported.
+//
+// Up to HX711_MAX_CHANNELS amplifiers can share one SCK. Their DOUT pins
+// must be in the same GPIO bank (all < 32 or all >= 32), so that one input
+// register read per clock samples every channel: N channels are read in
+// the time of one.
+
+#define HX711_MAX_CHANNELS 4
+
+#define HX711_SCK_HIGH_NS 250   // T3 >= 0.2 us; DOUT is valid 0.1 us after the rising edge
+#define HX711_SCK_LOW_NS 250    // T4 >= 0.2 us
+
+struct HX711ReadCost {
+    uint32_t reads;
+    float lastUs;               // Whole transfer (25-27 SCK pulses)
+    float avgUs;                // Smoothed over ~16 reads
+    float maxUs;
+    float maxMaskedUs;          // Longest interrupt-masked window (one pulse)
+};
+
+class HX711Direct {
+public:
+    HX711Direct();
+
+    void begin(uint8_t doutPin, uint8_t sckPin, uint8_t gain = 128);
+    // Shared SCK; false if the DOUT pins span both GPIO banks
+    bool begin(const uint8_t* doutPins, uint8_t count, uint8_t sckPin, uint8_t gain = 128);
+    void set_gain(uint8_t gain = 128);   // 128/64 = channel A, 32 = channel B
+
+    uint8_t getChannelCount() const { return _channels; }
+
+    bool is_ready() const;      // Every channel has a conversion ready
+    long read();                // Blocking; waits for DOUT low; channel 0
+    void readAll(int32_t* values);          // Blocking, one value per channel
+    void readAllFromISR(int32_t* values);   // All DOUT low, caller is an ISR: no masking
+
+    void power_down();
+    void power_up();
+
+    HX711ReadCost getReadCost() const;
+    void resetReadCost();
+
+private:
+    void transfer(int32_t* values, bool maskPerBit);
+    void recordCost(uint32_t cycles, uint32_t maskedCycles);
+
+    uint32_t _sckMask;
+    uint32_t _sckSetReg;
+    uint32_t _sckClearReg;
+    uint8_t _channels;
+    uint8_t _doutShift[HX711_MAX_CHANNELS];  // Bit of each DOUT in the input register
+    uint32_t _doutMask;         // All DOUT bits
+    uint32_t _doutInReg;
+    uint8_t _gainPulses;        // Extra pulses after the 24 data bits
+
+    uint32_t _cyclesPerUs;
+    uint32_t _highCycles;
+    uint32_t _lowCycles;
+
+    // Cost in CPU cycles (32-bit, so ISR updates are never torn)
+    volatile uint32_t _reads;
+    volatile uint32_t _lastCycles;
+    volatile uint32_t _avgCycles;
+    volatile uint32_t _maxCycles;
+    volatile uint32_t _maxMaskedCycles;
+};
+
+#endif // HX711_DIRECT_H
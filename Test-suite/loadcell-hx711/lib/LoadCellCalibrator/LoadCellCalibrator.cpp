@@ -0,0 +1,247 @@
+#include "LoadCellCalibrator.h"
+#include <string.h>
+
+// ===== Constructor =====
+LoadCellCalibrator::LoadCellCalibrator(LoadCellModule& loadCell) :
+    _loadCell(loadCell),
+    _eventCallback(nullptr),
+    _state(CAL_IDLE),
+    _stateStartMs(0),
+    _lastNowMs(0),
+    _settleMs(0),
+    _readings(0),
+    _count(0),
+    _sums(),
+    _channel(0),
+    _weightGrams(0.0f),
+    _rawZero(0),
+    _rawWeight(0),
+    _resultFactor(0.0f),
+    _inverted(false),
+    _pointCount(0)
+{
+}
+
+// ===== Commands =====
+bool LoadCellCalibrator::startTare(uint8_t readings, uint16_t settleMs) {
+    // A tare mid-calibration would mix with its zero reading
+    if (_state != CAL_IDLE && _state != CAL_TARING) return false;
+    if (readings == 0) return false;
+    startSampling(CAL_TARING, readings, settleMs);
+    return true;
+}
+
+bool LoadCellCalibrator::startCalibration(uint8_t channel) {
+    if (channel >= LOADCELL_CHANNELS) return false;
+    if (_state != CAL_IDLE) cancel();
+
+    _channel = channel;
+    _weightGrams = 0.0f;
+    _rawZero = 0;
+    _rawWeight = 0;
+    _resultFactor = 0.0f;
+    _inverted = false;
+    _pointCount = 0;
+    enter(CAL_ZERO_WAIT);
+    emit(CAL_EVENT_STARTED);
+    return true;
+}
+
+bool LoadCellCalibrator::confirmZero() {
+    if (_state != CAL_ZERO_WAIT) return false;
+    startSampling(CAL_ZERO_SAMPLING, CALIBRATION_READINGS, CALIBRATION_SETTLE_MS);
+    return true;
+}
+
+bool LoadCellCalibrator::setWeight(float grams) {
+    if (_state != CAL_WEIGHT_WAIT && _state != CAL_RESULT) return false;
+    if (!(grams > 0.0f)) return false;
+    _weightGrams = grams;
+    startSampling(CAL_WEIGHT_SAMPLING, CALIBRATION_READINGS, CALIBRATION_SETTLE_MS);
+    return true;
+}
+
+bool LoadCellCalibrator::apply() {
+    if (_state != CAL_RESULT) return false;
+
+    // The zero reading was taken moments ago on the empty stand: use it as
+    // the offset instead of re-taring with the weight still on
+    _loadCell.setCalibrationTable(_channel, _resultTable);
+    _loadCell.setTareOffset(_channel, _rawZero);
+    enter(CAL_IDLE);
+    emit(CAL_EVENT_APPLIED);
+    return true;
+}
+
+void LoadCellCalibrator::cancel() {
+    if (_state == CAL_IDLE) return;
+    enter(CAL_IDLE);
+    emit(CAL_EVENT_CANCELLED);
+}
+
+bool LoadCellCalibrator::post(CalibrationCommand command, float value) {
+    Command item;
+    item.command = command;
+    item.value = value;
+    return _commands.push(item);
+}
+
+void LoadCellCalibrator::execute(const Command& command) {
+    switch (command.command) {
+        case CAL_CMD_TARE:          startTare(); break;
+        case CAL_CMD_START:         startCalibration((uint8_t)command.value); break;
+        case CAL_CMD_CONFIRM_ZERO:  confirmZero(); break;
+        case CAL_CMD_WEIGHT:        setWeight(command.value); break;
+        case CAL_CMD_APPLY:         apply(); break;
+        case CAL_CMD_CANCEL:        cancel(); break;
+    }
+}
+
+// ===== Sample Stream =====
+void LoadCellCalibrator::update(const ThrustData* data, unsigned long nowMs) {
+    _lastNowMs = nowMs;
+
+    Command command;
+    while (_commands.pop(command)) {
+        execute(command);
+    }
+
+    switch (_state) {
+        case CAL_TARING:
+        case CAL_ZERO_SAMPLING:
+        case CAL_WEIGHT_SAMPLING:
+            // Frames from before the request or still settling are skipped
+            if (!data || !data->valid) break;
+            if ((long)(data->timestamp - _stateStartMs) < (long)_settleMs) break;
+
+            for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+                _sums[ch] += data->channelRaw[ch];
+            }
+            if (++_count >= _readings) {
+                finishSampling();
+            }
+            break;
+
+        case CAL_ZERO_WAIT:
+        case CAL_WEIGHT_WAIT:
+        case CAL_RESULT:
+            if (nowMs - _stateStartMs > CALIBRATION_TIMEOUT_MS) {
+                enter(CAL_IDLE);
+                emit(CAL_EVENT_TIMEOUT);
+            }
+            break;
+
+        case CAL_IDLE:
+            break;
+    }
+}
+
+void LoadCellCalibrator::startSampling(CalibrationState state, uint8_t readings, uint16_t settleMs) {
+    _readings = readings;
+    _settleMs = settleMs;
+    _count = 0;
+    memset(_sums, 0, sizeof(_sums));
+    enter(state);
+}
+
+void LoadCellCalibrator::finishSampling() {
+    long averages[LOADCELL_CHANNELS];
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        averages[ch] = _sums[ch] / _readings;
+    }
+
+    switch (_state) {
+        case CAL_TARING:
+            for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+                _loadCell.setTareOffset(ch, averages[ch]);
+            }
+            enter(CAL_IDLE);
+            emit(CAL_EVENT_TARE_DONE);
+            break;
+
+        case CAL_ZERO_SAMPLING:
+            _rawZero = averages[_channel];
+            enter(CAL_WEIGHT_WAIT);
+            emit(CAL_EVENT_ZERO_DONE);
+            break;
+
+        case CAL_WEIGHT_SAMPLING: {
+            // Without earlier points a failed reading ends the session
+            CalibrationState fallback = _pointCount > 0 ? CAL_RESULT : CAL_IDLE;
+            _rawWeight = averages[_channel];
+            long rawDiff = _rawWeight - _rawZero;
+            if (rawDiff == 0) {
+                enter(fallback);
+                emit(CAL_EVENT_NO_CHANGE);
+                break;
+            }
+
+            // A weight measured again replaces its point
+            float forceN = _weightGrams * GRAMS_TO_NEWTONS;
+            CalibrationPoint points[CAL_TABLE_MAX_POINTS];
+            uint8_t count = 0;
+            for (uint8_t i = 0; i < _pointCount; i++) {
+                if (_points[i].forceN != forceN) points[count++] = _points[i];
+            }
+            if (count == CAL_TABLE_MAX_POINTS) {
+                enter(fallback);
+                emit(CAL_EVENT_REJECTED);
+                break;
+            }
+            points[count].counts = (int32_t)rawDiff;
+            points[count].forceN = forceN;
+            count++;
+
+            CalibrationTable table;
+            if (!table.setPoints(points, count)) {
+                enter(fallback);
+                emit(CAL_EVENT_REJECTED);
+                break;
+            }
+
+            memcpy(_points, points, sizeof(points[0]) * count);
+            _pointCount = count;
+            _resultTable = table;
+
+            // Inverted mounting (compression) gives a negative difference
+            _inverted = rawDiff < 0;
+            if (_inverted) rawDiff = -rawDiff;
+            _resultFactor = (float)rawDiff / forceN;
+            enter(CAL_RESULT);
+            emit(CAL_EVENT_RESULT);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void LoadCellCalibrator::enter(CalibrationState state) {
+    _state = state;
+    _stateStartMs = _lastNowMs;
+}
+
+void LoadCellCalibrator::emit(CalibrationEvent event) {
+    if (_eventCallback) {
+        _eventCallback(*this, event);
+    }
+}
+
+// ===== Status =====
+bool LoadCellCalibrator::isWaitingForInput() const {
+    return _state == CAL_ZERO_WAIT || _state == CAL_WEIGHT_WAIT || _state == CAL_RESULT;
+}
+
+const char* LoadCellCalibrator::getStateName() const {
+    switch (_state) {
+        case CAL_IDLE:            return "idle";
+        case CAL_TARING:          return "taring";
+        case CAL_ZERO_WAIT:       return "zero_wait";
+        case CAL_ZERO_SAMPLING:   return "zero_sampling";
+        case CAL_WEIGHT_WAIT:     return "weight_wait";
+        case CAL_WEIGHT_SAMPLING: return "weight_sampling";
+        case CAL_RESULT:          return "result";
+    }
+    return "unknown";
+}
@@ -0,0 +1,142 @@
+#ifndef LOADCELL_CALIBRATOR_H
+#define LOADCELL_CALIBRATOR_H
+
+#include <stdint.h>
+#include "LoadCellModule.h"
+#include "SpscQueue.h"
+#include "CalibrationTable.h"
+
+// ============================================================================
+// Load Cell Tare / Calibration State Machine
+// ============================================================================
+// Tare and two-point calibration as incremental steps fed by the normal
+// sample stream: update() takes every ThrustData that loop() reads, so
+// sampling, dashboard streaming and UART output never stop. Serial and web
+// drive the same instance:
+//   startTare()                     averages N frames -> tare offsets
+//   startCalibration(ch)            -> CAL_ZERO_WAIT    (remove all load)
+//   confirmZero()                   -> averages N frames of the empty stand
+//   setWeight(grams)                -> averages N frames with the weight
+//   setWeight(grams) ...            more points, up to CAL_TABLE_MAX_POINTS
+//   apply() / cancel()              one point: factor = (raw_weight - raw_zero) / N
+//                                   more: piecewise-linear CalibrationTable
+// The zero reading becomes the channel's tare offset on apply(), so the
+// weight can stay on the stand. Entering a weight already measured
+// replaces that point.
+//
+// Calls from loop() go straight to the methods. Other contexts (the web
+// server task) use post(); loop() picks those commands up in update().
+// Waiting states time out after CALIBRATION_TIMEOUT_MS.
+
+#define CALIBRATION_READINGS 20
+#define CALIBRATION_SETTLE_MS 500       // Ignored after load changes
+#define CALIBRATION_TIMEOUT_MS 120000
+#define CALIBRATION_QUEUE_SIZE 8
+
+enum CalibrationState : uint8_t {
+    CAL_IDLE,
+    CAL_TARING,
+    CAL_ZERO_WAIT,          // Waiting for confirmZero()
+    CAL_ZERO_SAMPLING,
+    CAL_WEIGHT_WAIT,        // Waiting for setWeight()
+    CAL_WEIGHT_SAMPLING,
+    CAL_RESULT              // Waiting for apply(), cancel() or another setWeight()
+};
+
+enum CalibrationEvent : uint8_t {
+    CAL_EVENT_STARTED,      // Calibration started, stand must be unloaded
+    CAL_EVENT_TARE_DONE,
+    CAL_EVENT_ZERO_DONE,    // Place the known weight and enter it
+    CAL_EVENT_RESULT,       // Point added (see getResultFactor(), getResultTable())
+    CAL_EVENT_NO_CHANGE,    // Weight reading equals zero reading; point dropped
+    CAL_EVENT_REJECTED,     // Point does not fit the others (force must rise with counts)
+    CAL_EVENT_APPLIED,
+    CAL_EVENT_CANCELLED,
+    CAL_EVENT_TIMEOUT
+};
+
+enum CalibrationCommand : uint8_t {
+    CAL_CMD_TARE,
+    CAL_CMD_START,          // value = channel
+    CAL_CMD_CONFIRM_ZERO,
+    CAL_CMD_WEIGHT,         // value = grams
+    CAL_CMD_APPLY,
+    CAL_CMD_CANCEL
+};
+
+class LoadCellCalibrator;
+typedef void (*CalibrationEventCallback)(const LoadCellCalibrator& calibrator, CalibrationEvent event);
+
+class LoadCellCalibrator {
+public:
+    explicit LoadCellCalibrator(LoadCellModule& loadCell);
+
+    void onEvent(CalibrationEventCallback callback) { _eventCallback = callback; }
+
+    // ===== Commands (loop() context) =====
+    // False if the command does not fit the current state
+    bool startTare(uint8_t readings = CALIBRATION_READINGS, uint16_t settleMs = 0);
+    bool startCalibration(uint8_t channel = 0);
+    bool confirmZero();
+    bool setWeight(float grams);
+    bool apply();
+    void cancel();
+
+    // Any other single context; run by the next update()
+    bool post(CalibrationCommand command, float value = 0.0f);
+
+    // Feed every sample read in loop(); nowMs drives settle and timeouts
+    void update(const ThrustData* data, unsigned long nowMs);
+
+    // ===== Status =====
+    CalibrationState getState() const { return _state; }
+    bool isBusy() const { return _state != CAL_IDLE; }
+    bool isWaitingForInput() const;
+    const char* getStateName() const;
+    uint8_t getChannel() const { return _channel; }
+    uint8_t getProgress() const { return _count; }      // Frames averaged so far
+    uint8_t getReadings() const { return _readings; }
+    float getWeightGrams() const { return _weightGrams; }
+    long getRawZero() const { return _rawZero; }
+    long getRawWeight() const { return _rawWeight; }
+    float getResultFactor() const { return _resultFactor; }      // Last point alone
+    bool isInverted() const { return _inverted; }       // Negative difference (compression)
+    uint8_t getPointCount() const { return _pointCount; }
+    const CalibrationTable& getResultTable() const { return _resultTable; }   // Every point
+
+private:
+    struct Command {
+        CalibrationCommand command;
+        float value;
+    };
+
+    void execute(const Command& command);
+    void startSampling(CalibrationState state, uint8_t readings, uint16_t settleMs);
+    void finishSampling();
+    void enter(CalibrationState state);
+    void emit(CalibrationEvent event);
+
+    LoadCellModule& _loadCell;
+    CalibrationEventCallback _eventCallback;
+    SpscQueue<Command, CALIBRATION_QUEUE_SIZE> _commands;
+
+    CalibrationState _state;
+    unsigned long _stateStartMs;
+    unsigned long _lastNowMs;
+    uint16_t _settleMs;
+    uint8_t _readings;
+    uint8_t _count;
+    long _sums[LOADCELL_CHANNELS];
+
+    uint8_t _channel;
+    float _weightGrams;
+    long _rawZero;
+    long _rawWeight;
+    float _resultFactor;
+    bool _inverted;
+    CalibrationPoint _points[CAL_TABLE_MAX_POINTS];
+    uint8_t _pointCount;
+    CalibrationTable _resultTable;
+};
+
+#endif // LOADCELL_CALIBRATOR_H
@@ -1,143 +1,545 @@
 #include "LoadCellModule.h"
 #include "loadcell_config.h"
 
+#if HX711_DRDY_INTERRUPT || ADS1220_DRDY_NOTIFY
+template <class Adc>
+LoadCellModuleT<Adc>* LoadCellModuleT<Adc>::_instance = nullptr;
+#endif
+
 // ===== Constructor =====
-LoadCellModule::LoadCellModule() :
-    _calibrationFactor(1.0f),
+template <class Adc>
+LoadCellModuleT<Adc>::LoadCellModuleT() :
     _initialized(false),
-    _tareOffset(0)
+    _status("Not Initialized"),
+    _tareOffset(),
+    _rateShift(),
+    _fastRate(false),
+    _settling(false),
+    _settleUntilUs(0),
+    _settleDrops(0),
+    _interruptActive(false),
+    _lastEdgeUs(0),
+    _stallRecoveries(0)
+#if HX711_ACQ_TASK
+    ,
+    _task(nullptr),
+    _dataQueue(nullptr),
+    _busyUs(0),
+    _maxLatencyUs(0),
+    _taskDrops(0),
+    _statsWindowUs(0),
+    _statsBusyUs(0)
+#endif
+#if ADS1220_DRDY_NOTIFY
+    ,
+    _drdyEdgeUs(0)
+#endif
 {
+#if HX711_ACQ_TASK
+    portMUX_INITIALIZE(&_stateMux);
+#endif
 }
 
 // ===== Initialization =====
-bool LoadCellModule::begin(uint8_t doutPin, uint8_t sckPin) {
-    _scale.begin(doutPin, sckPin);
-
-    // Wait for HX711 to be ready (timeout 3s)
-    unsigned long startTime = millis();
-    while (!_scale.is_ready()) {
-        if (millis() - startTime > 3000) {
-            Serial.println(F("ERROR: HX711 not responding!"));
+template <class Adc>
+bool LoadCellModuleT<Adc>::begin(const float* calibrationFactors) {
+    if (_adc.getChannelCount() != LOADCELL_CHANNELS) {
+        _status = "ADC channel count does not match LOADCELL_CHANNELS";
+        return false;
+    }
+
+    // Wait for every channel to be ready (timeout 3s)
+    unsigned long startTime = _adc.nowMs();
+    while (!_adc.isReady()) {
+        if (_adc.nowMs() - startTime > 3000) {
+            _status = "ADC not responding";
             return false;
         }
-        delay(10);
+        _adc.idle();
     }
 
+    if (calibrationFactors) {
+        for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+            setCalibrationFactor(ch, calibrationFactors[ch]);
+        }
+    }
     _initialized = true;
+    _status = "Ready";
+
+#if HX711_DRDY_INTERRUPT
+    startInterrupt();
+#endif
     return true;
 }
 
-bool LoadCellModule::begin(uint8_t doutPin, uint8_t sckPin, float calibrationFactor) {
-    if (!begin(doutPin, sckPin)) {
-        return false;
+// ===== Calibration =====
+template <class Adc>
+void LoadCellModuleT<Adc>::setCalibrationFactor(uint8_t channel, float factor) {
+    if (channel >= LOADCELL_CHANNELS) return;
+
+    // setLinear() maps 0 to 1.0, a safe default
+    CalibrationTable table;
+    table.setLinear(factor);
+    setCalibrationTable(channel, table);
+}
+
+template <class Adc>
+void LoadCellModuleT<Adc>::setCalibrationTable(uint8_t channel, const CalibrationTable& table) {
+    if (channel >= LOADCELL_CHANNELS) return;
+
+    // Built by the caller; only the copy (~240 bytes) holds the lock
+    lockState();
+    _table[channel] = table;
+    unlockState();
+}
+
+template <class Adc>
+float LoadCellModuleT<Adc>::getCalibrationFactor(uint8_t channel) const {
+    return channel < LOADCELL_CHANNELS ? _table[channel].getFactor() : 0.0f;
+}
+
+template <class Adc>
+void LoadCellModuleT<Adc>::tare(uint8_t readings) {
+    if (!_initialized || readings == 0) return;
+
+    // Calculate tare offsets as average of fresh readings, all channels
+    // from the same frames
+    long averages[LOADCELL_CHANNELS];
+    averageRaw(readings, averages);
+    lockState();
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        _tareOffset[ch] = averages[ch];
+    }
+    unlockState();
+}
+
+template <class Adc>
+void LoadCellModuleT<Adc>::setTareOffset(uint8_t channel, long rawOffset) {
+    if (channel >= LOADCELL_CHANNELS) return;
+    lockState();
+    _tareOffset[channel] = rawOffset;
+    unlockState();
+}
+
+template <class Adc>
+long LoadCellModuleT<Adc>::getTareOffset(uint8_t channel) const {
+    return channel < LOADCELL_CHANNELS ? _tareOffset[channel] : 0;
+}
+
+// ===== Dual Rate =====
+template <class Adc>
+bool LoadCellModuleT<Adc>::setSampleRate(float hz) {
+    if (!_initialized) return false;
+    float previous = _adc.getSampleRate();
+    if (!_adc.setSampleRate(hz)) return false;
+    float current = _adc.getSampleRate();
+    if (current == previous) return true;
+
+    // Frames already queued are from the old rate and go too
+    uint32_t settleUntilUs = _adc.nowUs() + _adc.getSettlingUs();
+    bool fast = current > previous;
+    lockState();
+    _settleUntilUs = settleUntilUs;
+    _settling = true;
+    if (fast != _fastRate) {
+        _fastRate = fast;
+        for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+            _tareOffset[ch] += fast ? _rateShift[ch] : -_rateShift[ch];
+        }
     }
-    setCalibrationFactor(calibrationFactor);
+    unlockState();
     return true;
 }
 
-// ===== Calibration =====
-void LoadCellModule::setCalibrationFactor(float factor) {
-    // Prevent division by zero - use 1.0 as safe default
-    if (factor == 0.0f) {
-        factor = 1.0f;
+template <class Adc>
+void LoadCellModuleT<Adc>::setRateShift(uint8_t channel, long counts) {
+    if (channel >= LOADCELL_CHANNELS) return;
+    lockState();
+    // The offset in use is the fast one while fast
+    if (_fastRate) {
+        _tareOffset[channel] += counts - _rateShift[channel];
     }
-    _calibrationFactor = factor;
+    _rateShift[channel] = counts;
+    unlockState();
 }
 
-float LoadCellModule::getCalibrationFactor() const {
-    return _calibrationFactor;
+template <class Adc>
+long LoadCellModuleT<Adc>::getRateShift(uint8_t channel) const {
+    return channel < LOADCELL_CHANNELS ? _rateShift[channel] : 0;
 }
 
-void LoadCellModule::tare(uint8_t readings) {
-    if (!_initialized || readings == 0) return;
+// True if the frame is from before the ADC settled at a new rate
+template <class Adc>
+bool LoadCellModuleT<Adc>::unsettled(uint32_t timestampUs) {
+    if (!_settling) return false;
+    if ((int32_t)(timestampUs - _settleUntilUs) < 0) {
+        _settleDrops++;
+        return true;
+    }
+    _settling = false;
+    return false;
+}
 
-    // Calculate tare offset as average of readings
-    long sum = 0;
-    for (uint8_t i = 0; i < readings; i++) {
-        while (!_scale.is_ready()) {
-            delay(1);
-        }
-        sum += _scale.read();
+template <class Adc>
+bool LoadCellModuleT<Adc>::convertSettled(const int32_t* raw, unsigned long timestampMs,
+                                          uint32_t timestampUs, ThrustData& data) {
+    lockState();
+    bool settled = !unsettled(timestampUs);
+    if (settled) {
+        data = convert(raw, timestampMs, timestampUs);
     }
-    _tareOffset = sum / readings;
+    unlockState();
+    return settled;
 }
 
 // ===== High-Speed Measurement =====
-bool LoadCellModule::isReady() {
-    return _initialized && _scale.is_ready();
+template <class Adc>
+bool LoadCellModuleT<Adc>::isReady() {
+    if (!_initialized) return false;
+#if HX711_ACQ_TASK
+    if (_task) {
+        return uxQueueMessagesWaiting(_dataQueue) > 0;
+    }
+#endif
+#if HX711_DRDY_INTERRUPT
+    if (_interruptActive) {
+        checkStall();
+        return !_samples.empty();
+    }
+#endif
+    return _adc.isReady();
 }
 
-ThrustData LoadCellModule::read() {
+template <class Adc>
+ThrustData LoadCellModuleT<Adc>::read() {
     ThrustData data;
-    data.timestamp = millis();
 
     if (!_initialized) {
-        data.forceNewtons = 0.0f;
-        data.rawValue = 0;
+        memset(&data, 0, sizeof(data));
+        data.timestamp = _adc.nowMs();
+        data.timestampUs = _adc.nowUs();
         data.valid = false;
         return data;
     }
 
-    // Blocking read
-    data.rawValue = _scale.read();
+    if (_interruptActive
+#if HX711_ACQ_TASK
+        || _task
+#endif
+    ) {
+        while (!readIfReady(data)) {
+            _adc.idle();
+        }
+        return data;
+    }
+
+    // Blocking read, past any settling after a rate switch
+    int32_t raw[LOADCELL_CHANNELS];
+    for (;;) {
+        unsigned long timestampMs = _adc.nowMs();
+        uint32_t timestampUs = _adc.nowUs();
+        _adc.readAll(raw);
+        if (convertSettled(raw, timestampMs, timestampUs, data)) return data;
+    }
+}
 
-    // Convert to Newtons: (raw - offset) / cal_factor
-    // Calibration factor is in raw_units/Newton
-    float rawCorrected = (float)(data.rawValue - _tareOffset);
-    // Safety check for division (should never happen, but defensive)
-    if (_calibrationFactor != 0.0f) {
-        data.forceNewtons = rawCorrected / _calibrationFactor;
-    } else {
-        data.forceNewtons = 0.0f;
+template <class Adc>
+bool LoadCellModuleT<Adc>::acquire(ThrustData& data) {
+#if HX711_DRDY_INTERRUPT
+    if (_interruptActive) {
+        checkStall();
+        RawSample sample;
+        for (;;) {
+            if (!_samples.pop(sample)) return false;
+            // millis() and micros() count the same timer on the ESP32, so the
+            // edge time in ms is now minus the age of the sample
+            unsigned long timestampMs = millis() - (micros() - sample.timestampUs) / 1000UL;
+            if (convertSettled(sample.raw, timestampMs, sample.timestampUs, data)) return true;
+        }
+    }
+#endif
+
+    if (!_adc.isReady()) return false;
+    unsigned long timestampMs = _adc.nowMs();
+    uint32_t timestampUs = _adc.nowUs();
+#if ADS1220_DRDY_NOTIFY
+    if (_task) {
+        // The last edge is that of the conversion about to be read
+        timestampUs = _drdyEdgeUs;
+        timestampMs -= (_adc.nowUs() - timestampUs) / 1000UL;
     }
-    data.valid = true;
+#endif
+    int32_t raw[LOADCELL_CHANNELS];
+    _adc.readAll(raw);
+    return convertSettled(raw, timestampMs, timestampUs, data);
+}
 
-    return data;
+template <class Adc>
+bool LoadCellModuleT<Adc>::readIfReady(ThrustData& data) {
+    if (!_initialized) return false;
+#if HX711_ACQ_TASK
+    if (_task) {
+        return xQueueReceive(_dataQueue, &data, 0) == pdTRUE;
+    }
+#endif
+    return acquire(data);
 }
 
-bool LoadCellModule::readIfReady(ThrustData& data) {
-    if (!isReady()) {
+template <class Adc>
+float LoadCellModuleT<Adc>::getForceNewtons() {
+    if (!_initialized) return 0.0f;
+    return read().forceNewtons;
+}
+
+template <class Adc>
+long LoadCellModuleT<Adc>::getRawValue(uint8_t channel) {
+    if (!_initialized || channel >= LOADCELL_CHANNELS) return 0;
+    return read().channelRaw[channel];
+}
+
+template <class Adc>
+long LoadCellModuleT<Adc>::getAverageRawValue(uint8_t readings, uint8_t channel) {
+    if (!_initialized || readings == 0 || channel >= LOADCELL_CHANNELS) return 0;
+
+    long averages[LOADCELL_CHANNELS];
+    averageRaw(readings, averages);
+    return averages[channel];
+}
+
+template <class Adc>
+void LoadCellModuleT<Adc>::averageRaw(uint8_t readings, long* averages) {
+    // Queued samples predate the request (e.g. before the load changed).
+    // A polled ADC has nothing queued (and a free-running one never runs dry)
+    if (_interruptActive
+#if HX711_ACQ_TASK
+        || _task
+#endif
+    ) {
+        ThrustData stale;
+        while (readIfReady(stale)) {}
+    }
+
+    long sums[LOADCELL_CHANNELS] = {0};
+    for (uint8_t i = 0; i < readings; i++) {
+        ThrustData data = read();
+        for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+            sums[ch] += data.channelRaw[ch];
+        }
+    }
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        averages[ch] = sums[ch] / readings;
+    }
+}
+
+#if HX711_ACQ_TASK
+// ===== Acquisition Task =====
+template <class Adc>
+bool LoadCellModuleT<Adc>::startTask() {
+    if (!_initialized || _task) return false;
+
+    _dataQueue = xQueueCreate(HX711_DATA_QUEUE_SIZE, sizeof(ThrustData));
+    if (!_dataQueue) return false;
+
+    TaskHandle_t task = nullptr;
+    if (xTaskCreatePinnedToCore(taskEntry, "hx711", HX711_ACQ_TASK_STACK, this,
+                                HX711_ACQ_TASK_PRIORITY, &task, HX711_ACQ_TASK_CORE) != pdPASS) {
         return false;
     }
-    data = read();
+    _task = task;
     return true;
 }
 
-float LoadCellModule::getForceNewtons() {
-    if (!_initialized || _calibrationFactor == 0.0f) return 0.0f;
+template <class Adc>
+void LoadCellModuleT<Adc>::taskEntry(void* param) {
+    static_cast<LoadCellModuleT*>(param)->taskLoop();
+}
+
+template <class Adc>
+void LoadCellModuleT<Adc>::taskLoop() {
+    _task = xTaskGetCurrentTaskHandle();
+    _statsWindowUs = micros();
 
-    long raw = _scale.read();
-    float rawCorrected = (float)(raw - _tareOffset);
-    return rawCorrected / _calibrationFactor;
+#if HX711_DRDY_INTERRUPT
+    // GPIO interrupts run on the core that attached them; move the DRDY
+    // handler here, away from WiFi and AsyncTCP
+    stopInterrupt();
+    startInterrupt();
+#elif ADS1220_DRDY_NOTIFY
+    // Polling once per tick would stamp late and miss conversions at
+    // 1000 SPS and above; take the edge on this core instead
+    _instance = this;
+    _drdyEdgeUs = micros();
+    _adc.attachDataReady(onDataReadyNotify);
+#endif
+
+    for (;;) {
+#if HX711_DRDY_INTERRUPT
+        // Woken by the DRDY handler; the timeout still lets checkStall() run
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HX711_DRDY_STALL_US / 1000));
+#elif ADS1220_DRDY_NOTIFY
+        // Woken by the DRDY edge; the timeout is only a safety net, as the
+        // ADS1220 pulses DRDY for every conversion
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HX711_DRDY_STALL_US / 1000));
+#else
+        if (!_adc.isReady()) {
+            vTaskDelay(1);
+            continue;
+        }
+#endif
+
+        uint32_t wakeUs = micros();
+        ThrustData data;
+        while (acquire(data)) {
+            // Edge (or ready check) to hand-off: how long sampling waited
+            uint32_t latencyUs = wakeUs - data.timestampUs;
+            if (latencyUs > _maxLatencyUs) {
+                _maxLatencyUs = latencyUs;
+            }
+            if (xQueueSend(_dataQueue, &data, 0) != pdTRUE) {
+                _taskDrops++;
+            }
+        }
+        _busyUs += micros() - wakeUs;
+    }
 }
 
-long LoadCellModule::getRawValue() {
-    if (!_initialized) return 0;
-    return _scale.read();
+template <class Adc>
+LoadCellTaskStats LoadCellModuleT<Adc>::getTaskStats() {
+    LoadCellTaskStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!_task) return stats;
+
+    // CPU share since the previous call
+    uint32_t now = micros();
+    uint32_t busy = _busyUs;
+    uint32_t elapsed = now - _statsWindowUs;
+    stats.core = HX711_ACQ_TASK_CORE;
+    stats.priority = HX711_ACQ_TASK_PRIORITY;
+    stats.cpuPercent = elapsed > 0 ? (busy - _statsBusyUs) * 100.0f / elapsed : 0.0f;
+    stats.stackFreeBytes = uxTaskGetStackHighWaterMark(_task);
+    stats.maxLatencyUs = _maxLatencyUs;
+    stats.queueDrops = _taskDrops;
+    stats.queued = uxQueueMessagesWaiting(_dataQueue);
+
+    _statsWindowUs = now;
+    _statsBusyUs = busy;
+    _maxLatencyUs = 0;
+    return stats;
 }
+#endif
 
-long LoadCellModule::getAverageRawValue(uint8_t readings) {
-    if (!_initialized || readings == 0) return 0;
-    return _scale.read_average(readings);
+#if HX711_DRDY_INTERRUPT
+// ===== DRDY Interrupt Acquisition =====
+template <class Adc>
+void LoadCellModuleT<Adc>::startInterrupt() {
+    _instance = this;
+    _lastEdgeUs = micros();
+    _adc.attachDataReady(onDataReady);
+    _interruptActive = true;
 }
 
-// ===== Status =====
-const char* LoadCellModule::getStatusString() {
-    if (!_initialized) {
-        return "Not Initialized";
+template <class Adc>
+void LoadCellModuleT<Adc>::stopInterrupt() {
+    if (!_interruptActive) return;
+    _adc.detachDataReady();
+    _interruptActive = false;
+}
+
+template <class Adc>
+void IRAM_ATTR LoadCellModuleT<Adc>::onDataReady() {
+    LoadCellModuleT* self = _instance;
+    if (!self) return;
+
+    uint32_t edgeUs = micros();
+
+    // Our own clock-out toggles DOUT and queues more edges; those arrive
+    // with DOUT already back high and are ignored. With several channels,
+    // only the edge that completes the set reads the frame
+    if (!self->_adc.isReady()) return;
+
+    RawSample sample;
+    sample.timestampUs = edgeUs;
+    self->_adc.readAllFromISR(sample.raw);
+    self->_lastEdgeUs = edgeUs;
+    self->_samples.push(sample);
+
+#if HX711_ACQ_TASK
+    TaskHandle_t task = self->_task;
+    if (task) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
     }
-    return "Ready";
+#endif
+}
+
+template <class Adc>
+void LoadCellModuleT<Adc>::checkStall() {
+    if (micros() - _lastEdgeUs < HX711_DRDY_STALL_US) return;
+    if (!_adc.isReady()) return;
+
+    // DOUT is low but no edge arrived: read from here so the next
+    // conversion produces a falling edge again
+    _adc.detachDataReady();
+    if (_adc.isReady()) {
+        RawSample sample;
+        sample.timestampUs = micros();
+        _adc.readAll(sample.raw);
+        _samples.push(sample);
+        _stallRecoveries++;
+    }
+    _lastEdgeUs = micros();
+    _adc.attachDataReady(onDataReady);
+}
+#endif
+
+#if ADS1220_DRDY_NOTIFY
+// ===== DRDY Edge Notification =====
+template <class Adc>
+void IRAM_ATTR LoadCellModuleT<Adc>::onDataReadyNotify() {
+    LoadCellModuleT* self = _instance;
+    if (!self) return;
+
+    self->_drdyEdgeUs = micros();
+    TaskHandle_t task = self->_task;
+    if (task) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+#endif
+
+// ===== Status =====
+template <class Adc>
+const char* LoadCellModuleT<Adc>::getStatusString() {
+    return _status;
 }
 
 // ===== Power Management =====
-void LoadCellModule::powerDown() {
+template <class Adc>
+void LoadCellModuleT<Adc>::powerDown() {
     if (_initialized) {
-        _scale.power_down();
+#if HX711_DRDY_INTERRUPT
+        stopInterrupt();
+#endif
+        _adc.powerDown();
     }
 }
 
-void LoadCellModule::powerUp() {
+template <class Adc>
+void LoadCellModuleT<Adc>::powerUp() {
     if (_initialized) {
-        _scale.power_up();
+        _adc.powerUp();
+#if HX711_DRDY_INTERRUPT
+        startInterrupt();
+#endif
     }
 }
+
+// Only the backend selected by LOADCELL_ADC is built
+template class LoadCellModuleT<LoadCellAdc>;
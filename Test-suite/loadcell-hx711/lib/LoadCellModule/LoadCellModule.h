@@ -1,41 +1,141 @@
 #ifndef LOADCELL_MODULE_H
 #define LOADCELL_MODULE_H
 
+#include <stdint.h>
+#include <string.h>
+#include "loadcell_config.h"
+#include "SpscQueue.h"
+#include "CalibrationTable.h"
+
+#ifdef ARDUINO
 #include <Arduino.h>
-#include <HX711.h>
+#endif
+
+// ===== ADC Backend =====
+// Chosen at compile time with LOADCELL_ADC (see loadcell_config.h)
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
+#include "HX711Adc.h"
+typedef HX711Adc LoadCellAdc;
+#elif LOADCELL_ADC == LOADCELL_ADC_ADS1220
+#include "ADS1220Adc.h"
+typedef ADS1220Adc LoadCellAdc;
+#elif LOADCELL_ADC == LOADCELL_ADC_SIM
+#include "SimulatedAdc.h"
+typedef SimulatedAdc LoadCellAdc;
+#else
+#error "Unknown LOADCELL_ADC"
+#endif
+
+static_assert(LOADCELL_CHANNELS >= 1 && LOADCELL_CHANNELS <= 4,
+              "LOADCELL_CHANNELS must be 1-4");
 
 // ===== Thrust Data Structure =====
+// One time-aligned frame: every channel is clocked out on the same SCK edges
 struct ThrustData {
-    float forceNewtons;      // Force in Newtons (+ tension, - compression)
-    long rawValue;           // Raw ADC value
+    float forceNewtons;      // Force in Newtons (+ tension, - compression); axial sum
+    long rawValue;           // Raw ADC value (channel 0)
     unsigned long timestamp; // Reading timestamp in ms
+    uint32_t timestampUs;    // Reading timestamp in us (micros(); DRDY edge when interrupt-driven)
     bool valid;              // Data validity flag
+    long channelRaw[LOADCELL_CHANNELS];
+    float channelForceN[LOADCELL_CHANNELS];  // Per-channel tare/calibration applied
+};
+
+// ===== Acquisition Task Report =====
+struct LoadCellTaskStats {
+    uint8_t core;
+    uint8_t priority;
+    float cpuPercent;           // Share of its core since the last report
+    uint32_t stackFreeBytes;    // Stack high-water mark (minimum ever free)
+    uint32_t maxLatencyUs;      // Worst DRDY-to-task delay since the last report
+    uint32_t queueDrops;        // Samples lost because loop() fell behind
+    uint32_t queued;            // Samples waiting for loop()
 };
 
 // ===== Load Cell Module Class =====
-// Optimized for high-speed thrust measurement
-class LoadCellModule {
+// Optimized for high-speed thrust measurement. Calibration, tare and the
+// ThrustData conversion are shared; the ADC is a policy class chosen at
+// compile time, so backend calls inline with no virtual dispatch.
+//
+// An ADC policy provides:
+//   uint8_t getChannelCount(), float getSampleRate()
+//   bool setSampleRate(float hz), uint32_t getSettlingUs()  (false/0 if fixed)
+//   bool isReady(), void readAll(int32_t* values)   (blocking)
+//   uint32_t nowUs(), unsigned long nowMs(), void idle()
+//   void powerDown(), void powerUp()
+// and, for HX711_DRDY_INTERRUPT, attachDataReady(handler),
+// detachDataReady() and readAllFromISR(values); for ADS1220_DRDY_NOTIFY,
+// attachDataReady(handler) and detachDataReady().
+//
+// Start the backend through adc() (its pins and rate differ), then call
+// begin() with the calibration factors.
+template <class Adc>
+class LoadCellModuleT {
 public:
-    LoadCellModule();
+    LoadCellModuleT();
+
+    Adc& adc() { return _adc; }
+
+    // Initialization: waits up to 3 s for the first conversion
+    bool begin(const float* calibrationFactors = nullptr);
 
-    // Initialization
-    bool begin(uint8_t doutPin, uint8_t sckPin);
-    bool begin(uint8_t doutPin, uint8_t sckPin, float calibrationFactor);
+    uint8_t getChannelCount() const { return LOADCELL_CHANNELS; }
+    float getSampleRate() const { return _adc.getSampleRate(); }
 
-    // Calibration
-    void setCalibrationFactor(float factor);
-    float getCalibrationFactor() const;
-    void tare(uint8_t readings = 20);
+    // Dual-rate ADCs: switch between a slow and a fast rate. Frames from
+    // before the ADC has settled at the new rate are dropped. Each channel's
+    // zero follows its rate shift (zero at the fast rate minus zero at the
+    // slow one), so one tare holds at both rates. False if the rate is fixed
+    bool setSampleRate(float hz);
+    void setRateShift(uint8_t channel, long counts);
+    long getRateShift(uint8_t channel = 0) const;
+    bool isSettling() const { return _settling; }
+    uint32_t getSettleDrops() const { return _settleDrops; }
+
+    // Calibration (per channel; tare zeroes every channel). A factor is a
+    // one-segment table; getCalibrationFactor() is the table's overall
+    // counts/N. Safe to call while the acquisition task converts
+    void setCalibrationFactor(float factor) { setCalibrationFactor(0, factor); }
+    void setCalibrationFactor(uint8_t channel, float factor);
+    float getCalibrationFactor(uint8_t channel = 0) const;
+    void setCalibrationTable(uint8_t channel, const CalibrationTable& table);
+    const CalibrationTable& getCalibrationTable(uint8_t channel = 0) const { return _table[channel]; }
+    void tare(uint8_t readings = 20);   // Blocking; see LoadCellCalibrator for the incremental one
+    void setTareOffset(uint8_t channel, long rawOffset);
+    long getTareOffset(uint8_t channel = 0) const;
 
     // High-speed measurement (non-blocking)
+    // With HX711_DRDY_INTERRUPT, samples are acquired by the DRDY interrupt
+    // and these drain the sample ring instead of touching the HX711
     bool isReady();
     ThrustData read();              // Blocking read
     bool readIfReady(ThrustData& data);  // Non-blocking read
 
+#if HX711_ACQ_TASK
+    // Run acquisition in its own task pinned to HX711_ACQ_TASK_CORE, above
+    // everything else on that core; readIfReady() then pops converted
+    // samples from a queue. Call after begin().
+    bool startTask();
+    bool isTaskRunning() const { return _task != nullptr; }
+    LoadCellTaskStats getTaskStats();   // Starts a new CPU/latency window
+#endif
+
+    // Interrupt acquisition health. Drops count the DRDY sample ring and,
+    // with the acquisition task, its queue to loop()
+    uint32_t getQueueDrops() const {
+#if HX711_ACQ_TASK
+        return _samples.getDrops() + _taskDrops;
+#else
+        return _samples.getDrops();
+#endif
+    }
+    uint32_t getQueueHighWater() const { return _samples.getHighWater(); }
+    uint32_t getStallRecoveries() const { return _stallRecoveries; }
+
     // Direct access methods
-    float getForceNewtons();        // Single blocking read in Newtons
-    long getRawValue();             // Single raw ADC read
-    long getAverageRawValue(uint8_t readings);  // For calibration only
+    float getForceNewtons();        // Single blocking read in Newtons (axial sum)
+    long getRawValue(uint8_t channel = 0);      // Single raw ADC read
+    long getAverageRawValue(uint8_t readings, uint8_t channel = 0);  // For calibration only
 
     // Status
     const char* getStatusString();
@@ -45,10 +145,112 @@ public:
     void powerUp();
 
 private:
-    HX711 _scale;
-    float _calibrationFactor;
+    struct RawSample {
+        int32_t raw[LOADCELL_CHANNELS];
+        uint32_t timestampUs;   // DRDY edge (last channel to become ready)
+    };
+
+    void averageRaw(uint8_t readings, long* averages);  // Fresh samples, every channel
+    bool acquire(ThrustData& data);     // Non-blocking, ADC or sample ring
+    bool unsettled(uint32_t timestampUs);
+    // False (and dropped) if the frame is from before the ADC settled
+    bool convertSettled(const int32_t* raw, unsigned long timestampMs, uint32_t timestampUs,
+                        ThrustData& data);
+
+    // The acquisition task converts on its own core while loop() changes the
+    // rate, tare, rate shift or calibration; both hold _stateMux, so a frame sees all of
+    // an update or none of it
+    void lockState() {
+#if HX711_ACQ_TASK
+        portENTER_CRITICAL(&_stateMux);
+#endif
+    }
+    void unlockState() {
+#if HX711_ACQ_TASK
+        portEXIT_CRITICAL(&_stateMux);
+#endif
+    }
+
+    // Shared by every backend and acquisition mode
+    inline ThrustData convert(const int32_t* raw, unsigned long timestampMs, uint32_t timestampUs) const {
+        ThrustData data;
+        data.timestamp = timestampMs;
+        data.timestampUs = timestampUs;
+        data.rawValue = raw[0];
+        data.forceNewtons = 0.0f;
+
+        for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+            data.channelRaw[ch] = raw[ch];
+
+            // Convert to Newtons through the channel's calibration table
+            data.channelForceN[ch] = _table[ch].evaluate(raw[ch] - _tareOffset[ch]);
+
+            // Axial thrust: sum of the cells in the thrust line
+            if (LOADCELL_AXIAL_MASK & (1U << ch)) {
+                data.forceNewtons += data.channelForceN[ch];
+            }
+        }
+        data.valid = true;
+
+        return data;
+    }
+
+#if HX711_DRDY_INTERRUPT
+    // DRDY interrupt acquisition
+    void startInterrupt();
+    void stopInterrupt();
+    void checkStall();
+    static void IRAM_ATTR onDataReady();
+#endif
+
+#if ADS1220_DRDY_NOTIFY
+    // DRDY edge for an SPI backend: stamp and wake the task, which reads
+    static void IRAM_ATTR onDataReadyNotify();
+#endif
+
+#if HX711_DRDY_INTERRUPT || ADS1220_DRDY_NOTIFY
+    static LoadCellModuleT* _instance;
+#endif
+
+#if HX711_ACQ_TASK
+    // Acquisition task
+    static void taskEntry(void* param);
+    void taskLoop();
+#endif
+
+    Adc _adc;
+    CalibrationTable _table[LOADCELL_CHANNELS];    // Written under _stateMux
     bool _initialized;
-    long _tareOffset;
+    const char* _status;
+    long _tareOffset[LOADCELL_CHANNELS];
+    long _rateShift[LOADCELL_CHANNELS];
+    bool _fastRate;             // Above the rate begin() started at
+    volatile bool _settling;
+    volatile uint32_t _settleUntilUs;
+    volatile uint32_t _settleDrops;
+
+    bool _interruptActive;
+    volatile uint32_t _lastEdgeUs;
+    uint32_t _stallRecoveries;
+    SpscQueue<RawSample, HX711_SAMPLE_QUEUE_SIZE> _samples;
+
+#if HX711_ACQ_TASK
+    portMUX_TYPE _stateMux;     // Settling state, tare offsets, rate shifts and tables
+    volatile TaskHandle_t _task;
+    QueueHandle_t _dataQueue;   // Converted ThrustData for loop()
+    volatile uint32_t _busyUs;  // Written by the task only
+    volatile uint32_t _maxLatencyUs;
+    volatile uint32_t _taskDrops;
+    uint32_t _statsWindowUs;
+    uint32_t _statsBusyUs;
+#endif
+#if ADS1220_DRDY_NOTIFY
+    volatile uint32_t _drdyEdgeUs;  // Latest DRDY edge, i.e. of the unread conversion
+#endif
 };
 
+// The configured backend (instantiated in LoadCellModule.cpp)
+typedef LoadCellModuleT<LoadCellAdc> LoadCellModule;
+extern template class LoadCellModuleT<LoadCellAdc>;
+
 #endif // LOADCELL_MODULE_H
@@ -0,0 +1,69 @@
+#include "OutputQos.h"
+
+// ===== Constructor =====
+OutputQos::OutputQos() :
+    _mode(OUTPUT_IDLE),
+    _holdUs(1000000UL),
+    _idleCsvHz(0.0f),
+    _csvDivider(1),
+    _csvCounter(0),
+    _csvDue(true),
+    _burnStartUs(0),
+    _lastActiveUs(0),
+    _burnCount(0),
+    _lastBurnS(0.0f)
+{
+}
+
+void OutputQos::configure(float sampleRateHz, float burnThresholdN, uint32_t holdMs, float idleCsvHz) {
+    _metrics.setMinBurnThreshold(burnThresholdN);
+    _holdUs = holdMs * 1000UL;
+    _idleCsvHz = idleCsvHz;
+    setSampleRate(sampleRateHz);
+    reset();
+}
+
+void OutputQos::setSampleRate(float sampleRateHz) {
+    uint32_t divider = 1;
+    if (_idleCsvHz > 0.0f && sampleRateHz > _idleCsvHz) {
+        divider = (uint32_t)(sampleRateHz / _idleCsvHz + 0.5f);
+    }
+    _csvDivider = divider > 0xFFFF ? 0xFFFF : (uint16_t)divider;
+    _csvCounter = 0;
+}
+
+void OutputQos::reset() {
+    _metrics.reset();
+    _mode = OUTPUT_IDLE;
+    _csvCounter = 0;
+    _csvDue = true;
+}
+
+// ===== Per Frame =====
+bool OutputQos::update(float forceN, unsigned long timestampMs, uint32_t timestampUs) {
+    OutputMode previous = _mode;
+    _metrics.update(forceN, timestampMs, timestampUs);
+
+    if (_metrics.isBurnActive()) {
+        _lastActiveUs = timestampUs;
+        if (_mode == OUTPUT_IDLE) {
+            _mode = OUTPUT_BURN;
+            _burnStartUs = timestampUs;
+            _burnCount++;
+        }
+    } else if (_mode == OUTPUT_BURN && timestampUs - _lastActiveUs >= _holdUs) {
+        _mode = OUTPUT_IDLE;
+        _lastBurnS = (_lastActiveUs - _burnStartUs) * 1e-6f;
+        _csvCounter = 0;
+        // Forget this burn's peak, or a smaller next burn stays under 5% of it
+        _metrics.reset();
+    }
+
+    if (_mode == OUTPUT_BURN) {
+        _csvDue = true;
+    } else {
+        _csvDue = _csvCounter == 0;
+        if (++_csvCounter >= _csvDivider) _csvCounter = 0;
+    }
+    return _mode != previous;
+}
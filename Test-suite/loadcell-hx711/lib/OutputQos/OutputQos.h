@@ -0,0 +1,65 @@
+#ifndef OUTPUT_QOS_H
+#define OUTPUT_QOS_H
+
+#include <stdint.h>
+#include "ThrustMetrics.h"
+
+// ============================================================================
+// Burn-Aware Output QoS
+// ============================================================================
+// Decides how much of the sample stream each output gets, from its own
+// ThrustMetrics fed with every sample (recording or not):
+//   - burn: ThrustMetrics::isBurnActive(), held for holdMs after the last
+//     sample above the threshold so tail-off noise does not flap the mode.
+//     Outputs send every sample and put off anything else
+//   - idle: the serial CSV is decimated to about idleCsvHz
+// The burn threshold is 5% of the peak since reset() or the end of the
+// last burn, but at least burnThresholdN, so load cell noise never counts
+// as a burn.
+// Arduino-free.
+
+enum OutputMode : uint8_t {
+    OUTPUT_IDLE,
+    OUTPUT_BURN
+};
+
+class OutputQos {
+public:
+    OutputQos();
+
+    // idleCsvHz 0 = the CSV keeps every sample while idle
+    void configure(float sampleRateHz, float burnThresholdN, uint32_t holdMs, float idleCsvHz);
+    // New ADC rate (dual-rate ADCs): only the idle CSV divider changes
+    void setSampleRate(float sampleRateHz);
+    // New zero (tare/calibration): forget the peak, back to idle
+    void reset();
+
+    // Every frame; true if the mode changed
+    bool update(float forceN, unsigned long timestampMs, uint32_t timestampUs);
+
+    bool isBurn() const { return _mode == OUTPUT_BURN; }
+    OutputMode getMode() const { return _mode; }
+    const char* getModeName() const { return _mode == OUTPUT_BURN ? "burn" : "idle"; }
+    // This frame goes to the serial CSV
+    bool isCsvDue() const { return _csvDue; }
+    uint16_t getIdleCsvDivider() const { return _csvDivider; }
+
+    uint32_t getBurnCount() const { return _burnCount; }
+    float getLastBurnS() const { return _lastBurnS; }    // Above threshold, without the hold
+    const ThrustMetrics& getMetrics() const { return _metrics; }
+
+private:
+    ThrustMetrics _metrics;
+    OutputMode _mode;
+    uint32_t _holdUs;
+    float _idleCsvHz;
+    uint16_t _csvDivider;
+    uint16_t _csvCounter;
+    bool _csvDue;
+    uint32_t _burnStartUs;
+    uint32_t _lastActiveUs;
+    uint32_t _burnCount;
+    float _lastBurnS;
+};
+
+#endif // OUTPUT_QOS_H
@@ -0,0 +1,102 @@
+#include "SampleRateMonitor.h"
+#include <math.h>
+#include <string.h>
+
+// ===== Constructor =====
+SampleRateMonitor::SampleRateMonitor() :
+    _periodUs(0.0f),
+    _binWidthUs(1),
+    _sinceUs(0),
+    _checkSince(false),
+    _hasLast(false),
+    _lastUs(0),
+    _windowStartUs(0),
+    _windowCount(0),
+    _windowSum(0),
+    _windowSumSq(0),
+    _totalUs(0),
+    _histogram()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void SampleRateMonitor::begin(float nominalHz) {
+    _periodUs = nominalHz > 0.0f ? 1000000.0f / nominalHz : 1000000.0f;
+    _binWidthUs = (uint32_t)(_periodUs / SAMPLE_RATE_HIST_PER_PERIOD + 0.5f);
+    if (_binWidthUs == 0) _binWidthUs = 1;
+    reset(0);
+    _checkSince = false;
+    _stats.nominalHz = nominalHz;
+}
+
+void SampleRateMonitor::reset(uint32_t sinceUs) {
+    float nominalHz = _stats.nominalHz;
+    memset(&_stats, 0, sizeof(_stats));
+    memset(_histogram, 0, sizeof(_histogram));
+    _stats.nominalHz = nominalHz;
+    _sinceUs = sinceUs;
+    _checkSince = true;
+    _hasLast = false;
+    _windowCount = 0;
+    _windowSum = 0;
+    _windowSumSq = 0;
+    _totalUs = 0;
+}
+
+// ===== Per Frame =====
+bool SampleRateMonitor::record(uint32_t timestampUs) {
+    if (!_hasLast) {
+        // Only the backlog right after reset() can be older; later frames
+        // are compared to the previous one, which survives micros() wrap
+        if (_checkSince && (int32_t)(timestampUs - _sinceUs) < 0) return false;
+        _stats.samples++;
+        _hasLast = true;
+        _lastUs = timestampUs;
+        _windowStartUs = timestampUs;
+        return false;
+    }
+
+    _stats.samples++;
+    uint32_t interval = timestampUs - _lastUs;
+    _lastUs = timestampUs;
+
+    uint32_t bin = interval / _binWidthUs;
+    if (bin > SAMPLE_RATE_HIST_BINS - 1) bin = SAMPLE_RATE_HIST_BINS - 1;
+    _histogram[bin]++;
+
+    // Round to whole periods: 2 periods = 1 conversion skipped
+    uint32_t periods = (uint32_t)(interval / _periodUs + 0.5f);
+    if (periods > 1) _stats.missed += periods - 1;
+
+    if (_stats.samples == 2 || interval < _stats.minIntervalUs) _stats.minIntervalUs = interval;
+    if (interval > _stats.maxIntervalUs) _stats.maxIntervalUs = interval;
+
+    _totalUs += interval;
+    _windowCount++;
+    _windowSum += interval;
+    _windowSumSq += (uint64_t)interval * interval;
+
+    if (timestampUs - _windowStartUs >= SAMPLE_RATE_WINDOW_US) {
+        publish(timestampUs);
+        return true;
+    }
+    return false;
+}
+
+void SampleRateMonitor::publish(uint32_t timestampUs) {
+    // Double: the variance is a small difference of two ~1e8 us^2 terms.
+    // Once per window, so the soft-float cost does not matter
+    double mean = (double)_windowSum / _windowCount;
+    double variance = (double)_windowSumSq / _windowCount - mean * mean;
+
+    _stats.meanIntervalUs = (float)mean;
+    _stats.rateHz = mean > 0.0 ? (float)(1000000.0 / mean) : 0.0f;
+    _stats.jitterUs = variance > 0.0 ? (float)sqrt(variance) : 0.0f;
+    _stats.averageRateHz = _totalUs ? (float)(_stats.samples - 1) * 1000000.0f / _totalUs : 0.0f;
+    _stats.windows++;
+
+    _windowStartUs = timestampUs;
+    _windowCount = 0;
+    _windowSum = 0;
+    _windowSumSq = 0;
+}
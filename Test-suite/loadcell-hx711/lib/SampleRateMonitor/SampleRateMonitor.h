@@ -0,0 +1,75 @@
+#ifndef SAMPLE_RATE_MONITOR_H
+#define SAMPLE_RATE_MONITOR_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Sample Rate / Jitter Monitor
+// ============================================================================
+// Fed with the timestamp of every frame, it verifies the rate the ADC
+// actually delivers against the nominal one:
+//   - effective rate and interval jitter (standard deviation) over the last
+//     SAMPLE_RATE_WINDOW_US, plus the average since reset()
+//   - a histogram of intervals in 1/8 nominal periods (0 to 2 periods, the
+//     last bin holds everything longer)
+//   - missed conversions: an interval of about k nominal periods (k >= 2)
+//     means k-1 data-ready edges went unread. An ADC running slower than
+//     nominal (e.g. HX711 RATE pin low) counts as missing conversions too;
+//     the rate check catches that case
+// One update is a handful of integer operations. Arduino-free.
+
+#define SAMPLE_RATE_WINDOW_US 1000000UL
+#define SAMPLE_RATE_HIST_BINS 17                // 16 x 1/8 period + overflow
+#define SAMPLE_RATE_HIST_PER_PERIOD 8
+
+struct SampleRateStats {
+    float nominalHz;
+    float rateHz;               // Last window
+    float averageRateHz;        // Since reset()
+    float meanIntervalUs;       // Last window
+    float jitterUs;             // Last window, standard deviation
+    uint32_t minIntervalUs;     // Since reset()
+    uint32_t maxIntervalUs;
+    uint32_t samples;           // Since reset()
+    uint32_t missed;            // Conversions never read
+    uint32_t windows;           // Windows published (0 = no rate yet)
+};
+
+class SampleRateMonitor {
+public:
+    SampleRateMonitor();
+
+    void begin(float nominalHz);
+    // Forget everything; frames stamped before sinceUs are ignored (e.g.
+    // still queued from before the reset)
+    void reset(uint32_t sinceUs);
+
+    // Every frame, in order; true when a window was just published
+    bool record(uint32_t timestampUs);
+
+    const SampleRateStats& getStats() const { return _stats; }
+    uint32_t getHistogram(uint8_t bin) const { return _histogram[bin]; }
+    float getBinWidthUs() const { return _periodUs / SAMPLE_RATE_HIST_PER_PERIOD; }
+
+private:
+    void publish(uint32_t timestampUs);
+
+    float _periodUs;
+    uint32_t _binWidthUs;
+    uint32_t _sinceUs;
+    bool _checkSince;
+    bool _hasLast;
+    uint32_t _lastUs;
+
+    // Current window
+    uint32_t _windowStartUs;
+    uint32_t _windowCount;
+    uint64_t _windowSum;
+    uint64_t _windowSumSq;
+
+    uint64_t _totalUs;          // Sum of every interval since reset()
+    uint32_t _histogram[SAMPLE_RATE_HIST_BINS];
+    SampleRateStats _stats;
+};
+
+#endif // SAMPLE_RATE_MONITOR_H
@@ -0,0 +1,199 @@
+#include "SimulatedAdc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// Built-in curve: fast rise, regressive plateau, tail-off (~70 N*s)
+static const float BUILT_IN_TIME[] =  {0.0f, 0.05f, 0.10f, 0.30f, 1.00f, 1.30f, 1.45f, 1.50f};
+static const float BUILT_IN_FORCE[] = {0.0f, 45.0f, 60.0f, 52.0f, 48.0f, 40.0f, 10.0f, 0.0f};
+
+// ===== Constructor =====
+SimulatedAdc::SimulatedAdc() :
+    _points(0),
+    _cursor(0),
+    _channels(1),
+    _noiseCounts(0.0f),
+    _rng(0x2545F491),
+    _sampleRateHz(0.0f),
+    _baseRateHz(0.0f),
+    _rateShiftCounts(0),
+    _settleUntilUs(0),
+    _periodUs(0),
+    _sampleUs(0),
+    _virtualUs(0),
+    _clock(nullptr)
+{
+    for (uint8_t ch = 0; ch < SIMULATED_ADC_MAX_CHANNELS; ch++) {
+        _countsPerNewton[ch] = 1000.0f;
+    }
+}
+
+// ===== Initialization =====
+bool SimulatedAdc::begin(const char* curvePath, float sampleRateHz, uint8_t channels) {
+    if (sampleRateHz <= 0 || channels == 0 || channels > SIMULATED_ADC_MAX_CHANNELS) return false;
+
+    if (curvePath && curvePath[0]) {
+        if (!loadCurve(curvePath)) return false;
+    } else {
+        loadBuiltInCurve();
+    }
+
+    _channels = channels;
+    _sampleRateHz = sampleRateHz;
+    _periodUs = (uint32_t)(1000000.0f / sampleRateHz + 0.5f);
+    if (_periodUs == 0) _periodUs = 1;
+    _baseRateHz = sampleRateHz;
+    _cursor = 0;
+    _virtualUs = 0;
+    _sampleUs = _clock ? _clock() : 0;
+    _settleUntilUs = _sampleUs;
+    return true;
+}
+
+bool SimulatedAdc::setSampleRate(float hz) {
+    if (hz <= 0) return false;
+    _sampleRateHz = hz;
+    _periodUs = (uint32_t)(1000000.0f / hz + 0.5f);
+    if (_periodUs == 0) _periodUs = 1;
+    _settleUntilUs = nowUs() + getSettlingUs();
+    return true;
+}
+
+void SimulatedAdc::setScale(const float* countsPerNewton) {
+    for (uint8_t ch = 0; ch < _channels; ch++) {
+        _countsPerNewton[ch] = countsPerNewton[ch];
+    }
+}
+
+bool SimulatedAdc::loadCurve(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    _points = 0;
+    char line[96];
+    while (fgets(line, sizeof(line), file) && _points < SIMULATED_ADC_MAX_POINTS) {
+        char* p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == ';' || *p == '#') continue;
+
+        // Header lines (e.g. the .eng motor line) do not start with a number
+        char* end;
+        float t = strtof(p, &end);
+        if (end == p) continue;
+        p = end;
+        while (isspace((unsigned char)*p) || *p == ',') p++;
+        float f = strtof(p, &end);
+        if (end == p) continue;
+
+        // .eng curves start after t=0 with an implicit zero point
+        if (_points == 0 && t > 0.0f) {
+            _time[0] = 0.0f;
+            _force[0] = 0.0f;
+            _points = 1;
+        }
+        if (_points > 0 && t <= _time[_points - 1]) continue;
+        _time[_points] = t;
+        _force[_points] = f;
+        _points++;
+    }
+    fclose(file);
+    return _points >= 2;
+}
+
+void SimulatedAdc::loadBuiltInCurve() {
+    _points = sizeof(BUILT_IN_TIME) / sizeof(BUILT_IN_TIME[0]);
+    memcpy(_time, BUILT_IN_TIME, sizeof(BUILT_IN_TIME));
+    memcpy(_force, BUILT_IN_FORCE, sizeof(BUILT_IN_FORCE));
+}
+
+// ===== ADC Policy =====
+bool SimulatedAdc::isReady() const {
+    if (!_clock) return _points > 0;
+    return (int32_t)(_clock() - _sampleUs) >= 0;
+}
+
+void SimulatedAdc::readAll(int32_t* values) {
+    while (!isReady()) {
+        idle();
+    }
+
+    // Position in the loop: lead-in, curve, lead-out
+    uint32_t loopUs = (uint32_t)((2 * SIMULATED_ADC_LEAD_S + getCurveDuration()) * 1e6f);
+    uint32_t phaseUs = loopUs ? _sampleUs % loopUs : 0;
+    float t = phaseUs * 1e-6f - SIMULATED_ADC_LEAD_S;
+    float force = forceAt(t) / _channels;
+
+    float zero = SIMULATED_ADC_ZERO_COUNTS;
+    if (_sampleRateHz != _baseRateHz) zero += _rateShiftCounts;
+    if ((int32_t)(_sampleUs - _settleUntilUs) < 0) zero += SIMULATED_ADC_SETTLE_ERROR_COUNTS;
+
+    for (uint8_t ch = 0; ch < _channels; ch++) {
+        float counts = zero + force * _countsPerNewton[ch] + noise();
+        values[ch] = (int32_t)(counts < 0 ? counts - 0.5f : counts + 0.5f);
+    }
+
+    _sampleUs += _periodUs;
+    if (!_clock) {
+        // Free-running: "now" is always the time of the next sample
+        _virtualUs = _sampleUs;
+    }
+}
+
+uint32_t SimulatedAdc::nowUs() const {
+    return _clock ? _clock() : _virtualUs;
+}
+
+void SimulatedAdc::idle() {
+    // Free-running never waits; paced playback just polls the clock
+}
+
+// ===== Curve =====
+float SimulatedAdc::forceAt(float t) {
+    if (_points < 2 || t < 0.0f || t >= _time[_points - 1]) {
+        _cursor = 0;
+        return 0.0f;
+    }
+
+    // Time moves forward, so the segment is found in O(1) amortized
+    if (t < _time[_cursor]) _cursor = 0;
+    while (_cursor + 1 < _points - 1 && t >= _time[_cursor + 1]) {
+        _cursor++;
+    }
+
+    float t0 = _time[_cursor];
+    float t1 = _time[_cursor + 1];
+    float f0 = _force[_cursor];
+    float f1 = _force[_cursor + 1];
+    return f0 + (f1 - f0) * (t - t0) / (t1 - t0);
+}
+
+float SimulatedAdc::noise() {
+    if (_noiseCounts <= 0.0f) return 0.0f;
+
+    // Sum of four uniforms (xorshift32): close to Gaussian, RMS = _noiseCounts
+    float sum = 0.0f;
+    for (uint8_t i = 0; i < 4; i++) {
+        _rng ^= _rng << 13;
+        _rng ^= _rng >> 17;
+        _rng ^= _rng << 5;
+        sum += (_rng >> 8) * (1.0f / 16777216.0f) - 0.5f;
+    }
+    return sum * _noiseCounts * 1.7320508f;
+}
+
+float SimulatedAdc::getCurveImpulse() const {
+    float impulse = 0.0f;
+    for (uint16_t i = 1; i < _points; i++) {
+        impulse += (_force[i] + _force[i - 1]) * 0.5f * (_time[i] - _time[i - 1]);
+    }
+    return impulse;
+}
+
+float SimulatedAdc::getCurvePeak() const {
+    float peak = 0.0f;
+    for (uint16_t i = 0; i < _points; i++) {
+        if (_force[i] > peak) peak = _force[i];
+    }
+    return peak;
+}
@@ -0,0 +1,103 @@
+#ifndef SIMULATED_ADC_H
+#define SIMULATED_ADC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// Simulated Load Cell ADC
+// ============================================================================
+// ADC backend for LoadCellModuleT that plays a thrust curve instead of
+// reading hardware. Each sample is the curve force at the sample time,
+// scaled to raw counts with a per-channel counts/N factor, plus a fixed
+// zero offset and Gaussian-ish noise, so tare and calibration behave as on
+// the stand.
+//
+// Curve file: one "time_s thrust_N" pair per line (space or comma
+// separated). ';' and '#' lines and non-numeric header lines are skipped,
+// so RASP .eng motor files load directly. Without a file a built-in
+// 1.5 s burn is used. Playback loops: SIMULATED_ADC_LEAD_S of zero thrust,
+// the curve, then the same again.
+//
+// Time is virtual unless setClock() is given a us clock:
+// - Free-running (host): a sample is always ready and each read advances
+//   time by one period, so the pipeline runs as fast as the CPU allows.
+// - Paced (ESP32, setClock(micros)): samples become ready at the sample
+//   rate in real time.
+//
+// Rate switches behave like a dual-rate HX711, so the switching logic can
+// be exercised on the host: conversions during the settling time
+// (SIMULATED_ADC_SETTLE_PERIODS of the new rate) are off by
+// SIMULATED_ADC_SETTLE_ERROR_COUNTS, and at any rate other than the one
+// given to begin() the zero moves by setRateShift() counts.
+//
+// Has no Arduino dependencies.
+
+#define SIMULATED_ADC_MAX_CHANNELS 4
+#define SIMULATED_ADC_MAX_POINTS 256
+#define SIMULATED_ADC_LEAD_S 1.0f       // Zero thrust before and after the curve
+#define SIMULATED_ADC_ZERO_COUNTS 84000 // Unloaded raw offset
+#define SIMULATED_ADC_SETTLE_PERIODS 4
+#define SIMULATED_ADC_SETTLE_ERROR_COUNTS 30000
+
+class SimulatedAdc {
+public:
+    SimulatedAdc();
+
+    // Curve from a file (nullptr = built-in). False if the file cannot be
+    // read or has fewer than two points
+    bool begin(const char* curvePath, float sampleRateHz, uint8_t channels = 1);
+
+    // Raw counts per Newton for each channel (after begin()); thrust is
+    // split evenly across channels
+    void setScale(const float* countsPerNewton);
+    void setNoise(float noiseCounts) { _noiseCounts = noiseCounts; }
+    void setClock(uint32_t (*nowUs)()) { _clock = nowUs; }
+    void setRateShift(int32_t counts) { _rateShiftCounts = counts; }
+
+    // ===== ADC Policy =====
+    uint8_t getChannelCount() const { return _channels; }
+    float getSampleRate() const { return _sampleRateHz; }
+    bool setSampleRate(float hz);
+    uint32_t getSettlingUs() const { return SIMULATED_ADC_SETTLE_PERIODS * _periodUs; }
+    bool isReady() const;
+    void readAll(int32_t* values);          // Blocking, one value per channel
+    uint32_t nowUs() const;
+    unsigned long nowMs() const { return nowUs() / 1000UL; }
+    void idle();
+    void powerDown() {}
+    void powerUp() {}
+
+    // Curve info
+    uint16_t getPointCount() const { return _points; }
+    float getCurveDuration() const { return _points ? _time[_points - 1] : 0.0f; }
+    float getCurveImpulse() const;          // N*s, trapezoidal over the curve
+    float getCurvePeak() const;
+
+private:
+    bool loadCurve(const char* path);
+    void loadBuiltInCurve();
+    float forceAt(float t);
+    float noise();
+
+    float _time[SIMULATED_ADC_MAX_POINTS];
+    float _force[SIMULATED_ADC_MAX_POINTS];
+    uint16_t _points;
+    uint16_t _cursor;           // Segment of the last lookup (time only moves forward)
+
+    uint8_t _channels;
+    float _countsPerNewton[SIMULATED_ADC_MAX_CHANNELS];
+    float _noiseCounts;
+    uint32_t _rng;
+
+    float _sampleRateHz;
+    float _baseRateHz;          // Rate given to begin()
+    int32_t _rateShiftCounts;
+    uint32_t _settleUntilUs;    // Samples before this are unsettled
+    uint32_t _periodUs;
+    uint32_t _sampleUs;         // Time of the next sample
+    uint32_t _virtualUs;
+    uint32_t (*_clock)();
+};
+
+#endif // SIMULATED_ADC_H
@@ -0,0 +1,198 @@
+#include "StandIdentifier.h"
+#include <math.h>
+#include <string.h>
+
+// ===== Constructor =====
+StandIdentifier::StandIdentifier() :
+    _state(STAND_ID_IDLE),
+    _sampleRateHz(0.0f),
+    _triggerN(1.0f),
+    _window(STAND_ID_MAX_SAMPLES),
+    _baseline(),
+    _baselineIndex(0),
+    _baselineCount(0),
+    _count(0)
+{
+    memset(&_result, 0, sizeof(_result));
+}
+
+void StandIdentifier::start(float sampleRateHz, float triggerN, uint32_t windowSamples) {
+    _sampleRateHz = sampleRateHz;
+    _triggerN = triggerN;
+    _window = windowSamples > STAND_ID_MAX_SAMPLES ? STAND_ID_MAX_SAMPLES : windowSamples;
+    if (_window < 4 * STAND_ID_BASELINE_SAMPLES) _window = 4 * STAND_ID_BASELINE_SAMPLES;
+    _baselineIndex = 0;
+    _baselineCount = 0;
+    _count = 0;
+    memset(&_result, 0, sizeof(_result));
+    _state = STAND_ID_WAITING;
+}
+
+// ===== Sample Stream =====
+bool StandIdentifier::update(float forceN) {
+    switch (_state) {
+        case STAND_ID_WAITING: {
+            if (_baselineCount == STAND_ID_BASELINE_SAMPLES) {
+                float sum = 0.0f;
+                for (uint8_t i = 0; i < STAND_ID_BASELINE_SAMPLES; i++) {
+                    sum += _baseline[i];
+                }
+                if (fabsf(forceN - sum / STAND_ID_BASELINE_SAMPLES) >= _triggerN) {
+                    // The quiet samples before the edge open the record
+                    for (uint8_t i = 0; i < STAND_ID_BASELINE_SAMPLES; i++) {
+                        _samples[_count++] = _baseline[(_baselineIndex + i) % STAND_ID_BASELINE_SAMPLES];
+                    }
+                    _samples[_count++] = forceN;
+                    _state = STAND_ID_RECORDING;
+                    return true;
+                }
+            }
+            _baseline[_baselineIndex] = forceN;
+            _baselineIndex = (_baselineIndex + 1) % STAND_ID_BASELINE_SAMPLES;
+            if (_baselineCount < STAND_ID_BASELINE_SAMPLES) _baselineCount++;
+            return false;
+        }
+
+        case STAND_ID_RECORDING:
+            _samples[_count++] = forceN;
+            if (_count < _window) return false;
+            _state = analyze(_samples, _count, _sampleRateHz, _result) ? STAND_ID_DONE : STAND_ID_FAILED;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// ===== Analysis =====
+// Vertex of the parabola through a peak and its neighbours, in samples
+static float peakOffset(const float* x, uint32_t k, uint32_t count) {
+    if (k == 0 || k + 1 >= count) return 0.0f;
+    float curvature = x[k - 1] - 2.0f * x[k] + x[k + 1];
+    if (curvature == 0.0f) return 0.0f;
+    float offset = 0.5f * (x[k - 1] - x[k + 1]) / curvature;
+    return offset > 0.5f ? 0.5f : (offset < -0.5f ? -0.5f : offset);
+}
+
+// Least-squares slope of y against 0..n-1
+static double slope(const double* y, uint8_t n) {
+    double meanK = (n - 1) / 2.0;
+    double meanY = 0.0;
+    for (uint8_t k = 0; k < n; k++) meanY += y[k];
+    meanY /= n;
+
+    double num = 0.0;
+    double den = 0.0;
+    for (uint8_t k = 0; k < n; k++) {
+        num += (k - meanK) * (y[k] - meanY);
+        den += (k - meanK) * (k - meanK);
+    }
+    return num / den;
+}
+
+bool StandIdentifier::analyze(const float* samples, uint32_t count, float sampleRateHz,
+                              StandDynamics& result) {
+    memset(&result, 0, sizeof(result));
+    result.error = STAND_ID_NO_RINGING;
+    if (count < 4 * STAND_ID_BASELINE_SAMPLES || sampleRateHz <= 0.0f) return false;
+
+    // Settled value and noise from the last quarter
+    uint32_t tail = count / 4;
+    double sum = 0.0;
+    for (uint32_t i = count - tail; i < count; i++) sum += samples[i];
+    float settled = (float)(sum / tail);
+    double sumSq = 0.0;
+    for (uint32_t i = count - tail; i < count; i++) {
+        double d = samples[i] - settled;
+        sumSq += d * d;
+    }
+    float noise = (float)sqrt(sumSq / tail);
+    result.settledN = settled;
+
+    // The largest excursion is the excitation itself
+    uint32_t start = 0;
+    float excursion = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        float a = fabsf(samples[i] - settled);
+        if (a > excursion) {
+            excursion = a;
+            start = i;
+        }
+    }
+    float band = 3.0f * noise;
+    if (band < 0.02f * excursion) band = 0.02f * excursion;
+
+    // Half-cycles after it: a sign change needs the residual past the band
+    double times[STAND_ID_MAX_PEAKS];
+    double logPeaks[STAND_ID_MAX_PEAKS];
+    uint8_t peaks = 0;
+    int8_t sign = samples[start] > settled ? 1 : -1;
+    bool excitation = true;
+    uint32_t peakIndex = start;
+    float peak = excursion;
+
+    for (uint32_t i = start + 1; i < count && peaks < STAND_ID_MAX_PEAKS; i++) {
+        float v = (samples[i] - settled) * sign;
+        if (v < -band) {
+            if (!excitation) {
+                if (peak < 2.0f * band) break;     // Into the noise
+                times[peaks] = peakIndex + peakOffset(samples, peakIndex, count);
+                logPeaks[peaks] = log(peak);
+                if (peaks == 0) result.firstPeakN = peak;
+                peaks++;
+            }
+            excitation = false;
+            sign = -sign;
+            v = -v;
+            peak = 0.0f;
+        }
+        if (v > peak) {
+            peak = v;
+            peakIndex = i;
+        }
+    }
+
+    result.peaks = peaks;
+    if (peaks < STAND_ID_MIN_PEAKS) return false;
+
+    double halfPeriod = slope(times, peaks);          // Samples
+    double decrement = -2.0 * slope(logPeaks, peaks); // Per full cycle
+    if (decrement <= 0.0) {
+        result.error = STAND_ID_NOT_DECAYING;
+        return false;
+    }
+    if (halfPeriod < 2.0) {
+        result.error = STAND_ID_TOO_FAST;
+        return false;
+    }
+
+    double zeta = decrement / sqrt(4.0 * M_PI * M_PI + decrement * decrement);
+    double dampedHz = sampleRateHz / (2.0 * halfPeriod);
+    result.dampedHz = (float)dampedHz;
+    result.dampingRatio = (float)zeta;
+    result.naturalHz = (float)(dampedHz / sqrt(1.0 - zeta * zeta));
+    result.error = STAND_ID_OK;
+    return true;
+}
+
+// ===== Status =====
+const char* StandIdentifier::getStateName() const {
+    switch (_state) {
+        case STAND_ID_IDLE:      return "idle";
+        case STAND_ID_WAITING:   return "waiting";
+        case STAND_ID_RECORDING: return "recording";
+        case STAND_ID_DONE:      return "done";
+        case STAND_ID_FAILED:    return "failed";
+    }
+    return "unknown";
+}
+
+const char* StandIdentifier::errorName(StandIdError error) {
+    switch (error) {
+        case STAND_ID_OK:           return "ok";
+        case STAND_ID_NO_RINGING:   return "no ringing above the noise";
+        case STAND_ID_NOT_DECAYING: return "ringing does not decay";
+        case STAND_ID_TOO_FAST:     return "rings too fast for the sample rate";
+    }
+    return "unknown";
+}
@@ -0,0 +1,95 @@
+#ifndef STAND_IDENTIFIER_H
+#define STAND_IDENTIFIER_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Stand Dynamics Identification
+// ============================================================================
+// A load cell on a stand is a mass-spring-damper: a sharp force edge comes
+// out late and ringing. This measures the ringing from a tap or a step load
+// so ForceFilterChain's comp stage can invert it.
+//
+// start() arms. Once |force| leaves the baseline (mean of the last
+// STAND_ID_BASELINE_SAMPLES) by triggerN, windowSamples are recorded and
+// analyze() runs on them:
+//   - settled value: mean of the last quarter; residual = force - settled
+//   - from the largest excursion on, the residual is cut into half-cycles
+//     at sign changes (with a noise band) and each half-cycle's peak is
+//     located to a fraction of a sample
+//   - least-squares lines through peak time and ln(peak) against the peak
+//     number give the damped half period and the log decrement, hence
+//     fn and zeta
+// At least STAND_ID_MIN_PEAKS clean peaks after the excitation are needed,
+// so the stand has to ring at well under half the sample rate: ~13 Hz at
+// 80 SPS, a few hundred Hz with the ADS1220 at 1000-2000 SPS.
+//
+// update() runs in loop(); analyze() also works on recorded logs.
+// Arduino-free.
+
+#define STAND_ID_MAX_SAMPLES 1024
+#define STAND_ID_BASELINE_SAMPLES 8
+#define STAND_ID_MIN_PEAKS 3
+#define STAND_ID_MAX_PEAKS 32
+
+enum StandIdState : uint8_t {
+    STAND_ID_IDLE,
+    STAND_ID_WAITING,           // Armed, waiting for the tap or step
+    STAND_ID_RECORDING,
+    STAND_ID_DONE,
+    STAND_ID_FAILED
+};
+
+enum StandIdError : uint8_t {
+    STAND_ID_OK,
+    STAND_ID_NO_RINGING,        // Fewer than STAND_ID_MIN_PEAKS peaks above the noise
+    STAND_ID_NOT_DECAYING,      // Peaks grow: not a free response
+    STAND_ID_TOO_FAST           // Rings near the Nyquist frequency
+};
+
+struct StandDynamics {
+    float naturalHz;            // Undamped natural frequency
+    float dampingRatio;
+    float dampedHz;             // Ringing frequency as seen
+    uint8_t peaks;              // Half-cycle peaks used
+    float firstPeakN;           // Residual amplitude of the first one
+    float settledN;
+    StandIdError error;
+};
+
+class StandIdentifier {
+public:
+    StandIdentifier();
+
+    // windowSamples is capped to STAND_ID_MAX_SAMPLES
+    void start(float sampleRateHz, float triggerN, uint32_t windowSamples);
+    void cancel() { _state = STAND_ID_IDLE; }
+
+    // Every frame; true when the state changed (DONE/FAILED after the window)
+    bool update(float forceN);
+
+    StandIdState getState() const { return _state; }
+    const char* getStateName() const;
+    bool isBusy() const { return _state == STAND_ID_WAITING || _state == STAND_ID_RECORDING; }
+    const StandDynamics& getResult() const { return _result; }
+
+    static bool analyze(const float* samples, uint32_t count, float sampleRateHz,
+                        StandDynamics& result);
+    static const char* errorName(StandIdError error);
+
+private:
+    StandIdState _state;
+    float _sampleRateHz;
+    float _triggerN;
+    uint32_t _window;
+
+    float _baseline[STAND_ID_BASELINE_SAMPLES];
+    uint8_t _baselineIndex;
+    uint8_t _baselineCount;
+
+    float _samples[STAND_ID_MAX_SAMPLES];
+    uint32_t _count;
+    StandDynamics _result;
+};
+
+#endif // STAND_IDENTIFIER_H
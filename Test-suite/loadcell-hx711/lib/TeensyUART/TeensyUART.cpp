@@ -1,14 +1,32 @@
 #include "TeensyUART.h"
 
 TeensyUART::TeensyUART()
-    : _messageId(0)
+    : _sequence(0)
+    , _unsentFrom(0)
+    , _lastDescriptorMs(0)
+    , _binaryStarted(false)
+    , _batchStartMs(0)
+    , _baudState(BAUD_BASE)
+    , _baud(TEENSY_UART_BAUD)
+    , _rateIndex(0)
+    , _baudDeadline(0)
+    , _nextNegotiation(0)
+    , _lastAckMs(0)
+    , _testsSent(false)
+    , _txHead(0)
+    , _txTail(0)
+    , _txUsed(0)
     , _rxIndex(0)
 {
+    memset(_history, 0, sizeof(_history));
+    memset(&_stats, 0, sizeof(_stats));
 }
 
 void TeensyUART::begin() {
     // Initialize Serial2 with custom pins (TX=GPIO17, RX=GPIO5)
     // This avoids GPIO16 which is used by HX711 DOUT
+    // A driver TX ring lets writes return at once; must be set before begin()
+    Serial2.setTxBufferSize(TEENSY_UART_TX_RING_SIZE);
     Serial2.begin(TEENSY_UART_BAUD, SERIAL_8N1, TEENSY_UART_RX_PIN, TEENSY_UART_TX_PIN);
 
     Serial.println(F("# Teensy UART initialized"));
@@ -18,49 +36,274 @@ void TeensyUART::begin() {
     Serial.println(TEENSY_UART_RX_PIN);
     Serial.print(F("#   Baud: "));
     Serial.println(TEENSY_UART_BAUD);
+    Serial.print(F("#   Format: "));
+    Serial.println(TEENSY_UART_BINARY ? F("binary (ThrustLink)") : F("ASCII"));
+    Serial.print(F("#   Retransmit history: "));
+    Serial.println(TEENSY_UART_HISTORY_SIZE);
+    Serial.print(F("#   Max negotiated baud: "));
+    Serial.println(TEENSY_UART_MAX_BAUD);
+    Serial.print(F("#   TX queue: "));
+    Serial.print(TEENSY_UART_TX_QUEUE_SIZE);
+    Serial.println(TEENSY_UART_TX_POLICY == TEENSY_UART_DROP_NEWEST ?
+                   F(" bytes, drop newest") : F(" bytes, drop oldest"));
+
+    // Let the Teensy finish booting before the first $BAUDREQ
+    _nextNegotiation = millis() + TEENSY_UART_LINK_TIMEOUT_MS;
+
+#if TEENSY_UART_BINARY
+    sendDescriptor();
+#endif
+}
+
+// ===== Transmit =====
+
+void TeensyUART::sendThrustData(float forceN, unsigned long timestampMs, uint32_t timestampUs) {
+    SentSample& sample = _history[_sequence % TEENSY_UART_HISTORY_SIZE];
+    sample.sequence = _sequence;
+    sample.forceN = forceN;
+    sample.timestampMs = timestampMs;
+    sample.timestampUs = timestampUs;
+    sample.lastSentMs = 0;
+    sample.used = true;
+    sample.sent = false;
+    _sequence++;
+
+    // Held in the history while a new rate is negotiated
+    if (!isLinkReady()) return;
+
+#if TEENSY_UART_BINARY
+    // Let a restarted Teensy learn the device name again
+    if (millis() - _lastDescriptorMs >= TEENSY_UART_DESCRIPTOR_INTERVAL_MS) {
+        sendDescriptor();
+    }
+#endif
+
+    sendHeld();
 }
 
-void TeensyUART::sendThrustData(float forceN, unsigned long timestampMs) {
+void TeensyUART::sendHeld() {
+    // Held longer than the history reaches; a batch can't skip the gap
+    if (_sequence - _unsentFrom > TEENSY_UART_HISTORY_SIZE) {
+        flushBatch();
+        _stats.heldLost += _sequence - _unsentFrom - TEENSY_UART_HISTORY_SIZE;
+        _unsentFrom = _sequence - TEENSY_UART_HISTORY_SIZE;
+    }
+
+    while (_unsentFrom != _sequence) {
+        // A backlog goes out only as fast as the queue drains, so it never
+        // makes the overflow policy drop frames; a lone new sample is queued
+        // as usual
+        if (_sequence - _unsentFrom > 1 &&
+            _txUsed + THRUSTLINK_MAX_ENCODED + 2 > TEENSY_UART_TX_QUEUE_SIZE) {
+            return;
+        }
+
+        SentSample& sample = _history[_unsentFrom % TEENSY_UART_HISTORY_SIZE];
+#if TEENSY_UART_BINARY && TEENSY_UART_BATCH_SAMPLES > 1
+        addToBatch(sample);
+#else
+        transmit(sample);
+#endif
+        if (sample.sent) {
+            _stats.retransmits++;
+        } else {
+            _stats.framesSent++;
+            sample.sent = true;
+        }
+        _unsentFrom++;
+    }
+}
+
+void TeensyUART::resendUnacked() {
+    // Everything after the last acknowledged sample, as far back as the
+    // history reaches
+    uint32_t from = _stats.acksReceived > 0 ? _stats.ackedSequence + 1 : 0;
+    if (_sequence - from > TEENSY_UART_HISTORY_SIZE) {
+        from = _sequence - TEENSY_UART_HISTORY_SIZE;
+    }
+    if (from < _unsentFrom) {
+        _unsentFrom = from;
+    }
+}
+
+ThrustLinkSample TeensyUART::toLinkSample(const SentSample& sample) {
+    ThrustLinkSample frame;
+    frame.device = TEENSY_UART_DEVICE_ID;
+    frame.sequence = sample.sequence;
+    frame.timestampUs = sample.timestampUs;
+    frame.valueMilli = (int32_t)lroundf(sample.forceN * 1000.0f);
+    return frame;
+}
+
+size_t TeensyUART::startBinary(uint8_t* encoded) {
+    if (_binaryStarted) return 0;
+
+    // Delimiter first so the receiver leaves ASCII mode immediately
+    encoded[0] = THRUSTLINK_DELIMITER;
+    _binaryStarted = true;
+    return 1;
+}
+
+void TeensyUART::addToBatch(SentSample& sample) {
+    ThrustLinkSample frame = toLinkSample(sample);
+
+    if (_batch.count() > 0 && !_batch.add(frame)) {
+        // Payload full before the sample limit (large deltas)
+        flushBatch();
+    }
+    if (_batch.count() == 0) {
+        _batch.begin(TEENSY_UART_DEVICE_ID, frame);
+        _batchStartMs = millis();
+    }
+    sample.lastSentMs = millis();
+
+    if (_batch.count() >= TEENSY_UART_BATCH_SAMPLES) {
+        flushBatch();
+    }
+}
+
+void TeensyUART::flushBatch() {
+    if (_batch.count() == 0) return;
+
+    uint8_t* encoded = (uint8_t*)_txBuffer;
+    size_t length = startBinary(encoded);
+    length += _batch.finish(&encoded[length]);
+    queueFrame(encoded, length);
+    _stats.batchesSent++;
+}
+
+void TeensyUART::transmit(SentSample& sample) {
+#if TEENSY_UART_BINARY
+    uint8_t* encoded = (uint8_t*)_txBuffer;
+    size_t length = startBinary(encoded);
+    length += thrustLinkEncodeSample(toLinkSample(sample), &encoded[length]);
+    queueFrame(encoded, length);
+#else
     // Build message body (excluding checksum)
     // Format: $<DEVICE>,<MSG_ID>,<TYPE>,<SENSOR>,<VALUE>,<UNIT>,<TIMESTAMP>
     char msgBody[100];
     snprintf(msgBody, sizeof(msgBody), "$%s,%04lu,DATA,%s,%.3f,%s,%lu",
              DEVICE_NAME,
-             (unsigned long)(_messageId % 10000),
+             (unsigned long)(sample.sequence % 10000),
              SENSOR_NAME,
-             (double)forceN,
+             (double)sample.forceN,
              SENSOR_UNIT,
-             timestampMs);
+             sample.timestampMs);
 
     // Calculate checksum of message body (excluding leading $)
     uint8_t checksum = calculateChecksum(msgBody + 1, strlen(msgBody) - 1);
 
     // Format complete message with checksum
-    snprintf(_txBuffer, sizeof(_txBuffer), "%s*%02X\n", msgBody, checksum);
+    int length = snprintf(_txBuffer, sizeof(_txBuffer), "%s*%02X\n", msgBody, checksum);
 
     // Send via UART
-    Serial2.print(_txBuffer);
+    queueFrame((const uint8_t*)_txBuffer, length);
+#endif
+    sample.lastSentMs = millis();
+}
+
+void TeensyUART::sendDescriptor() {
+    ThrustLinkDescriptor desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.device = TEENSY_UART_DEVICE_ID;
+    strncpy(desc.name, DEVICE_NAME, sizeof(desc.name) - 1);
+    strncpy(desc.sensor, SENSOR_NAME, sizeof(desc.sensor) - 1);
+    strncpy(desc.unit, SENSOR_UNIT, sizeof(desc.unit) - 1);
+
+    uint8_t* encoded = (uint8_t*)_txBuffer;
+    size_t length = startBinary(encoded);
+    length += thrustLinkEncodeDescriptor(desc, &encoded[length]);
+    queueFrame(encoded, length);
+    _lastDescriptorMs = millis();
+}
+
+// ===== Transmit Queue =====
+
+void TeensyUART::queueFrame(const uint8_t* data, size_t length) {
+    if (length == 0) return;
+
+    while (_txUsed + length + 1 > TEENSY_UART_TX_QUEUE_SIZE) {
+#if TEENSY_UART_TX_POLICY == TEENSY_UART_DROP_NEWEST
+        _stats.txDropped++;
+        return;
+#else
+        dropOldestFrame();
+#endif
+    }
+
+    _txQueue[_txHead] = (uint8_t)length;
+    _txHead = (_txHead + 1) % TEENSY_UART_TX_QUEUE_SIZE;
+    for (size_t i = 0; i < length; i++) {
+        _txQueue[_txHead] = data[i];
+        _txHead = (_txHead + 1) % TEENSY_UART_TX_QUEUE_SIZE;
+    }
+    _txUsed += length + 1;
+    if (_txUsed > _stats.txQueueHighWater) {
+        _stats.txQueueHighWater = _txUsed;
+    }
+
+    drainQueue();
+}
 
-    // Increment message ID (wraps at 10000)
-    _messageId++;
-    if (_messageId >= 10000) {
-        _messageId = 0;
+void TeensyUART::drainQueue() {
+    while (_txUsed > 0) {
+        size_t length = _txQueue[_txTail];
+        if ((size_t)Serial2.availableForWrite() < length) break;
+
+        // Whole frames only, in at most two pieces across the ring wrap
+        size_t start = (_txTail + 1) % TEENSY_UART_TX_QUEUE_SIZE;
+        size_t first = min(length, (size_t)TEENSY_UART_TX_QUEUE_SIZE - start);
+        Serial2.write(&_txQueue[start], first);
+        if (first < length) {
+            Serial2.write(_txQueue, length - first);
+        }
+
+        _txTail = (start + length) % TEENSY_UART_TX_QUEUE_SIZE;
+        _txUsed -= length + 1;
     }
+    _stats.txQueued = _txUsed;
 }
 
-bool TeensyUART::checkAck() {
+void TeensyUART::dropOldestFrame() {
+    size_t length = _txQueue[_txTail];
+    _txTail = (_txTail + 1 + length) % TEENSY_UART_TX_QUEUE_SIZE;
+    _txUsed -= length + 1;
+    _stats.txDropped++;
+}
+
+void TeensyUART::clearQueue() {
+    while (_txUsed > 0) {
+        dropOldestFrame();
+        _stats.txDropped--;
+        _stats.txDiscarded++;
+    }
+    _stats.txQueued = 0;
+}
+
+// ===== ACK Handling =====
+
+bool TeensyUART::poll() {
     bool gotAck = false;
 
+    if (_batch.count() > 0 && millis() - _batchStartMs >= TEENSY_UART_BATCH_MAX_MS) {
+        flushBatch();
+    }
+    drainQueue();
+
+    if (isLinkReady()) {
+        sendHeld();
+    }
+    runBaudNegotiation();
+
     while (Serial2.available()) {
         char c = Serial2.read();
 
         if (c == '\n' || c == '\r') {
             if (_rxIndex > 0) {
                 _rxBuffer[_rxIndex] = '\0';
-                // Check if it's an ACK message
-                if (strncmp(_rxBuffer, "ACK,", 4) == 0) {
-                    gotAck = true;
-                }
+                uint32_t acks = _stats.acksReceived;
+                handleLine(_rxBuffer);
+                gotAck |= _stats.acksReceived != acks;
                 _rxIndex = 0;
             }
         } else if (_rxIndex < sizeof(_rxBuffer) - 1) {
@@ -71,6 +314,246 @@ bool TeensyUART::checkAck() {
     return gotAck;
 }
 
+void TeensyUART::handleLine(char* line) {
+    // Legacy per-message ACK,NNNN,OK lines carry nothing to act on
+    if (line[0] != '$') return;
+
+    // Verify checksum: $<BODY>*CS
+    char* star = strrchr(line, '*');
+    if (!star || strlen(star + 1) != 2) {
+        _stats.ackErrors++;
+        return;
+    }
+    uint8_t expected = (uint8_t)strtoul(star + 1, NULL, 16);
+    if (calculateChecksum(line + 1, star - line - 1) != expected) {
+        _stats.ackErrors++;
+        return;
+    }
+    *star = '\0';
+
+    char* save = NULL;
+    char* tag = strtok_r(line + 1, ",", &save);
+    if (!tag) return;
+
+    // Baud negotiation: <TAG>,<RATE>[,<GOOD>]
+    if (strncmp(tag, "BAUD", 4) == 0) {
+        char* rate = strtok_r(NULL, ",", &save);
+        char* good = strtok_r(NULL, ",", &save);
+        if (!rate) {
+            _stats.ackErrors++;
+            return;
+        }
+        handleBaudReply(tag, strtoul(rate, NULL, 10), good ? strtoul(good, NULL, 10) : 0);
+        return;
+    }
+    if (strcmp(tag, "ACKW") != 0) return;
+
+    // Fields: ACKW,<DEVICE>,<CUM>,<MISSING>
+    char* device = strtok_r(NULL, ",", &save);
+    char* cumulative = strtok_r(NULL, ",", &save);
+    char* missing = strtok_r(NULL, ",", &save);
+    if (!device || !cumulative || !missing) {
+        _stats.ackErrors++;
+        return;
+    }
+    if (strcmp(device, DEVICE_NAME) != 0) return;
+
+    _stats.acksReceived++;
+    _lastAckMs = millis();
+    handleWindowAck((uint16_t)(strtoul(cumulative, NULL, 10) % 10000),
+                    (uint32_t)strtoul(missing, NULL, 16));
+}
+
+void TeensyUART::handleWindowAck(uint16_t cumulative, uint32_t missing) {
+    if (_sequence == 0) return;
+
+    // Map the 4-digit ID onto the most recent matching full sequence
+    uint32_t last = _sequence - 1;
+    uint32_t back = (last % 10000 + 10000 - cumulative) % 10000;
+    if (back > last) return;
+
+    uint32_t acked = last - back;
+    _stats.ackedSequence = acked;
+
+    // Bit j set: acked + 1 + j never arrived
+    unsigned long now = millis();
+    uint8_t resent = 0;
+    for (uint8_t j = 0; j < 32 && missing != 0; j++, missing >>= 1) {
+        if (!(missing & 1)) continue;
+
+        uint32_t seq = acked + 1 + j;
+        // Not sent yet; sendHeld() gets to it
+        if (seq >= _unsentFrom) break;
+
+        SentSample& sample = _history[seq % TEENSY_UART_HISTORY_SIZE];
+        if (!sample.used || sample.sequence != seq) {
+            _stats.unrecoverable++;
+            continue;
+        }
+
+        // Resent frames would be garbled by a pending rate change
+        if (!isLinkReady()) break;
+
+        // A retransmit may still be in flight from the previous ACK
+        if (now - sample.lastSentMs < TEENSY_UART_RETX_HOLDOFF_MS) continue;
+        if (resent >= TEENSY_UART_RETX_MAX) break;
+
+        transmit(sample);
+        _stats.retransmits++;
+        resent++;
+    }
+}
+
+// ===== Baud Negotiation =====
+
+void TeensyUART::runBaudNegotiation() {
+    unsigned long now = millis();
+
+    switch (_baudState) {
+        case BAUD_BASE: {
+            if (TEENSY_UART_MAX_BAUD <= TEENSY_UART_BAUD) return;
+            if ((long)(now - _nextNegotiation) < 0) return;
+
+            // Send what the last attempt held first, so the history only has
+            // to cover one attempt; stop waiting if the base rate can't keep up
+            if ((_unsentFrom != _sequence || _txUsed > 0) &&
+                now - _nextNegotiation < TEENSY_UART_NEGOTIATION_HOLD_MS) {
+                return;
+            }
+
+            // Highest remaining candidate within the configured limit
+            while (_rateIndex < THRUSTLINK_BAUD_RATE_COUNT &&
+                   THRUSTLINK_BAUD_RATES[_rateIndex] > TEENSY_UART_MAX_BAUD) {
+                _rateIndex++;
+            }
+            if (_rateIndex >= THRUSTLINK_BAUD_RATE_COUNT) {
+                // Nothing passed: stay at base and start over later
+                _rateIndex = 0;
+                _nextNegotiation = now + TEENSY_UART_RENEGOTIATE_MS;
+                return;
+            }
+
+            flushBatch();
+            char body[32];
+            snprintf(body, sizeof(body), "BAUDREQ,%lu",
+                     (unsigned long)THRUSTLINK_BAUD_RATES[_rateIndex]);
+            sendControl(body);
+            _baudState = BAUD_REQUESTED;
+            _baudDeadline = now + THRUSTLINK_BAUD_STEP_TIMEOUT_MS;
+            break;
+        }
+
+        case BAUD_REQUESTED:
+            // The step runs from when the request has left the queue
+            if (_txUsed > 0) {
+                _baudDeadline = now + THRUSTLINK_BAUD_STEP_TIMEOUT_MS;
+            } else if ((long)(now - _baudDeadline) >= 0) {
+                // No answer: the Teensy firmware may not negotiate at all
+                _rateIndex = 0;
+                _baudState = BAUD_BASE;
+                _nextNegotiation = now + TEENSY_UART_RENEGOTIATE_MS;
+            }
+            break;
+
+        case BAUD_TESTING:
+            if (!_testsSent && (long)(now - _baudDeadline) >= 0) {
+                uint8_t frame[THRUSTLINK_MAX_ENCODED];
+                frame[0] = THRUSTLINK_DELIMITER;
+                queueFrame(frame, 1);
+                for (uint8_t i = 0; i < THRUSTLINK_BAUD_TEST_FRAMES; i++) {
+                    queueFrame(frame, thrustLinkEncodeTest(i, frame));
+                }
+                _testsSent = true;
+                _binaryStarted = true;
+                _baudDeadline = now + THRUSTLINK_BAUD_STEP_TIMEOUT_MS;
+            } else if (_testsSent && (long)(now - _baudDeadline) >= 0) {
+                abandonRate(0);
+            }
+            break;
+
+        case BAUD_COMMITTED:
+            if (now - _lastAckMs >= TEENSY_UART_LINK_TIMEOUT_MS) {
+                Serial.print(F("# Teensy UART: no ACKs at "));
+                Serial.print(_baud);
+                Serial.println(F(" baud, falling back"));
+                _stats.baudFallbacks++;
+                // Anything since the last ACK may have been lost at this
+                // rate, and setBaud() discards the queue
+                resendUnacked();
+                // Give the Teensy time to notice and drop back as well
+                abandonRate(3 * TEENSY_UART_LINK_TIMEOUT_MS);
+            }
+            break;
+    }
+}
+
+void TeensyUART::handleBaudReply(const char* tag, uint32_t rate, uint32_t good) {
+    if (_rateIndex >= THRUSTLINK_BAUD_RATE_COUNT || rate != THRUSTLINK_BAUD_RATES[_rateIndex]) {
+        return;
+    }
+
+    if (_baudState == BAUD_REQUESTED && strcmp(tag, "BAUDACK") == 0) {
+        // The Teensy switches right after this reply; send the test
+        // pattern once both ends have settled
+        setBaud(rate);
+        _baudState = BAUD_TESTING;
+        _testsSent = false;
+        _baudDeadline = millis() + THRUSTLINK_BAUD_SETTLE_MS;
+    } else if (_baudState == BAUD_REQUESTED && strcmp(tag, "BAUDNAK") == 0) {
+        _rateIndex++;
+        _baudState = BAUD_BASE;
+        _nextNegotiation = millis();
+    } else if (_baudState == BAUD_TESTING && strcmp(tag, "BAUDRES") == 0) {
+        if (good != THRUSTLINK_BAUD_TEST_FRAMES) {
+            abandonRate(0);
+            return;
+        }
+        char body[32];
+        snprintf(body, sizeof(body), "BAUDCOMMIT,%lu", (unsigned long)rate);
+        sendControl(body);
+        _baudState = BAUD_COMMITTED;
+        _lastAckMs = millis();
+        _stats.baudCommits++;
+        Serial.print(F("# Teensy UART: running at "));
+        Serial.print(rate);
+        Serial.println(F(" baud"));
+    }
+}
+
+void TeensyUART::abandonRate(unsigned long retryDelayMs) {
+    // Back to base and try the next lower rate
+    setBaud(TEENSY_UART_BAUD);
+    _baudState = BAUD_BASE;
+    _rateIndex++;
+    _nextNegotiation = millis() + retryDelayMs;
+}
+
+void TeensyUART::setBaud(uint32_t baud) {
+    // Frames still queued would go out at the wrong rate. Samples are only
+    // queued at a ready rate, and a fallback from one resends them
+    // (resendUnacked()); a partial batch is discarded with them, since the
+    // resend starts further back.
+    flushBatch();
+    clearQueue();
+    Serial2.flush();
+    Serial2.updateBaudRate(baud);
+    _baud = baud;
+
+    // The receiver may hold a partial frame from the old rate
+    _binaryStarted = false;
+}
+
+void TeensyUART::sendControl(const char* body) {
+    uint8_t checksum = calculateChecksum(body, strlen(body));
+    int length = snprintf(_txBuffer, sizeof(_txBuffer), "$%s*%02X\n", body, checksum);
+    // After binary frames the receiver collects bytes up to the next
+    // delimiter; close the line so it is read now, not with the next frame
+    if (_binaryStarted) {
+        _txBuffer[length++] = THRUSTLINK_DELIMITER;
+    }
+    queueFrame((const uint8_t*)_txBuffer, length);
+}
+
 uint8_t TeensyUART::calculateChecksum(const char* msg, size_t length) {
     uint8_t checksum = 0;
     for (size_t i = 0; i < length; i++) {
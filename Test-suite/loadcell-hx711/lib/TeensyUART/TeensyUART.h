@@ -3,6 +3,34 @@
 
 #include <Arduino.h>
 #include "teensy_uart_config.h"
+#include "ThrustLink.h"
+
+static_assert(TEENSY_UART_BAUD == THRUSTLINK_BASE_BAUD, "Negotiation starts at the ThrustLink base rate");
+static_assert(TEENSY_UART_TX_QUEUE_SIZE >= 2 * (THRUSTLINK_MAX_ENCODED + 2),
+              "TEENSY_UART_TX_QUEUE_SIZE must hold at least two frames");
+static_assert(THRUSTLINK_MAX_ENCODED + 1 <= 255, "TX queue stores frame lengths in one byte");
+static_assert(TEENSY_UART_BATCH_SAMPLES >= 1 && TEENSY_UART_BATCH_SAMPLES <= THRUSTLINK_BATCH_MAX_SAMPLES,
+              "TEENSY_UART_BATCH_SAMPLES out of range");
+static_assert(TEENSY_UART_MAX_BAUD <= TEENSY_UART_BAUD ||
+              TEENSY_UART_HISTORY_SIZE >= TEENSY_UART_MAX_SPS * TEENSY_UART_NEGOTIATION_HOLD_MS / 1000,
+              "TEENSY_UART_HISTORY_SIZE must hold the samples of one baud negotiation attempt");
+
+struct TeensyUartStats {
+    uint32_t framesSent;        // First transmissions (samples)
+    uint32_t batchesSent;       // Binary batch frames
+    uint32_t retransmits;       // Samples resent after a windowed ACK
+    uint32_t acksReceived;      // Valid $ACKW lines for this device
+    uint32_t ackErrors;         // Malformed or bad-checksum ACK lines
+    uint32_t unrecoverable;     // Holes already dropped from the history
+    uint32_t heldLost;          // Held samples overwritten before they were sent
+    uint32_t ackedSequence;     // Highest contiguous sequence acknowledged
+    uint32_t baudCommits;       // Higher rates agreed with the Teensy
+    uint32_t baudFallbacks;     // Returns to the base rate
+    uint32_t txDropped;         // Frames dropped by the overflow policy
+    uint32_t txDiscarded;       // Queued frames discarded on a baud change
+    uint16_t txQueued;          // Bytes waiting in the TX queue
+    uint16_t txQueueHighWater;  // Largest TX queue backlog (bytes)
+};
 
 class TeensyUART {
 public:
@@ -11,22 +39,96 @@ public:
     // Initialize Serial2 with remapped pins
     void begin();
 
-    // Send thrust data to Teensy
-    // Format: $thrust_test,XXXX,DATA,THST,XXX.XXX,N,XXXXX*XX\n
-    void sendThrustData(float forceN, unsigned long timestampMs);
+    // Send thrust data to Teensy and keep it for retransmission
+    // ASCII: $thrust_test,XXXX,DATA,THST,XXX.XXX,N,XXXXX*XX\n (timestampMs)
+    // Binary: ThrustLink SAMPLE frame (timestampUs, milli-Newtons)
+    void sendThrustData(float forceN, unsigned long timestampMs, uint32_t timestampUs);
+
+    // Non-blocking: flush a batch that reached its latency bound, read ACKs
+    // from the Teensy, retransmit the holes they report and run the baud
+    // negotiation. Call from loop(); returns true if a windowed ACK was
+    // handled.
+    bool poll();
 
-    // Non-blocking check for ACK from Teensy (optional)
-    bool checkAck();
+    // Current UART rate; samples are held while a new rate is being
+    // negotiated and sent once the link is ready
+    uint32_t getBaud() const { return _baud; }
+    bool isLinkReady() const { return _baudState == BAUD_BASE || _baudState == BAUD_COMMITTED; }
 
     // Get current message ID
-    uint16_t getMessageId() const { return _messageId; }
+    uint16_t getMessageId() const { return _sequence % 10000; }
+
+    const TeensyUartStats& getStats() const { return _stats; }
 
 private:
+    struct SentSample {
+        uint32_t sequence;      // Full 32-bit sequence (ID is sequence % 10000)
+        float forceN;
+        unsigned long timestampMs;
+        uint32_t timestampUs;
+        unsigned long lastSentMs;
+        bool used;
+        bool sent;              // Handed to the TX path at least once
+    };
+
+    void transmit(SentSample& sample);
+    void sendHeld();
+    void resendUnacked();
+    void sendDescriptor();
+    void addToBatch(SentSample& sample);
+    void flushBatch();
+    size_t startBinary(uint8_t* encoded);
+    static ThrustLinkSample toLinkSample(const SentSample& sample);
+    enum BaudState : uint8_t {
+        BAUD_BASE,          // At TEENSY_UART_BAUD, waiting to negotiate
+        BAUD_REQUESTED,     // $BAUDREQ sent
+        BAUD_TESTING,       // Switched, test pattern sent or pending
+        BAUD_COMMITTED      // Running at a negotiated rate
+    };
+
+    // Queue one complete frame; never blocks. Frames go out whole and in order.
+    void queueFrame(const uint8_t* data, size_t length);
+    void drainQueue();
+    void dropOldestFrame();
+    void clearQueue();
+
+    void handleLine(char* line);
+    void handleWindowAck(uint16_t cumulative, uint32_t missing);
+    void handleBaudReply(const char* tag, uint32_t rate, uint32_t good);
+    void runBaudNegotiation();
+    void sendControl(const char* body);
+    void setBaud(uint32_t baud);
+    void abandonRate(unsigned long retryDelayMs);
+
     // Calculate XOR checksum of message body
     uint8_t calculateChecksum(const char* msg, size_t length);
 
-    uint16_t _messageId;
-    char _txBuffer[128];
+    uint32_t _sequence;         // Next sequence to send
+    uint32_t _unsentFrom;       // Samples from here to _sequence are held
+    SentSample _history[TEENSY_UART_HISTORY_SIZE];
+    TeensyUartStats _stats;
+
+    unsigned long _lastDescriptorMs;
+    bool _binaryStarted;        // Leading delimiter sent
+    ThrustLinkBatchWriter _batch;
+    unsigned long _batchStartMs;
+
+    // Baud negotiation
+    BaudState _baudState;
+    uint32_t _baud;
+    uint8_t _rateIndex;         // Next candidate in THRUSTLINK_BAUD_RATES
+    unsigned long _baudDeadline;
+    unsigned long _nextNegotiation;
+    unsigned long _lastAckMs;
+    bool _testsSent;
+
+    // TX queue: byte ring of [length][frame bytes] entries
+    uint8_t _txQueue[TEENSY_UART_TX_QUEUE_SIZE];
+    size_t _txHead;             // Next byte to write
+    size_t _txTail;             // Start of the oldest frame
+    size_t _txUsed;
+
+    char _txBuffer[THRUSTLINK_MAX_ENCODED + 1];  // Also holds ASCII messages
     char _rxBuffer[64];
     uint8_t _rxIndex;
 };
@@ -0,0 +1,372 @@
+#include "ThrustAnalytics.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ===== Log Histogram =====
+LogHistogram::LogHistogram() :
+    _base(0),
+    _count(0),
+    _min(0.0f),
+    _max(0.0f),
+    _bins()
+{
+}
+
+// Positive floats order like their bit patterns
+uint32_t LogHistogram::key(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits >> (23 - ANALYTICS_HISTOGRAM_BITS);
+}
+
+float LogHistogram::lowerBound(uint32_t key) {
+    uint32_t bits = key << (23 - ANALYTICS_HISTOGRAM_BITS);
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+void LogHistogram::reset(float floor) {
+    _base = key(floor);
+    _count = 0;
+    memset(_bins, 0, sizeof(_bins));
+}
+
+void LogHistogram::add(float x) {
+    if (_count == 0 || x < _min) _min = x;
+    if (_count == 0 || x > _max) _max = x;
+    _count++;
+
+    uint32_t k = x > 0.0f ? key(x) : 0;
+    uint32_t bin = k > _base ? k - _base : 0;
+    if (bin >= ANALYTICS_HISTOGRAM_BINS) bin = ANALYTICS_HISTOGRAM_BINS - 1;
+    _bins[bin]++;
+}
+
+// The value of the rank-th smallest, taken to be evenly placed in its bin
+float LogHistogram::valueAt(uint32_t rank) const {
+    uint32_t below = 0;
+    for (uint32_t bin = 0; bin < ANALYTICS_HISTOGRAM_BINS; bin++) {
+        if (below + _bins[bin] > rank) {
+            float lower = lowerBound(_base + bin);
+            float upper = lowerBound(_base + bin + 1);
+            float x = lower + (rank - below + 0.5f) / _bins[bin] * (upper - lower);
+            if (x < _min) return _min;
+            if (x > _max) return _max;
+            return x;
+        }
+        below += _bins[bin];
+    }
+    return _max;
+}
+
+// Linear between order statistics
+float LogHistogram::quantile(float p) const {
+    if (_count == 0) return 0.0f;
+    float rank = p * (_count - 1);
+    uint32_t below = (uint32_t)rank;
+    float x = valueAt(below);
+    if (below + 1 < _count) {
+        x += (rank - below) * (valueAt(below + 1) - x);
+    }
+    return x;
+}
+
+// ===== Envelope Crossings =====
+void ThrustAnalytics::LastCrossing::update(float levelN, const EnvelopePoint& point) {
+    if (point.levelN >= levelN) {
+        above = point;
+        hasAfter = false;
+    } else if (!hasAfter) {
+        after = point;
+        hasAfter = true;
+    }
+}
+
+void ThrustAnalytics::LastCrossing::at(float levelN, float& timeS, float& impulseNs) const {
+    if (!hasAfter) {
+        timeS = above.timeS;
+        impulseNs = above.impulseNs;
+        return;
+    }
+    interpolate(above, after, levelN, timeS, impulseNs);
+}
+
+// Where the force, linear from one point to the next, passes levelN. The
+// impulse up to there is its share of the interval's trapezoid
+void ThrustAnalytics::interpolate(const EnvelopePoint& from, const EnvelopePoint& to, float levelN,
+                                  float& timeS, float& impulseNs) {
+    timeS = from.timeS;
+    impulseNs = from.impulseNs;
+    float span = to.levelN - from.levelN;
+    if (span == 0.0f) return;
+
+    float u = (levelN - from.levelN) / span;
+    if (u <= 0.0f) return;
+    if (u > 1.0f) u = 1.0f;
+    timeS += u * (to.timeS - from.timeS);
+
+    float area = from.levelN + to.levelN;
+    if (area > 0.0f) {
+        impulseNs += (to.impulseNs - from.impulseNs) * u * (2.0f * from.levelN + u * span) / area;
+    }
+}
+
+// ===== Constructor =====
+ThrustAnalytics::ThrustAnalytics() :
+    _startN(5.0f),
+    _endN(2.5f),
+    _holdUs(200000UL),
+    _maxGapUs(500000UL),
+    _state(ANALYTICS_IDLE),
+    _burnCount(0),
+    _hasPrevious(false),
+    _previousN(0.0f),
+    _previousUs(0),
+    _seedUs(0),
+    _startS(0.0f),
+    _startImpulseNs(0.0f),
+    _impulseNs(0.0f),
+    _peakN(0.0f),
+    _peakS(0.0f),
+    _lastAboveEndUs(0),
+    _samples(0),
+    _gaps(0),
+    _lastEnd(),
+    _lastHigh(),
+    _lastLow(),
+    _histogram(),
+    _envelope(),
+    _envelopeFirst(0),
+    _envelopeCount(0),
+    _envelopeEps(ANALYTICS_ENVELOPE_EPS),
+    _report()
+{
+    _report.impulseClass = impulseClass(0.0f);
+}
+
+void ThrustAnalytics::configure(float startN, float endN, uint32_t holdMs, uint32_t maxGapMs) {
+    _startN = startN;
+    _endN = endN < startN ? endN : startN;
+    _holdUs = holdMs * 1000UL;
+    _maxGapUs = maxGapMs * 1000UL;
+    reset();
+}
+
+void ThrustAnalytics::reset() {
+    _state = ANALYTICS_IDLE;
+    _hasPrevious = false;
+}
+
+// ===== Per Frame =====
+bool ThrustAnalytics::update(float forceN, uint32_t timestampUs) {
+    if (isnan(forceN)) return false;
+    float absForce = fabsf(forceN);
+
+    if (_state == ANALYTICS_IDLE) {
+        if (absForce >= _startN) {
+            startBurn(absForce, timestampUs);
+        } else {
+            _hasPrevious = true;
+            _previousN = absForce;
+            _previousUs = timestampUs;
+        }
+        return false;
+    }
+
+    sample(absForce, timestampUs);
+    if (timestampUs - _lastAboveEndUs >= _holdUs) {
+        finishBurn();
+        return true;
+    }
+    return false;
+}
+
+void ThrustAnalytics::startBurn(float absForce, uint32_t timestampUs) {
+    // The sample before, if it is close enough, is where the burn came from
+    bool seeded = _hasPrevious && timestampUs - _previousUs <= _maxGapUs && _previousN < absForce;
+    float seedN = _previousN;
+
+    _state = ANALYTICS_BURNING;
+    _impulseNs = 0.0f;
+    _samples = 0;
+    _gaps = 0;
+    _histogram.reset(_endN > 0.0f ? _endN : 0.01f);
+    _envelopeFirst = 0;
+    _envelopeCount = 0;
+    _envelopeEps = ANALYTICS_ENVELOPE_EPS;
+
+    if (seeded) {
+        _seedUs = _previousUs;
+        _peakN = seedN;
+        _peakS = 0.0f;
+        EnvelopePoint seed = { seedN, 0.0f, 0.0f };
+        _envelope[_envelopeCount++] = seed;
+    } else {
+        _seedUs = timestampUs;
+        _peakN = 0.0f;
+        _hasPrevious = true;
+        _previousN = absForce;
+        _previousUs = timestampUs;
+    }
+
+    // The start sample is the peak so far: above every tracked level
+    sample(absForce, timestampUs);
+
+    // startN crossing inside the first interval
+    _startS = 0.0f;
+    _startImpulseNs = 0.0f;
+    if (seeded) {
+        EnvelopePoint seed = { seedN, 0.0f, 0.0f };
+        EnvelopePoint start = { absForce, (timestampUs - _seedUs) * 1e-6f, _impulseNs };
+        interpolate(seed, start, _startN, _startS, _startImpulseNs);
+    }
+}
+
+void ThrustAnalytics::sample(float absForce, uint32_t timestampUs) {
+    uint32_t dtUs = timestampUs - _previousUs;
+    if (dtUs > _maxGapUs) {
+        _gaps++;
+    } else {
+        _impulseNs += 0.5f * (absForce + _previousN) * dtUs * 1e-6f;
+    }
+    _previousN = absForce;
+    _previousUs = timestampUs;
+    _samples++;
+
+    EnvelopePoint point = { absForce, (timestampUs - _seedUs) * 1e-6f, _impulseNs };
+    if (absForce > _peakN) {
+        _peakN = absForce;
+        _peakS = point.timeS;
+        addEnvelope(point);
+    }
+
+    _lastEnd.update(_endN, point);
+    _lastHigh.update(ANALYTICS_HIGH_FRACTION * _peakN, point);
+    _lastLow.update(ANALYTICS_LOW_FRACTION * _peakN, point);
+
+    if (absForce >= _endN) {
+        _lastAboveEndUs = timestampUs;
+        _histogram.add(absForce);
+    }
+}
+
+void ThrustAnalytics::finishBurn() {
+    _state = ANALYTICS_IDLE;
+
+    BurnReport& r = _report;
+    r.number = ++_burnCount;
+
+    float endS;
+    float endImpulse;
+    _lastEnd.at(_endN, endS, endImpulse);
+    r.burnTimeS = endS - _startS;
+    r.impulseNs = endImpulse - _startImpulseNs;
+    r.averageN = r.burnTimeS > 0.0f ? r.impulseNs / r.burnTimeS : 0.0f;
+    r.peakN = _peakN;
+    r.timeToPeakS = _peakS - _startS;
+
+    float low = ANALYTICS_LOW_FRACTION * _peakN;
+    float high = ANALYTICS_HIGH_FRACTION * _peakN;
+    float firstLowS, firstLowImpulse;
+    float firstHighS, firstHighImpulse;
+    float lastHighS, lastHighImpulse;
+    float lastLowS, lastLowImpulse;
+    firstCrossing(low, firstLowS, firstLowImpulse);
+    firstCrossing(high, firstHighS, firstHighImpulse);
+    _lastHigh.at(high, lastHighS, lastHighImpulse);
+    _lastLow.at(low, lastLowS, lastLowImpulse);
+
+    r.riseS = firstHighS - firstLowS;
+    r.tailOffS = lastLowS - lastHighS;
+    r.actionTimeS = lastLowS - firstLowS;
+    r.actionImpulseNs = lastLowImpulse - firstLowImpulse;
+    r.actionAverageN = r.actionTimeS > 0.0f ? r.actionImpulseNs / r.actionTimeS : 0.0f;
+
+    r.medianN = _histogram.quantile(0.5f);
+    r.p90N = _histogram.quantile(0.9f);
+    r.samples = _samples;
+    r.gaps = _gaps;
+    r.impulseClass = impulseClass(r.impulseNs);
+}
+
+// ===== Running-Max Envelope =====
+void ThrustAnalytics::addEnvelope(const EnvelopePoint& point) {
+    // Levels under 10% of the peak are never asked for again; one stays to
+    // interpolate from
+    float floorN = ANALYTICS_LOW_FRACTION * _peakN;
+    while (_envelopeFirst + 1 < _envelopeCount && _envelope[_envelopeFirst + 1].levelN < floorN) {
+        _envelopeFirst++;
+    }
+
+    // The newest entry is replaced until it is eps above the one before
+    if (_envelopeCount - _envelopeFirst >= 2 &&
+        _envelope[_envelopeCount - 2].levelN * (1.0f + _envelopeEps) > _envelope[_envelopeCount - 1].levelN) {
+        _envelope[_envelopeCount - 1] = point;
+        return;
+    }
+
+    if (_envelopeCount == ANALYTICS_ENVELOPE_POINTS) {
+        thinEnvelope();
+    }
+    _envelope[_envelopeCount++] = point;
+}
+
+void ThrustAnalytics::thinEnvelope() {
+    uint8_t count = _envelopeCount - _envelopeFirst;
+    memmove(_envelope, _envelope + _envelopeFirst, count * sizeof(EnvelopePoint));
+    _envelopeFirst = 0;
+    _envelopeCount = count;
+
+    // Coarser spacing until there is room; first and last always stay
+    while (_envelopeCount == ANALYTICS_ENVELOPE_POINTS) {
+        _envelopeEps *= 2.0f;
+        uint8_t kept = 1;
+        for (uint8_t i = 1; i < _envelopeCount - 1; i++) {
+            if (_envelope[i].levelN >= _envelope[kept - 1].levelN * (1.0f + _envelopeEps)) {
+                _envelope[kept++] = _envelope[i];
+            }
+        }
+        _envelope[kept++] = _envelope[_envelopeCount - 1];
+        _envelopeCount = kept;
+    }
+}
+
+// First time the running max reached levelN
+void ThrustAnalytics::firstCrossing(float levelN, float& timeS, float& impulseNs) const {
+    uint8_t k = _envelopeFirst;
+    while (k + 1 < _envelopeCount && _envelope[k].levelN < levelN) k++;
+
+    const EnvelopePoint& upper = _envelope[k];
+    timeS = upper.timeS;
+    impulseNs = upper.impulseNs;
+    if (k == _envelopeFirst || upper.levelN < levelN) return;
+
+    interpolate(_envelope[k - 1], upper, levelN, timeS, impulseNs);
+}
+
+// ===== Classification =====
+const char* ThrustAnalytics::impulseClass(float impulseNs) {
+    static const char* const classes[] = {
+        "1/8A", "1/4A", "1/2A", "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K",
+        "L", "M", "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z"
+    };
+    const uint8_t count = sizeof(classes) / sizeof(classes[0]);
+
+    // 1/8A is up to 0.3125 N*s; each class doubles
+    float limit = 0.3125f;
+    for (uint8_t i = 0; i < count - 1; i++) {
+        if (impulseNs <= limit) return classes[i];
+        limit *= 2.0f;
+    }
+    return classes[count - 1];
+}
+
+void ThrustAnalytics::getDesignation(char* buffer, uint8_t size) const {
+    if (_report.number == 0) {
+        snprintf(buffer, size, "-");
+        return;
+    }
+    snprintf(buffer, size, "%s%.0f", _report.impulseClass, _report.actionAverageN);
+}
@@ -0,0 +1,189 @@
+#ifndef THRUST_ANALYTICS_H
+#define THRUST_ANALYTICS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Streaming Thrust-Curve Analytics
+// ============================================================================
+// Characterizes each burn as the samples arrive, in constant memory and
+// O(1) per sample (amortized; the envelope table below is compacted at
+// most once per ANALYTICS_ENVELOPE_POINTS records), so it keeps up at the
+// ADS1220's 2000 SPS.
+//
+// Burn detection with hysteresis on |force|: a burn starts at the first
+// sample at or above startN and ends once |force| has stayed below endN
+// for holdMs. The sample before the start seeds the burn, so its first
+// interval is integrated. At the end the report is frozen:
+//   - burn time: startN crossing to the last endN crossing
+//   - peak and time to peak (from the startN crossing)
+//   - impulse (trapezoidal, over the burn time) and average thrust
+//   - rise: first 10% to first 90% of the peak
+//   - tail-off: last 90% to last 10% of the peak
+//   - action time: first 10% to last 10% of the peak, the impulse inside
+//     it and its average thrust (NAR-style; the designation uses it)
+//   - median and 90th percentile of |force| above endN (LogHistogram)
+//   - motor class from the impulse ("1/8A" ... "Z")
+// Crossings are interpolated between samples.
+//
+// The peak is only known at the end, so the first crossings of 10% and 90%
+// of it come from the running-max envelope: a table of (level, time,
+// impulse) each time |force| set a new maximum. Entries closer than eps in
+// relative level are merged and entries below 10% of the peak dropped; when
+// it fills anyway eps doubles and the table is thinned. The last crossings
+// need no table: the last samples at or above 10%/90% of the running peak
+// are the right ones for the final peak too.
+//
+// Intervals longer than maxGapMs (dropouts, logger restarts) are not
+// integrated. Arduino-free.
+
+#define ANALYTICS_ENVELOPE_POINTS 64
+#define ANALYTICS_ENVELOPE_EPS 0.005f      // Starting relative level spacing
+#define ANALYTICS_LOW_FRACTION 0.10f       // Rise/tail-off/action level
+#define ANALYTICS_HIGH_FRACTION 0.90f      // Rise/tail-off level
+
+// ===== Log Histogram =====
+// Percentiles in constant memory, whatever order the values come in (a
+// burn is mostly a monotone tail-off, which marker estimators such as P²
+// cannot follow). A bin is a float exponent and its top
+// ANALYTICS_HISTOGRAM_BITS mantissa bits: 32 bins per octave, so a
+// percentile is within 1.6%. Values under the floor count in the first bin,
+// values over ANALYTICS_HISTOGRAM_OCTAVES octaves above it in the last.
+#define ANALYTICS_HISTOGRAM_BITS 5
+#define ANALYTICS_HISTOGRAM_OCTAVES 16
+#define ANALYTICS_HISTOGRAM_BINS (ANALYTICS_HISTOGRAM_OCTAVES << ANALYTICS_HISTOGRAM_BITS)
+
+class LogHistogram {
+public:
+    LogHistogram();
+
+    void reset(float floor);    // > 0
+    void add(float x);
+    float quantile(float p) const;
+    uint32_t getCount() const { return _count; }
+
+private:
+    static uint32_t key(float x);
+    static float lowerBound(uint32_t key);
+    float valueAt(uint32_t rank) const;
+
+    uint32_t _base;
+    uint32_t _count;
+    float _min;
+    float _max;
+    uint32_t _bins[ANALYTICS_HISTOGRAM_BINS];
+};
+
+// ===== Burn Report =====
+struct BurnReport {
+    uint32_t number;            // 1 = first burn since boot
+    float burnTimeS;
+    float peakN;
+    float timeToPeakS;
+    float impulseNs;
+    float averageN;
+    float riseS;                // 10-90%
+    float tailOffS;             // 90-10%
+    float actionTimeS;
+    float actionImpulseNs;
+    float actionAverageN;
+    float medianN;              // Of |force| above endN
+    float p90N;
+    uint32_t samples;
+    uint32_t gaps;              // Intervals over maxGapMs, not integrated
+    const char* impulseClass;
+};
+
+enum AnalyticsState : uint8_t {
+    ANALYTICS_IDLE,
+    ANALYTICS_BURNING           // Until |force| has been below endN for holdMs
+};
+
+class ThrustAnalytics {
+public:
+    ThrustAnalytics();
+
+    void configure(float startN, float endN, uint32_t holdMs, uint32_t maxGapMs);
+    // New zero (tare/calibration): a burn in progress is dropped
+    void reset();
+
+    // Every frame; true when a burn has ended and getReport() has it
+    bool update(float forceN, uint32_t timestampUs);
+
+    AnalyticsState getState() const { return _state; }
+    const char* getStateName() const { return _state == ANALYTICS_BURNING ? "burning" : "idle"; }
+    bool isBurning() const { return _state == ANALYTICS_BURNING; }
+    uint32_t getBurnCount() const { return _burnCount; }
+    float getPeakN() const { return _peakN; }           // Current or last burn
+    const BurnReport& getReport() const { return _report; }  // number 0 = none yet
+
+    // Designation: class and action average thrust, e.g. "F32"
+    void getDesignation(char* buffer, uint8_t size) const;
+    static const char* impulseClass(float impulseNs);
+
+private:
+    struct EnvelopePoint {
+        float levelN;
+        float timeS;
+        float impulseNs;
+    };
+
+    // Last sample at or above a level and the one after it
+    struct LastCrossing {
+        EnvelopePoint above;
+        EnvelopePoint after;
+        bool hasAfter;
+
+        void update(float levelN, const EnvelopePoint& point);
+        void at(float levelN, float& timeS, float& impulseNs) const;
+    };
+
+    static void interpolate(const EnvelopePoint& from, const EnvelopePoint& to, float levelN,
+                            float& timeS, float& impulseNs);
+
+    void startBurn(float absForce, uint32_t timestampUs);
+    void sample(float absForce, uint32_t timestampUs);
+    void finishBurn();
+
+    void addEnvelope(const EnvelopePoint& point);
+    void thinEnvelope();
+    void firstCrossing(float levelN, float& timeS, float& impulseNs) const;
+
+    // Configuration
+    float _startN;
+    float _endN;
+    uint32_t _holdUs;
+    uint32_t _maxGapUs;
+
+    AnalyticsState _state;
+    uint32_t _burnCount;
+
+    // Previous sample (the seed when a burn starts)
+    bool _hasPrevious;
+    float _previousN;
+    uint32_t _previousUs;
+
+    // Burn in progress; times in s from the seed sample
+    uint32_t _seedUs;
+    float _startS;
+    float _startImpulseNs;
+    float _impulseNs;
+    float _peakN;
+    float _peakS;
+    uint32_t _lastAboveEndUs;
+    uint32_t _samples;
+    uint32_t _gaps;
+    LastCrossing _lastEnd;
+    LastCrossing _lastHigh;
+    LastCrossing _lastLow;
+    LogHistogram _histogram;
+
+    EnvelopePoint _envelope[ANALYTICS_ENVELOPE_POINTS];
+    uint8_t _envelopeFirst;     // Entries before it are below 10% of the peak
+    uint8_t _envelopeCount;
+    float _envelopeEps;
+
+    BurnReport _report;
+};
+
+#endif // THRUST_ANALYTICS_H
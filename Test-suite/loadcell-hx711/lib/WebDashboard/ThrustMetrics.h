@@ -1,16 +1,36 @@
 #ifndef THRUST_METRICS_H
 #define THRUST_METRICS_H
 
-#include <Arduino.h>
+#include <stdint.h>
+#include <math.h>
 
 // ============================================================================
 // Thrust Metrics Calculator
 // ============================================================================
-// Real-time computation of thrust curve metrics for rocket motor testing
-
-class ThrustMetrics {
+// Real-time computation of thrust curve metrics for rocket motor testing.
+// A burn is |force| at or above 5% of the peak, but never below the minimum
+// burn threshold (0.1 N unless set).
+//
+// Two implementations with the same interface; ThrustMetrics is the
+// fixed-point one unless THRUST_METRICS_FLOAT=1:
+//   ThrustMetricsFloat - float accumulators. Once the impulse or thrust sum
+//                        is large, each small increment loses its low bits
+//                        (tools/metrics_bench at 100 N: 0.04% off after
+//                        10 min at 1 kHz, 1.5% after an hour at 2 kHz)
+//   ThrustMetricsFixed - exact 64-bit sums, converted to float on read
+
+#ifndef THRUST_METRICS_FLOAT
+#define THRUST_METRICS_FLOAT 0
+#endif
+
+#define THRUST_METRICS_MAX_GAP_US 100000UL    // Longer intervals are not integrated
+
+// ===== Float Accumulators =====
+class ThrustMetricsFloat {
 public:
-    ThrustMetrics() { reset(); }
+    ThrustMetricsFloat() : _minBurnThreshold(0.1f) { reset(); }
+
+    void setMinBurnThreshold(float newtons) { _minBurnThreshold = newtons; }
 
     void reset() {
         _peakThrust = 0.0f;
@@ -20,13 +40,21 @@ public:
         _burnSampleCount = 0;
         _burnStartTime = 0;
         _burnEndTime = 0;
+        _burnStarted = false;
         _burnActive = false;
         _lastTimestamp = 0;
+        _lastTimestampUs = 0;
         _lastForce = 0.0f;
     }
 
-    // Update metrics with new data point
+    // Update metrics with new data point (ms resolution only)
     void update(float forceNewtons, unsigned long timestampMs) {
+        update(forceNewtons, timestampMs, (uint32_t)(timestampMs * 1000UL));
+    }
+
+    // Update metrics with the exact sample time in us (micros(), may wrap);
+    // impulse is integrated over the us intervals
+    void update(float forceNewtons, unsigned long timestampMs, uint32_t timestampUs) {
         // Skip invalid readings
         if (isnan(forceNewtons)) return;
 
@@ -39,7 +67,7 @@ public:
 
         // Integrate impulse using trapezoidal rule
         if (_sampleCount > 0 && _lastTimestamp > 0) {
-            float dt = (timestampMs - _lastTimestamp) / 1000.0f; // Convert to seconds
+            float dt = (uint32_t)(timestampUs - _lastTimestampUs) * 1e-6f; // Convert to seconds
             if (dt > 0 && dt < 0.1f) { // Sanity check (ignore gaps > 100ms)
                 float avgForce = (absForce + fabs(_lastForce)) / 2.0f;
                 _totalImpulse += avgForce * dt;
@@ -47,12 +75,14 @@ public:
         }
 
         // Burn detection (threshold = 5% of peak or minimum threshold)
-        float burnThreshold = max(_peakThrust * 0.05f, 0.1f);
+        float burnThreshold = fmaxf(_peakThrust * 0.05f, _minBurnThreshold);
 
-        if (absForce >= burnThreshold) {
-            if (!_burnActive) {
+        // Burn time runs from the first to the last sample above it
+        _burnActive = absForce >= burnThreshold;
+        if (_burnActive) {
+            if (!_burnStarted) {
                 _burnStartTime = timestampMs;
-                _burnActive = true;
+                _burnStarted = true;
             }
             _burnEndTime = timestampMs;
             _thrustSum += absForce;
@@ -60,6 +90,7 @@ public:
         }
 
         _lastTimestamp = timestampMs;
+        _lastTimestampUs = timestampUs;
         _lastForce = forceNewtons;
         _sampleCount++;
     }
@@ -69,7 +100,7 @@ public:
     float getTotalImpulse() const { return _totalImpulse; }
 
     float getBurnTime() const {
-        if (_burnStartTime == 0 || _burnEndTime <= _burnStartTime) return 0.0f;
+        if (!_burnStarted || _burnEndTime <= _burnStartTime) return 0.0f;
         return (_burnEndTime - _burnStartTime) / 1000.0f; // Return in seconds
     }
 
@@ -82,6 +113,7 @@ public:
     uint32_t getSampleCount() const { return _sampleCount; }
     uint32_t getBurnSampleCount() const { return _burnSampleCount; }
 
+    // The last sample was above the burn threshold
     bool isBurnActive() const { return _burnActive; }
 
 private:
@@ -92,9 +124,132 @@ private:
     uint32_t _burnSampleCount;
     unsigned long _burnStartTime;
     unsigned long _burnEndTime;
+    bool _burnStarted;
     bool _burnActive;
     unsigned long _lastTimestamp;
+    uint32_t _lastTimestampUs;
     float _lastForce;
+    float _minBurnThreshold;
 };
 
+// ===== Fixed-Point Accumulators =====
+// |force| is rounded to uN once per sample (a single float-to-uint32
+// conversion and 32x32->64 multiplies below 4294 N; 64-bit above), impulse
+// sums (F[i-1] + F[i]) * dt in 1/2 uN*us
+// and the burn thrust sum in uN, both uint64, and the burn start and end
+// are us timestamps. Integer sums are exact in any order and length (2^64
+// half uN*us is 9.2 MN*s), so nothing drifts however long the session.
+class ThrustMetricsFixed {
+public:
+    ThrustMetricsFixed() : _minBurnThreshold(0.1f) { reset(); }
+
+    void setMinBurnThreshold(float newtons) { _minBurnThreshold = newtons; }
+
+    void reset() {
+        _peakThrust = 0.0f;
+        _impulseHalfUnUs = 0;
+        _thrustSumUn = 0;
+        _sampleCount = 0;
+        _burnSampleCount = 0;
+        _burnStartUs = 0;
+        _burnEndUs = 0;
+        _burnStarted = false;
+        _burnActive = false;
+        _lastTimestampUs = 0;
+        _lastForceUn = 0;
+    }
+
+    // Update metrics with new data point (ms resolution only)
+    void update(float forceNewtons, unsigned long timestampMs) {
+        update(forceNewtons, timestampMs, (uint32_t)(timestampMs * 1000UL));
+    }
+
+    // Update metrics with the exact sample time in us (micros(), may wrap)
+    void update(float forceNewtons, unsigned long timestampMs, uint32_t timestampUs) {
+        (void)timestampMs;
+        if (isnan(forceNewtons)) return;
+
+        float absForce = fabsf(forceNewtons);
+        if (absForce > _peakThrust) {
+            _peakThrust = absForce;
+        }
+        uint64_t forceUn = toMicroNewtons(absForce);
+
+        // Trapezoidal rule, ignoring gaps over 100 ms
+        if (_sampleCount > 0) {
+            uint32_t dtUs = timestampUs - _lastTimestampUs;
+            if (dtUs > 0 && dtUs < THRUST_METRICS_MAX_GAP_US) {
+                if (((forceUn | _lastForceUn) >> 32) == 0) {
+                    // Below 4294 N: two 32x32->64 multiplies, no 64x64 call
+                    _impulseHalfUnUs += (uint64_t)(uint32_t)forceUn * dtUs +
+                                        (uint64_t)(uint32_t)_lastForceUn * dtUs;
+                } else {
+                    _impulseHalfUnUs += (forceUn + _lastForceUn) * dtUs;
+                }
+            }
+        }
+
+        float burnThreshold = fmaxf(_peakThrust * 0.05f, _minBurnThreshold);
+        _burnActive = absForce >= burnThreshold;
+        if (_burnActive) {
+            if (!_burnStarted) {
+                _burnStartUs = timestampUs;
+                _burnStarted = true;
+            }
+            _burnEndUs = timestampUs;
+            _thrustSumUn += forceUn;
+            _burnSampleCount++;
+        }
+
+        _lastTimestampUs = timestampUs;
+        _lastForceUn = forceUn;
+        _sampleCount++;
+    }
+
+    // Getters
+    float getPeakThrust() const { return _peakThrust; }
+    float getTotalImpulse() const { return (float)_impulseHalfUnUs * 5e-13f; }
+
+    float getBurnTime() const {
+        if (!_burnStarted) return 0.0f;
+        return (uint32_t)(_burnEndUs - _burnStartUs) * 1e-6f;
+    }
+
+    float getAverageThrust() const {
+        if (_burnSampleCount == 0) return 0.0f;
+        return (float)(_thrustSumUn / _burnSampleCount) * 1e-6f;
+    }
+
+    uint32_t getSampleCount() const { return _sampleCount; }
+    uint32_t getBurnSampleCount() const { return _burnSampleCount; }
+
+    // The last sample was above the burn threshold
+    bool isBurnActive() const { return _burnActive; }
+
+private:
+    static uint64_t toMicroNewtons(float newtons) {
+        if (newtons < 4294.0f) return (uint32_t)(newtons * 1e6f + 0.5f);
+        return (uint64_t)(newtons * 1e6f + 0.5f);
+    }
+
+    float _peakThrust;
+    uint64_t _impulseHalfUnUs;
+    uint64_t _thrustSumUn;
+    uint32_t _sampleCount;
+    uint32_t _burnSampleCount;
+    uint32_t _burnStartUs;
+    uint32_t _burnEndUs;
+    bool _burnStarted;
+    bool _burnActive;
+    uint32_t _lastTimestampUs;
+    uint64_t _lastForceUn;
+    float _minBurnThreshold;
+};
+
+#if THRUST_METRICS_FLOAT
+typedef ThrustMetricsFloat ThrustMetrics;
+#else
+typedef ThrustMetricsFixed ThrustMetrics;
+#endif
+
 #endif // THRUST_METRICS_H
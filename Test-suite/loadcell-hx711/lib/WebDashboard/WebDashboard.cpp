@@ -12,8 +12,13 @@ WebDashboard::WebDashboard()
     , _lastDataSend(0)
     , _lastMetricsSend(0)
     , _dataDecimator(0)
+    , _streamMode(STREAM_NORMAL)
+    , _batchCount(0)
     , _tareCallback(nullptr)
     , _calibrateCallback(nullptr)
+    , _statusCallback(nullptr)
+    , _captureCallback(nullptr)
+    , _downloadCallback(nullptr)
 {
     _instance = this;
 }
@@ -128,12 +133,30 @@ void WebDashboard::setupRoutes() {
         doc["recording"] = _recording;
         doc["clients"] = _ws->count();
         doc["uptime"] = (millis() - _sessionStartTime) / 1000;
+        if (_statusCallback) {
+            _statusCallback(doc);
+        }
 
         String response;
         serializeJson(doc, response);
         request->send(200, "application/json", response);
     });
 
+    // Full-rate burn capture, streamed in pieces (never held as one String)
+    _server->on("/api/capture.csv", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        if (!_downloadCallback) {
+            request->send(404, "text/plain", "Capture not enabled");
+            return;
+        }
+        DownloadCallback callback = _downloadCallback;
+        AsyncWebServerResponse* response = request->beginChunkedResponse("text/csv",
+            [callback](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                return callback(buffer, maxLen, index);
+            });
+        response->addHeader("Content-Disposition", "attachment; filename=\"capture.csv\"");
+        request->send(response);
+    });
+
     // 404 handler
     _server->onNotFound([](AsyncWebServerRequest* request) {
         request->send(404, "text/plain", "Not found");
@@ -217,32 +240,62 @@ void WebDashboard::handleWebSocketMessage(AsyncWebSocketClient* client, const ch
         resetSession();
         _ws->textAll("{\"type\":\"ack\",\"cmd\":\"reset\"}");
     }
+    else if (strcmp(cmd, "trigger") == 0) {
+        if (_captureCallback) {
+            _captureCallback("trigger");
+        }
+        _ws->textAll("{\"type\":\"ack\",\"cmd\":\"trigger\"}");
+    }
+    else if (strcmp(cmd, "arm") == 0) {
+        if (_captureCallback) {
+            _captureCallback("arm");
+        }
+        _ws->textAll("{\"type\":\"ack\",\"cmd\":\"arm\"}");
+    }
     else if (strcmp(cmd, "calibrate") == 0) {
-        float weight = doc["value"] | 0.0f;
-        if (weight > 0 && _calibrateCallback) {
-            _calibrateCallback(weight);
+        // step: start (stand empty), weight (value = grams), apply, cancel.
+        // A bare weight is the old single-message form
+        const char* step = doc["step"] | "weight";
+        float value = doc["value"] | 0.0f;
+        if (_calibrateCallback) {
+            _calibrateCallback(step, value);
         }
         _ws->textAll("{\"type\":\"ack\",\"cmd\":\"calibrate\"}");
     }
 }
 
-void WebDashboard::sendThrustData(float forceNewtons, unsigned long timestampMs) {
+void WebDashboard::sendThrustData(float forceNewtons, unsigned long timestampMs, uint32_t timestampUs) {
     if (!_initialized || !_ws) return;
 
     // Update metrics (always, for accurate calculations)
     if (_recording) {
-        _metrics.update(forceNewtons, timestampMs);
+        _metrics.update(forceNewtons, timestampMs, timestampUs);
     }
 
     unsigned long now = millis();
 
+    // During a burn every sample goes out, a batch per message; cleanup and
+    // metrics wait until it is over
+    if (_streamMode == STREAM_BURN) {
+        _batchTime[_batchCount] = timestampMs - _sessionStartTime;
+        _batchForce[_batchCount] = forceNewtons;
+        _batchCount++;
+        if (_batchCount == WS_BURN_BATCH_SAMPLES || now - _lastDataSend >= WS_BURN_FLUSH_MS) {
+            _lastDataSend = now;
+            sendBatch();
+        }
+        return;
+    }
+
     // Cleanup dead connections every 5 seconds
     if (now - _lastDataSend > 5000 && _dataDecimator == 0) {
         cleanupClients();
     }
 
-    // Rate limit WebSocket to 20Hz (every 50ms) to prevent buffer overflow
-    if (now - _lastDataSend >= 50) {
+    // Rate limit WebSocket to 20Hz (every 50ms) to prevent buffer overflow,
+    // less while idle
+    unsigned long interval = _streamMode == STREAM_IDLE ? WS_IDLE_DATA_INTERVAL_MS : 50;
+    if (now - _lastDataSend >= interval) {
         _lastDataSend = now;
 
         if (_ws->count() > 0) {
@@ -264,6 +317,56 @@ void WebDashboard::sendThrustData(float forceNewtons, unsigned long timestampMs)
     }
 }
 
+void WebDashboard::setStreamMode(StreamMode mode) {
+    if (mode == _streamMode) return;
+
+    if (_streamMode == STREAM_BURN) {
+        sendBatch();
+        _lastMetricsSend = millis();
+        sendMetrics();
+    }
+    _streamMode = mode;
+}
+
+void WebDashboard::sendBatch() {
+    uint8_t count = _batchCount;
+    _batchCount = 0;
+    if (count == 0 || !_initialized || !_ws || _ws->count() == 0) return;
+
+    // {"type":"batch","t":[...],"f":[...]}, about 11 bytes per number. An
+    // absurd force cannot overrun it: the arrays are cut short instead
+    char buffer[48 + WS_BURN_BATCH_SAMPLES * 24];
+    const size_t reserve = 64;
+    size_t length = snprintf(buffer, sizeof(buffer), "{\"type\":\"batch\",\"t\":[");
+    for (uint8_t i = 0; i < count; i++) {
+        length += snprintf(buffer + length, sizeof(buffer) - length, "%s%lu",
+                           i ? "," : "", _batchTime[i]);
+    }
+    length += snprintf(buffer + length, sizeof(buffer) - length, "],\"f\":[");
+    for (uint8_t i = 0; i < count && length < sizeof(buffer) - reserve; i++) {
+        length += snprintf(buffer + length, sizeof(buffer) - length, "%s%.3f",
+                           i ? "," : "", _batchForce[i]);
+    }
+    snprintf(buffer + length, sizeof(buffer) - length, "]}");
+    _ws->textAll(buffer);
+}
+
+void WebDashboard::sendCalibrationStatus(const char* state, const char* message, float factor) {
+    if (!_initialized || !_ws || _ws->count() == 0) return;
+
+    JsonDocument doc;
+    doc["type"] = "calibration";
+    doc["state"] = state;
+    doc["message"] = message;
+    if (factor != 0.0f) {
+        doc["factor"] = factor;
+    }
+
+    String msg;
+    serializeJson(doc, msg);
+    _ws->textAll(msg);
+}
+
 void WebDashboard::sendMetrics() {
     if (!_ws || _ws->count() == 0) return;
 
@@ -13,7 +13,18 @@
 // Forward declaration for callback
 class WebDashboard;
 typedef void (*TareCallback)();
-typedef void (*CalibrateCallback)(float weightGrams);
+typedef void (*CalibrateCallback)(const char* step, float value);  // start/weight/apply/cancel
+typedef void (*StatusCallback)(JsonDocument& doc);   // Adds fields to /api/status
+typedef void (*CaptureCallback)(const char* action);  // "trigger" or "arm"
+// Fills the next piece of a download (index = bytes sent so far); 0 ends it
+typedef size_t (*DownloadCallback)(uint8_t* buffer, size_t maxLen, size_t index);
+
+// How much of the sample stream goes to the browsers
+enum StreamMode : uint8_t {
+    STREAM_NORMAL,      // 20 Hz data, 4 Hz metrics
+    STREAM_IDLE,        // WS_IDLE_DATA_INTERVAL_MS data, 4 Hz metrics
+    STREAM_BURN         // Every sample in batches; no metrics or cleanup
+};
 
 class WebDashboard {
 public:
@@ -25,11 +36,19 @@ public:
     bool beginStation(const char* ssid, const char* password);
 
     // Data streaming
-    void sendThrustData(float forceNewtons, unsigned long timestampMs);
+    void sendThrustData(float forceNewtons, unsigned long timestampMs, uint32_t timestampUs);
+    // Tare/calibration progress (LoadCellCalibrator state name and message)
+    void sendCalibrationStatus(const char* state, const char* message, float factor = 0.0f);
+    // Leaving STREAM_BURN flushes its last batch and sends the metrics
+    void setStreamMode(StreamMode mode);
+    StreamMode getStreamMode() const { return _streamMode; }
 
     // Callbacks for commands
     void onTare(TareCallback callback) { _tareCallback = callback; }
     void onCalibrate(CalibrateCallback callback) { _calibrateCallback = callback; }
+    void onStatus(StatusCallback callback) { _statusCallback = callback; }
+    void onCapture(CaptureCallback callback) { _captureCallback = callback; }
+    void onCaptureDownload(DownloadCallback callback) { _downloadCallback = callback; }  // /api/capture.csv
 
     // Session control
     void startRecording();
@@ -58,15 +77,25 @@ private:
     unsigned long _lastDataSend;
     unsigned long _lastMetricsSend;
     uint8_t _dataDecimator;
+    StreamMode _streamMode;
+
+    // Burn samples waiting for the next batch message
+    unsigned long _batchTime[WS_BURN_BATCH_SAMPLES];
+    float _batchForce[WS_BURN_BATCH_SAMPLES];
+    uint8_t _batchCount;
 
     // Callbacks
     TareCallback _tareCallback;
     CalibrateCallback _calibrateCallback;
+    StatusCallback _statusCallback;
+    CaptureCallback _captureCallback;
+    DownloadCallback _downloadCallback;
 
     // Internal methods
     void setupRoutes();
     void handleWebSocketMessage(AsyncWebSocketClient* client, const char* data);
     void sendMetrics();
+    void sendBatch();
     void cleanupClients();
 
     // WebSocket event handler (static for callback)
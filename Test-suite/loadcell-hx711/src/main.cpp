@@ -1,4 +1,7 @@
 #include "LoadCellModule.h"
+#include "LoadCellCalibrator.h"
+#include "CalibrationStore.h"
+#include "SampleRateMonitor.h"
 #include "loadcell_config.h"
 #include <Arduino.h>
 
@@ -10,8 +13,41 @@
 #include "TeensyUART.h"
 #endif
 
+#ifdef ENABLE_FORCE_FILTER
+#include "ForceFilter.h"
+#include "StandIdentifier.h"
+#endif
+
+#ifdef ENABLE_BURN_CAPTURE
+#include "BurnCapture.h"
+#endif
+
+#ifdef ENABLE_OUTPUT_QOS
+#include "OutputQos.h"
+#endif
+
+#ifdef ENABLE_DUAL_RATE
+#include "DualRateController.h"
+#endif
+
+#ifdef ENABLE_THRUST_ANALYTICS
+#include "ThrustAnalytics.h"
+#endif
+
+#if LOADCELL_ADC == LOADCELL_ADC_SIM
+#include <LittleFS.h>
+#endif
+
 // ===== Global Objects =====
 LoadCellModule loadCell;
+LoadCellCalibrator calibrator(loadCell);
+CalibrationStore calibrationStore;
+
+SampleRateMonitor rateMonitor;
+bool rateWarned = false;
+
+// Build-flag factors; a table saved in NVS replaces them per channel
+const float buildCalibrationFactors[LOADCELL_CHANNELS] = LOADCELL_CAL_FACTORS;
 
 #ifdef ENABLE_WEB_DASHBOARD
 WebDashboard dashboard;
@@ -21,13 +57,126 @@ WebDashboard dashboard;
 TeensyUART teensyUart;
 #endif
 
+#ifdef ENABLE_FORCE_FILTER
+ForceFilterChain forceFilter;
+
+// Measured cost of forceFilter.process() per sample
+uint32_t filterSamples = 0;
+uint64_t filterTotalCycles = 0;
+uint32_t filterMaxCycles = 0;
+bool filterBudgetWarned = false;
+
+// Stand test ('m'): identifies the ringing for the comp stage
+StandIdentifier standTest;
+unsigned long standTestStartMs = 0;
+#endif
+
+#ifdef ENABLE_BURN_CAPTURE
+BurnCapture burnCapture;
+#endif
+
+#ifdef ENABLE_OUTPUT_QOS
+OutputQos outputQos;
+#endif
+
+#ifdef ENABLE_DUAL_RATE
+DualRateController rateController(loadCell);
+#endif
+
+#ifdef ENABLE_THRUST_ANALYTICS
+ThrustAnalytics thrustAnalytics;
+#endif
+
 // ===== Timing =====
 unsigned long startTime = 0;
 bool outputEnabled = true;
 
+// ===== Serial Line Input =====
+// Answers longer than one key are collected a character per loop(), so
+// sampling and streaming carry on while a prompt is open. Lines typed while
+// the calibrator waits for input go to the calibrator.
+enum SerialPrompt : uint8_t {
+    PROMPT_NONE,
+    PROMPT_CAL_CHANNEL,
+    PROMPT_FILTER_SPEC
+};
+
+#define SERIAL_LINE_SIZE 64
+#define SERIAL_LINE_GUARD_MS 50     // Line ending of the command key itself
+
+SerialPrompt serialPrompt = PROMPT_NONE;
+char serialLine[SERIAL_LINE_SIZE];
+uint8_t serialLineLength = 0;
+char serialLastChar = 0;
+unsigned long serialCommandMs = 0;
+
+// ===== Deferred Notices =====
+// Status prints that can wait: during a burn (ENABLE_OUTPUT_QOS) the serial
+// link is kept for samples and they are printed once it is over
+#define NOTICE_SAMPLE_RATE 0x01
+#define NOTICE_CAPTURE 0x02
+#define NOTICE_BURN_REPORT 0x04
+#define NOTICE_RAW_REPORT 0x08
+
+uint8_t pendingNotices = 0;
+
+// ===== Raw Reading ('r') =====
+// Averaged from the frames loop() already reads, so the stream, the burn
+// capture and the rate monitor miss none
+#define RAW_REPORT_READINGS 10
+
+bool rawReportPending = false;
+uint8_t rawReportCount = 0;
+long rawReportFirst[LOADCELL_CHANNELS];
+long rawReportSums[LOADCELL_CHANNELS];
+
 // ===== Function Prototypes =====
 void printHelp();
+void printCsvHeader();
 void handleSerialCommands();
+bool readSerialLine();
+void handleSerialLine(const char* line);
+void onCalibrationEvent(const LoadCellCalibrator& cal, CalibrationEvent event);
+void loadStoredCalibration();
+void printCalibrationTables();
+void checkBootSampleRate();
+void checkSampleRate();
+void warnLowSampleRate();
+void printSampleRateReport();
+void postNotice(uint8_t notice);
+void printNotices(uint8_t notices);
+void startRawReport();
+void recordRawReport(const ThrustData& data);
+void printRawReport();
+#ifdef ENABLE_OUTPUT_QOS
+void onOutputModeChange();
+#endif
+#ifdef ENABLE_DUAL_RATE
+void onRateEvent(const DualRateController& controller, DualRateEvent event);
+#endif
+#ifdef ENABLE_BURN_CAPTURE
+void startBurnCapture();
+void reportCaptureState();
+void printCaptureStatus();
+void dumpCapture();
+size_t captureDownload(uint8_t* buffer, size_t maxLen, size_t index);
+#endif
+#ifdef ENABLE_TEENSY_UART
+void printTeensyLinkStats();
+#endif
+#if HX711_ACQ_TASK
+void printTaskStats();
+#endif
+#ifdef ENABLE_FORCE_FILTER
+bool configureFilter(const char* spec);
+float filterForce(float forceNewtons);
+void printFilterStatus();
+void startStandTest();
+void onStandTestUpdate();
+#endif
+#ifdef ENABLE_THRUST_ANALYTICS
+void printBurnReport();
+#endif
 
 void setup() {
     Serial.begin(SERIAL_BAUD);
@@ -43,28 +192,89 @@ void setup() {
     Serial.print(F("# Calibration Factor: "));
     Serial.println(CALIBRATION_FACTOR, 3);
     Serial.println(F("#"));
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
+#ifdef ENABLE_DUAL_RATE
+    Serial.print(F("# HX711 RATE pin driven from GPIO"));
+    Serial.println(HX711_RATE_PIN);
+#else
     Serial.println(F("# IMPORTANT: Ensure HX711 RATE pin is HIGH for 80Hz!"));
+#endif
     Serial.println(F("#"));
+#endif
 
-    // Initialize load cell
+    // Initialize load cell: start the ADC backend, then the module
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
     Serial.println(F("# Initializing HX711..."));
 
-    if (!loadCell.begin(LOADCELL_DOUT_PIN, LOADCELL_SCK_PIN, CALIBRATION_FACTOR)) {
-        Serial.println(F("# FATAL: HX711 initialization failed!"));
+    // One or more HX711s on a shared SCK (LOADCELL_CHANNELS)
+    static const uint8_t doutPins[LOADCELL_CHANNELS] = LOADCELL_DOUT_PINS;
+#ifdef ENABLE_DUAL_RATE
+    // Slow until armed; the rate controller switches RATE
+    bool adcStarted = loadCell.adc().begin(doutPins, LOADCELL_CHANNELS, LOADCELL_SCK_PIN,
+                                           DUAL_RATE_SLOW_SPS, HX711_RATE_PIN);
+#else
+    bool adcStarted = loadCell.adc().begin(doutPins, LOADCELL_CHANNELS, LOADCELL_SCK_PIN, HX711_SPS);
+#endif
+    if (!adcStarted) {
+        Serial.println(F("# ERROR: HX711 DOUT pins must all be below GPIO32 or all above"));
+    }
+#elif LOADCELL_ADC == LOADCELL_ADC_ADS1220
+    Serial.println(F("# Initializing ADS1220..."));
+    bool adcStarted = loadCell.adc().begin(ADS1220_CS_PIN, ADS1220_DRDY_PIN, ADS1220_SPS);
+#else
+    Serial.println(F("# Initializing simulated ADC (no hardware)..."));
+    if (SIM_ADC_CURVE_FILE[0]) {
+        LittleFS.begin();
+    }
+    // Paced by the real clock so the rest of the firmware sees live samples
+    loadCell.adc().setClock([]() -> uint32_t { return micros(); });
+#ifdef ENABLE_DUAL_RATE
+    bool adcStarted = loadCell.adc().begin(SIM_ADC_CURVE_FILE, DUAL_RATE_SLOW_SPS, LOADCELL_CHANNELS);
+#else
+    bool adcStarted = loadCell.adc().begin(SIM_ADC_CURVE_FILE, SIM_ADC_SAMPLE_HZ, LOADCELL_CHANNELS);
+#endif
+    if (adcStarted) {
+        loadCell.adc().setScale(buildCalibrationFactors);
+        loadCell.adc().setNoise(SIM_ADC_NOISE_COUNTS);
+    }
+#endif
+
+    if (!adcStarted || !loadCell.begin(buildCalibrationFactors)) {
+        Serial.println(F("# FATAL: ADC initialization failed!"));
+        Serial.print(F("# "));
+        Serial.println(adcStarted ? loadCell.getStatusString() : "ADC setup failed");
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
         Serial.println(F("# Check wiring:"));
         Serial.println(F("#   HX711 VCC  -> 3.3V"));
         Serial.println(F("#   HX711 GND  -> GND"));
-        Serial.print(F("#   HX711 DT   -> GPIO"));
-        Serial.println(LOADCELL_DOUT_PIN);
+        for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+            Serial.print(F("#   HX711 DT   -> GPIO"));
+            Serial.println(doutPins[ch]);
+        }
         Serial.print(F("#   HX711 SCK  -> GPIO"));
         Serial.println(LOADCELL_SCK_PIN);
+#elif LOADCELL_ADC == LOADCELL_ADC_ADS1220
+        Serial.println(F("# Check wiring: SCLK 18, DOUT 19, DIN 23"));
+        Serial.print(F("#   CS   -> GPIO"));
+        Serial.println(ADS1220_CS_PIN);
+        Serial.print(F("#   DRDY -> GPIO"));
+        Serial.println(ADS1220_DRDY_PIN);
+#else
+        Serial.print(F("# Check curve file: "));
+        Serial.println(SIM_ADC_CURVE_FILE);
+#endif
         Serial.println(F("# System halted."));
         while (1) {
             delay(1000);
         }
     }
 
-    Serial.println(F("# HX711 OK"));
+    Serial.print(F("# ADC OK, "));
+    Serial.print(loadCell.getSampleRate(), 0);
+    Serial.println(F(" SPS"));
+    Serial.println(HX711_DRDY_INTERRUPT ? F("# Acquisition: DRDY interrupt (us timestamps)")
+                                        : F("# Acquisition: polled"));
+    loadStoredCalibration();
     Serial.println(F("#"));
     Serial.println(F("# Taring... ensure NO load on sensor!"));
     delay(1000);
@@ -72,23 +282,196 @@ void setup() {
     Serial.println(F("# Tare complete."));
     Serial.println(F("#"));
 
+    checkBootSampleRate();
+    Serial.println(F("#"));
+
+    // Later tares and calibrations run alongside sampling
+    calibrator.onEvent(onCalibrationEvent);
+
+#ifdef ENABLE_DUAL_RATE
+    rateController.configure(DUAL_RATE_SLOW_SPS, DUAL_RATE_FAST_SPS, DUAL_RATE_TRIGGER_N,
+                             DUAL_RATE_HOLD_MS, DUAL_RATE_ARM_TIMEOUT_MS);
+    rateController.onEvent(onRateEvent);
+    Serial.print(F("# Dual rate: "));
+    Serial.print(DUAL_RATE_SLOW_SPS, 0);
+    Serial.print(F(" SPS idle, "));
+    Serial.print(DUAL_RATE_FAST_SPS, 0);
+    Serial.print(F(" SPS armed ('a') or above "));
+    Serial.print(DUAL_RATE_TRIGGER_N, 1);
+    Serial.println(F(" N"));
+    Serial.println(F("#"));
+#endif
+
+#ifdef ENABLE_FORCE_FILTER
+    if (!configureFilter(FORCE_FILTER_SPEC)) {
+        Serial.println(F("# WARNING: invalid FORCE_FILTER_SPEC, filter off"));
+    }
+    {
+        char spec[64];
+        forceFilter.describe(spec, sizeof(spec));
+        Serial.print(F("# Force filter: "));
+        Serial.println(spec);
+    }
+    Serial.println(F("#"));
+#endif
+
+#ifdef ENABLE_OUTPUT_QOS
+    outputQos.configure(loadCell.getSampleRate(), OUTPUT_QOS_BURN_N, OUTPUT_QOS_HOLD_MS,
+                        OUTPUT_QOS_IDLE_CSV_HZ);
+    Serial.print(F("# Output QoS: burn above "));
+    Serial.print(OUTPUT_QOS_BURN_N, 1);
+    Serial.print(F(" N, idle CSV every "));
+    Serial.print(outputQos.getIdleCsvDivider());
+    Serial.println(outputQos.getIdleCsvDivider() == 1 ? F(" sample") : F(" samples"));
+    Serial.println(F("#"));
+#endif
+
+#ifdef ENABLE_THRUST_ANALYTICS
+    thrustAnalytics.configure(ANALYTICS_BURN_START_N, ANALYTICS_BURN_END_N, ANALYTICS_BURN_END_HOLD_MS,
+                              ANALYTICS_MAX_GAP_MS);
+    Serial.print(F("# Burn analytics: from "));
+    Serial.print(ANALYTICS_BURN_START_N, 1);
+    Serial.print(F(" N until below "));
+    Serial.print(ANALYTICS_BURN_END_N, 1);
+    Serial.print(F(" N for "));
+    Serial.print(ANALYTICS_BURN_END_HOLD_MS);
+    Serial.println(F(" ms"));
+    Serial.println(F("#"));
+#endif
+
+#if HX711_ACQ_TASK
+    // Sampling moves to its own task on core 1; loop() only consumes
+    if (loadCell.startTask()) {
+        Serial.print(F("# Acquisition task on core "));
+        Serial.print(HX711_ACQ_TASK_CORE);
+        Serial.print(F(", loop() on core "));
+        Serial.println(xPortGetCoreID());
+    } else {
+        Serial.println(F("# WARNING: acquisition task failed, sampling from loop()"));
+    }
+    Serial.println(F("#"));
+#endif
+
 #ifdef ENABLE_WEB_DASHBOARD
     // Initialize web dashboard (AP mode)
     Serial.println(F("# Starting Web Dashboard..."));
     if (dashboard.beginAP()) {
         Serial.println(F("# Dashboard ready at http://192.168.4.1"));
-        // Register tare callback (use fewer readings to avoid blocking WebSocket)
+        // Web commands arrive on the AsyncTCP task: hand them to loop()
+        // through the calibrator's queue
         dashboard.onTare([]() {
-            loadCell.tare(5);  // Quick tare for web (vs 20 for serial)
-            startTime = millis();
+            calibrator.post(CAL_CMD_TARE);
         });
-        // Register calibrate callback
-        dashboard.onCalibrate([](float weightGrams) {
-            float weightNewtons = weightGrams * GRAMS_TO_NEWTONS;
-            Serial.print(F("# Web calibrate: "));
-            Serial.print(weightGrams);
-            Serial.println(F(" g"));
-            // Note: Full calibration requires raw readings at zero and with weight
+        dashboard.onCalibrate([](const char* step, float value) {
+            if (strcmp(step, "start") == 0) {
+                // The page asks for an empty stand before sending this
+                calibrator.post(CAL_CMD_START, value);
+                calibrator.post(CAL_CMD_CONFIRM_ZERO);
+            } else if (strcmp(step, "weight") == 0) {
+                calibrator.post(CAL_CMD_WEIGHT, value);
+            } else if (strcmp(step, "apply") == 0) {
+                calibrator.post(CAL_CMD_APPLY);
+            } else if (strcmp(step, "cancel") == 0) {
+                calibrator.post(CAL_CMD_CANCEL);
+            }
+        });
+#ifdef ENABLE_BURN_CAPTURE
+        // Both only set flags that the next record() acts on
+        dashboard.onCapture([](const char* action) {
+            if (strcmp(action, "trigger") == 0) {
+                burnCapture.trigger();
+            } else {
+                burnCapture.arm();
+            }
+        });
+        dashboard.onCaptureDownload(captureDownload);
+#endif
+#ifdef ENABLE_OUTPUT_QOS
+        dashboard.setStreamMode(STREAM_IDLE);
+#endif
+        // Sample rate check (and the Teensy link) in /api/status
+        dashboard.onStatus([](JsonDocument& doc) {
+            const SampleRateStats& rate = rateMonitor.getStats();
+            JsonObject sampling = doc["sampling"].to<JsonObject>();
+            sampling["nominalHz"] = rate.nominalHz;
+            sampling["rateHz"] = rate.rateHz;
+            sampling["averageRateHz"] = rate.averageRateHz;
+            sampling["meanIntervalUs"] = rate.meanIntervalUs;
+            sampling["jitterUs"] = rate.jitterUs;
+            sampling["minIntervalUs"] = rate.minIntervalUs;
+            sampling["maxIntervalUs"] = rate.maxIntervalUs;
+            sampling["samples"] = rate.samples;
+            sampling["missedDrdy"] = rate.missed;
+            sampling["queueDrops"] = loadCell.getQueueDrops();
+            sampling["histogramBinUs"] = rateMonitor.getBinWidthUs();
+            JsonArray histogram = sampling["histogram"].to<JsonArray>();
+            for (uint8_t bin = 0; bin < SAMPLE_RATE_HIST_BINS; bin++) {
+                histogram.add(rateMonitor.getHistogram(bin));
+            }
+#ifdef ENABLE_OUTPUT_QOS
+            JsonObject output = doc["output"].to<JsonObject>();
+            output["mode"] = outputQos.getModeName();
+            output["burns"] = outputQos.getBurnCount();
+            output["lastBurnS"] = outputQos.getLastBurnS();
+            output["idleCsvDivider"] = outputQos.getIdleCsvDivider();
+#endif
+#ifdef ENABLE_DUAL_RATE
+            JsonObject rateMode = doc["rate"].to<JsonObject>();
+            rateMode["mode"] = rateController.getModeName();
+            rateMode["sps"] = loadCell.getSampleRate();
+            rateMode["shift"] = loadCell.getRateShift(0);
+            rateMode["settleDrops"] = loadCell.getSettleDrops();
+#endif
+#ifdef ENABLE_THRUST_ANALYTICS
+            JsonObject analytics = doc["analytics"].to<JsonObject>();
+            analytics["state"] = thrustAnalytics.getStateName();
+            analytics["burns"] = thrustAnalytics.getBurnCount();
+            const BurnReport& report = thrustAnalytics.getReport();
+            if (report.number > 0) {
+                char designation[16];
+                thrustAnalytics.getDesignation(designation, sizeof(designation));
+                JsonObject last = analytics["last"].to<JsonObject>();
+                last["number"] = report.number;
+                last["designation"] = designation;
+                last["impulseClass"] = report.impulseClass;
+                last["burnTimeS"] = report.burnTimeS;
+                last["peakN"] = report.peakN;
+                last["timeToPeakS"] = report.timeToPeakS;
+                last["impulseNs"] = report.impulseNs;
+                last["averageN"] = report.averageN;
+                last["riseS"] = report.riseS;
+                last["tailOffS"] = report.tailOffS;
+                last["actionTimeS"] = report.actionTimeS;
+                last["actionImpulseNs"] = report.actionImpulseNs;
+                last["actionAverageN"] = report.actionAverageN;
+                last["medianN"] = report.medianN;
+                last["p90N"] = report.p90N;
+                last["samples"] = report.samples;
+                last["gaps"] = report.gaps;
+            }
+#endif
+#ifdef ENABLE_BURN_CAPTURE
+            JsonObject capture = doc["capture"].to<JsonObject>();
+            capture["state"] = burnCapture.getStateName();
+            capture["capacity"] = burnCapture.getCapacity();
+            capture["samples"] = burnCapture.getSampleCount();
+            capture["preTriggerSamples"] = burnCapture.getPreTriggerSamples();
+            capture["durationS"] = burnCapture.getDurationS();
+            capture["peakN"] = burnCapture.getPeakN();
+            capture["truncated"] = burnCapture.isTruncated();
+#endif
+#ifdef ENABLE_TEENSY_UART
+            const TeensyUartStats& stats = teensyUart.getStats();
+            JsonObject link = doc["teensyUart"].to<JsonObject>();
+            link["baud"] = teensyUart.getBaud();
+            link["framesSent"] = stats.framesSent;
+            link["retransmits"] = stats.retransmits;
+            link["heldLost"] = stats.heldLost;
+            link["txDropped"] = stats.txDropped;
+            link["txDiscarded"] = stats.txDiscarded;
+            link["txQueued"] = stats.txQueued;
+            link["txQueueHighWater"] = stats.txQueueHighWater;
+#endif
         });
     } else {
         Serial.println(F("# Dashboard failed to start"));
@@ -102,12 +485,20 @@ void setup() {
     Serial.println(F("#"));
 #endif
 
+#ifdef ENABLE_BURN_CAPTURE
+    // Last, so WiFi and the web server already have their memory
+    startBurnCapture();
+    Serial.println(F("#"));
+#endif
+
     printHelp();
 
     Serial.println(F("#"));
     Serial.println(F("# Starting data output..."));
-    Serial.println(F("# timestamp_ms,force_N"));
+    printCsvHeader();
 
+    // Setup time is not a sampling gap
+    rateMonitor.reset(micros());
     startTime = millis();
 }
 
@@ -115,57 +506,141 @@ void loop() {
     // Handle serial commands (non-blocking)
     handleSerialCommands();
 
-    // Read and output at maximum rate (80Hz = ~12.5ms per sample)
+#ifdef ENABLE_TEENSY_UART
+    // Windowed ACKs from the Teensy; retransmits any reported holes
+    teensyUart.poll();
+#endif
+
+    // Read and output at maximum rate (80Hz = ~12.5ms per sample). In DRDY
+    // interrupt mode this drains samples already taken by the ISR
     ThrustData data;
-    if (loadCell.readIfReady(data) && data.valid) {
-        if (outputEnabled) {
-            // CSV output: timestamp_ms,force_N
+    while (loadCell.readIfReady(data) && data.valid) {
+        // Tare/calibration averaging happens on the live stream
+        calibrator.update(&data, millis());
+        if (rawReportPending) {
+            recordRawReport(data);
+        }
+
+#ifdef ENABLE_DUAL_RATE
+        // Slow while taring or calibrating. A switch restarts the rate
+        // monitor after this frame
+        rateController.update(data, calibrator.isBusy());
+#endif
+
+        if (rateMonitor.record(data.timestampUs)) {
+            postNotice(NOTICE_SAMPLE_RATE);
+        }
+
+#ifdef ENABLE_BURN_CAPTURE
+        // Raw force at full rate; calibration weights do not trigger
+        if (burnCapture.record(data.forceNewtons, data.timestampUs, !calibrator.isBusy())) {
+            postNotice(NOTICE_CAPTURE);
+        }
+#endif
+
+#ifdef ENABLE_FORCE_FILTER
+        // The stand test sees the unfiltered force
+        if (standTest.isBusy() && standTest.update(data.forceNewtons)) {
+            onStandTestUpdate();
+        }
+        float force = filterForce(data.forceNewtons);
+#else
+        float force = data.forceNewtons;
+#endif
+
+#ifdef ENABLE_THRUST_ANALYTICS
+        // Calibration weights are not burns
+        if (!calibrator.isBusy() && thrustAnalytics.update(force, data.timestampUs)) {
+            postNotice(NOTICE_BURN_REPORT);
+        }
+#endif
+
+#ifdef ENABLE_OUTPUT_QOS
+        if (outputQos.update(force, data.timestamp, data.timestampUs)) {
+            onOutputModeChange();
+        }
+        bool csvDue = outputQos.isCsvDue();
+#else
+        bool csvDue = true;
+#endif
+
+        // CSV pauses while a prompt or calibration is on the console
+        if (csvDue && outputEnabled && serialPrompt == PROMPT_NONE && !calibrator.isBusy()) {
+            // CSV output: timestamp_ms,force_N[,raw_N][,ch0_N,...]
             unsigned long relativeTime = data.timestamp - startTime;
             Serial.print(relativeTime);
             Serial.print(',');
-            Serial.println(data.forceNewtons, 3);
+            Serial.print(force, 3);
+#ifdef ENABLE_FORCE_FILTER
+            Serial.print(',');
+            Serial.print(data.forceNewtons, 3);
+#endif
+#if LOADCELL_CHANNELS > 1
+            for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+                Serial.print(',');
+                Serial.print(data.channelForceN[ch], 3);
+            }
+#endif
+            Serial.println();
         }
 
 #ifdef ENABLE_WEB_DASHBOARD
         // Stream data to web dashboard
-        dashboard.sendThrustData(data.forceNewtons, data.timestamp);
+        dashboard.sendThrustData(force, data.timestamp, data.timestampUs);
 #endif
 
 #ifdef ENABLE_TEENSY_UART
-        // Stream data to Teensy via UART
-        teensyUart.sendThrustData(data.forceNewtons, data.timestamp - startTime);
+        // Stream data to Teensy via UART. On the ESP32 micros() is the
+        // low 32 bits of the same timer as millis() * 1000, so this is the
+        // time since startTime in us (with a constant offset under 1 ms).
+        // The logger always gets the unfiltered force
+        teensyUart.sendThrustData(data.forceNewtons, data.timestamp - startTime,
+                                  data.timestampUs - (uint32_t)(startTime * 1000UL));
 #endif
     }
+
+    // Web commands and calibration timeouts
+    calibrator.update(nullptr, millis());
+
+#ifdef ENABLE_FORCE_FILTER
+    // Left waiting, the stand test would take the next burn for a tap
+    if (standTest.getState() == STAND_ID_WAITING && millis() - standTestStartMs > STAND_ID_TIMEOUT_MS) {
+        standTest.cancel();
+        Serial.println(F("# Stand test timed out"));
+    }
+#endif
 }
 
 void handleSerialCommands() {
     if (!Serial.available()) return;
 
+    // An open prompt or a calibration step takes whole lines
+    if (serialPrompt != PROMPT_NONE || calibrator.isWaitingForInput()) {
+        if (readSerialLine()) {
+            handleSerialLine(serialLine);
+        }
+        return;
+    }
+
     char cmd = Serial.read();
+    serialCommandMs = millis();
 
     switch (cmd) {
         case 't':
         case 'T':
-            outputEnabled = false;
-            Serial.println(F("# Taring... remove all load!"));
-            delay(500);
-            loadCell.tare(TARE_READINGS);
-            Serial.println(F("# Tare complete."));
-            startTime = millis();  // Reset timestamp
-            Serial.println(F("# timestamp_ms,force_N"));
-            outputEnabled = true;
+            // Averaged from the live stream after a settle delay; the
+            // calibrator reports completion
+            if (calibrator.startTare(TARE_READINGS, 500)) {
+                Serial.println(F("# Taring... remove all load!"));
+            } else {
+                Serial.println(F("# Busy: calibration in progress ('x' cancels)"));
+            }
             break;
 
         case 'r':
         case 'R':
-            outputEnabled = false;
-            Serial.println(F("# --- Raw ADC Reading ---"));
-            Serial.print(F("# Raw Value: "));
-            Serial.println(loadCell.getRawValue());
-            Serial.print(F("# Avg Raw (10): "));
-            Serial.println(loadCell.getAverageRawValue(10));
-            Serial.println(F("# timestamp_ms,force_N"));
-            outputEnabled = true;
+            // Printed once RAW_REPORT_READINGS more frames have arrived
+            startRawReport();
             break;
 
         case 'p':
@@ -173,7 +648,7 @@ void handleSerialCommands() {
             outputEnabled = !outputEnabled;
             if (outputEnabled) {
                 Serial.println(F("# Output RESUMED"));
-                Serial.println(F("# timestamp_ms,force_N"));
+                printCsvHeader();
             } else {
                 Serial.println(F("# Output PAUSED (press 'p' to resume)"));
             }
@@ -184,162 +659,169 @@ void handleSerialCommands() {
             // Zero/reset timestamp
             startTime = millis();
             Serial.println(F("# Timestamp reset to 0"));
-            Serial.println(F("# timestamp_ms,force_N"));
+            printCsvHeader();
             break;
 
         case 'c':
-        case 'C': {
-            // Calibration helper
-            outputEnabled = false;
+        case 'C':
+            // Steps are answered through handleSerialLine()
             Serial.println(F("#"));
             Serial.println(F("# === CALIBRATION MODE ==="));
-            Serial.println(F("#"));
-            Serial.println(F("# Step 1: Remove all weight from load cell"));
-            Serial.println(F("# Press ENTER when ready..."));
-
-            // Wait for Enter key
-            while (!Serial.available()) delay(10);
-            while (Serial.available()) Serial.read();
+#if LOADCELL_CHANNELS > 1
+            // Each cell is calibrated on its own
+            Serial.print(F("# Channel to calibrate (0-"));
+            Serial.print(LOADCELL_CHANNELS - 1);
+            Serial.println(F("):"));
+            serialPrompt = PROMPT_CAL_CHANNEL;
+#else
+            calibrator.startCalibration(0);
+#endif
+            break;
 
-            Serial.println(F("# Reading zero point (20 samples)..."));
-            delay(500);  // Allow sensor to settle
-            long rawZero = loadCell.getAverageRawValue(20);
-            Serial.print(F("# Raw (no weight): "));
-            Serial.println(rawZero);
+        case 'x':
+        case 'X':
+            calibrator.cancel();
+            break;
 
-            Serial.println(F("#"));
-            Serial.println(F("# Step 2: Place known weight on load cell"));
-            Serial.println(F("# Then enter the weight in GRAMS (e.g., 500 or 1000):"));
-
-            // Read weight input from serial
-            char inputBuffer[16];
-            uint8_t inputIndex = 0;
-            memset(inputBuffer, 0, sizeof(inputBuffer));
-
-            // Wait for and read numeric input
-            while (true) {
-                if (Serial.available()) {
-                    char c = Serial.read();
-                    // Enter key ends input
-                    if (c == '\r' || c == '\n') {
-                        if (inputIndex > 0) break;  // Only break if we have input
-                    }
-                    // Accept digits and decimal point
-                    else if ((c >= '0' && c <= '9') || c == '.') {
-                        if (inputIndex < sizeof(inputBuffer) - 1) {
-                            inputBuffer[inputIndex++] = c;
-                            Serial.print(c);  // Echo character
-                        }
-                    }
-                }
-                delay(10);
-            }
-            Serial.println();  // New line after input
+        case 'j':
+        case 'J':
+            outputEnabled = false;
+            printSampleRateReport();
+            printCsvHeader();
+            outputEnabled = true;
+            break;
 
-            // Parse input
-            float weightGrams = atof(inputBuffer);
+        case 'k':
+        case 'K':
+            outputEnabled = false;
+            printCalibrationTables();
+            printCsvHeader();
+            outputEnabled = true;
+            break;
 
-            // Validate input
-            if (weightGrams <= 0) {
-                Serial.println(F("# ERROR: Invalid weight! Must be > 0"));
-                Serial.println(F("# Calibration aborted."));
-                Serial.println(F("# timestamp_ms,force_N"));
-                outputEnabled = true;
+        case 'e':
+        case 'E':
+            // Back to the build-flag factors; the tare is kept
+            if (calibrator.isBusy()) {
+                Serial.println(F("# Busy: calibration in progress ('x' cancels)"));
                 break;
             }
+            for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+                calibrationStore.erase(ch);
+                loadCell.setCalibrationFactor(ch, buildCalibrationFactors[ch]);
+            }
+            Serial.println(F("# Stored calibration erased, using build-flag factors"));
+            printCsvHeader();
+            break;
 
-            // Convert grams to Newtons
-            float weightNewtons = weightGrams * GRAMS_TO_NEWTONS;
+#ifdef ENABLE_BURN_CAPTURE
+        case 'b':
+        case 'B':
+            outputEnabled = false;
+            printCaptureStatus();
+            printCsvHeader();
+            outputEnabled = true;
+            break;
 
-            Serial.print(F("# Weight entered: "));
-            Serial.print(weightGrams, 1);
-            Serial.print(F(" g = "));
-            Serial.print(weightNewtons, 4);
-            Serial.println(F(" N"));
+        case 'g':
+        case 'G':
+            burnCapture.trigger();
+            break;
 
-            Serial.println(F("#"));
-            Serial.println(F("# Reading with weight (20 samples)..."));
-            delay(500);  // Allow sensor to settle
-            long rawWeight = loadCell.getAverageRawValue(20);
-            Serial.print(F("# Raw (with weight): "));
-            Serial.println(rawWeight);
-
-            long rawDiff = rawWeight - rawZero;
-            Serial.print(F("# Raw difference: "));
-            Serial.println(rawDiff);
-
-            // Check for valid difference
-            if (rawDiff == 0) {
-                Serial.println(F("# ERROR: No change detected!"));
-                Serial.println(F("# Check: Is weight actually on the sensor?"));
-                Serial.println(F("# Check: Are wires connected properly?"));
-                Serial.println(F("# Calibration aborted."));
-                Serial.println(F("# timestamp_ms,force_N"));
-                outputEnabled = true;
-                break;
-            }
+        case 'n':
+        case 'N':
+            burnCapture.arm();
+            Serial.println(F("# Burn capture re-armed"));
+            break;
 
-            // Handle inverted load cell (negative difference)
-            if (rawDiff < 0) {
-                Serial.println(F("# NOTE: Negative difference detected"));
-                Serial.println(F("# Load cell may be mounted inverted (compression mode)"));
-                Serial.println(F("# Using absolute value for calibration"));
-                rawDiff = -rawDiff;
+        case 'd':
+        case 'D':
+            outputEnabled = false;
+            dumpCapture();
+            printCsvHeader();
+            outputEnabled = true;
+            // A long dump blocks loop(): not a sampling fault
+            rateMonitor.reset(micros());
+            break;
+#endif
+
+#ifdef ENABLE_DUAL_RATE
+        case 'a':
+        case 'A':
+            if (calibrator.isBusy()) {
+                Serial.println(F("# Busy: calibration in progress ('x' cancels)"));
+            } else if (rateController.arm()) {
+                Serial.println(F("# ARMED: fast rate until the burn is over ('i' disarms)"));
+            } else if (rateController.getMode() == RATE_FIRING) {
+                Serial.println(F("# Already fast: burn in progress"));
             }
+            break;
 
-            // Calculate calibration factor
-            float newCalFactor = (float)rawDiff / weightNewtons;
+        case 'i':
+        case 'I':
+            rateController.disarm();
+            Serial.println(F("# Disarmed: slow rate"));
+            break;
+#endif
 
-            Serial.println(F("#"));
-            Serial.println(F("# === CALIBRATION RESULT ==="));
-            Serial.print(F("# New calibration factor: "));
-            Serial.println(newCalFactor, 3);
-            Serial.println(F("#"));
-            Serial.println(F("# To apply, update platformio.ini:"));
-            Serial.print(F("#   -D CALIBRATION_FACTOR="));
-            Serial.println(newCalFactor, 1);
-            Serial.println(F("#"));
-            Serial.println(F("# Or press 'a' now to apply temporarily"));
-            Serial.println(F("# (will reset on power cycle)"));
-
-            // Wait for response
-            unsigned long waitStart = millis();
-            bool applied = false;
-            while (millis() - waitStart < 5000) {  // 5 second timeout
-                if (Serial.available()) {
-                    char response = Serial.read();
-                    if (response == 'a' || response == 'A') {
-                        loadCell.setCalibrationFactor(newCalFactor);
-                        loadCell.tare(TARE_READINGS);
-                        Serial.println(F("# Calibration APPLIED and tared!"));
-                        Serial.print(F("# Active cal factor: "));
-                        Serial.println(loadCell.getCalibrationFactor(), 3);
-                        applied = true;
-                        break;
-                    } else if (response == '\r' || response == '\n') {
-                        break;
-                    }
-                }
-                delay(10);
-            }
+#ifdef ENABLE_TEENSY_UART
+        case 'u':
+        case 'U':
+            outputEnabled = false;
+            printTeensyLinkStats();
+            printCsvHeader();
+            outputEnabled = true;
+            break;
+#endif
 
-            if (!applied) {
-                Serial.println(F("# Calibration NOT applied (update platformio.ini manually)"));
-            }
+#if HX711_ACQ_TASK
+        case 's':
+        case 'S':
+            outputEnabled = false;
+            printTaskStats();
+            printCsvHeader();
+            outputEnabled = true;
+            break;
+#endif
 
-            Serial.println(F("# === END CALIBRATION ==="));
-            Serial.println(F("#"));
-            Serial.println(F("# timestamp_ms,force_N"));
+#ifdef ENABLE_THRUST_ANALYTICS
+        case 'l':
+        case 'L':
+            outputEnabled = false;
+            printBurnReport();
+            printCsvHeader();
             outputEnabled = true;
             break;
-        }
+#endif
+
+#ifdef ENABLE_FORCE_FILTER
+        case 'm':
+        case 'M':
+            if (standTest.isBusy()) {
+                standTest.cancel();
+                Serial.println(F("# Stand test cancelled"));
+            } else if (calibrator.isBusy()) {
+                Serial.println(F("# Busy: calibration in progress ('x' cancels)"));
+            } else {
+                startStandTest();
+            }
+            break;
+
+        case 'f':
+        case 'F':
+            printFilterStatus();
+            Serial.println(F("# Enter new chain (e.g. median=5,lowpass=20,avg=4 or off),"));
+            Serial.println(F("# or ENTER to keep:"));
+            serialPrompt = PROMPT_FILTER_SPEC;
+            break;
+#endif
 
         case 'h':
         case 'H':
         case '?':
             outputEnabled = false;
             printHelp();
-            Serial.println(F("# timestamp_ms,force_N"));
+            printCsvHeader();
             outputEnabled = true;
             break;
 
@@ -354,6 +836,549 @@ void handleSerialCommands() {
     }
 }
 
+// Collects one line without waiting; true once ENTER completes it
+bool readSerialLine() {
+    while (Serial.available()) {
+        char c = Serial.read();
+        char last = serialLastChar;
+        serialLastChar = c;
+
+        if (c == '\r' || c == '\n') {
+            // CRLF counts once; an ending sent with the command key is not
+            // an answer
+            if (c == '\n' && last == '\r') continue;
+            if (serialLineLength == 0 && millis() - serialCommandMs < SERIAL_LINE_GUARD_MS) continue;
+
+            Serial.println();
+            serialLine[serialLineLength] = '\0';
+            serialLineLength = 0;
+            return true;
+        }
+        if (serialLineLength < SERIAL_LINE_SIZE - 1) {
+            serialLine[serialLineLength++] = c;
+            Serial.print(c);  // Echo character
+        }
+    }
+    return false;
+}
+
+void handleSerialLine(const char* line) {
+    SerialPrompt prompt = serialPrompt;
+    serialPrompt = PROMPT_NONE;
+
+    switch (prompt) {
+        case PROMPT_CAL_CHANNEL: {
+            uint8_t channel = line[0] - '0';
+            if (line[0] == '\0' || line[1] != '\0' || !calibrator.startCalibration(channel)) {
+                Serial.println(F("# ERROR: Invalid channel"));
+                Serial.println(F("# Calibration aborted."));
+                printCsvHeader();
+            }
+            return;
+        }
+
+#ifdef ENABLE_FORCE_FILTER
+        case PROMPT_FILTER_SPEC:
+            if (line[0] != '\0') {
+                if (configureFilter(line)) {
+                    printFilterStatus();
+                } else {
+                    Serial.println(F("# ERROR: Invalid filter spec, chain unchanged"));
+                }
+            }
+            printCsvHeader();
+            return;
+#endif
+
+        default:
+            break;
+    }
+
+    // Calibration step: 'x' cancels at any point
+    if (line[0] == 'x' || line[0] == 'X') {
+        calibrator.cancel();
+        return;
+    }
+
+    switch (calibrator.getState()) {
+        case CAL_ZERO_WAIT:
+            calibrator.confirmZero();
+            Serial.println(F("# Reading zero point..."));
+            break;
+
+        case CAL_RESULT:
+            // 'a' applies, another weight adds a point, ENTER discards
+            if (line[0] == 'a' || line[0] == 'A') {
+                calibrator.apply();
+                break;
+            }
+            if (atof(line) <= 0.0f) {
+                calibrator.cancel();
+                break;
+            }
+            // fall through
+        case CAL_WEIGHT_WAIT:
+            if (!calibrator.setWeight(atof(line))) {
+                Serial.println(F("# ERROR: Invalid weight! Must be > 0"));
+                Serial.println(F("# Enter the weight in GRAMS ('x' cancels):"));
+                break;
+            }
+            Serial.print(F("# Weight entered: "));
+            Serial.print(calibrator.getWeightGrams(), 1);
+            Serial.print(F(" g = "));
+            Serial.print(calibrator.getWeightGrams() * GRAMS_TO_NEWTONS, 4);
+            Serial.println(F(" N"));
+            Serial.println(F("# Reading with weight..."));
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Reports every tare/calibration step on serial and the dashboard, whichever
+// side started it
+void onCalibrationEvent(const LoadCellCalibrator& cal, CalibrationEvent event) {
+    char message[96];
+    float factor = 0.0f;
+
+    switch (event) {
+        case CAL_EVENT_STARTED:
+            snprintf(message, sizeof(message), "Channel %u: remove all weight from load cell",
+                     cal.getChannel());
+            break;
+        case CAL_EVENT_TARE_DONE:
+            snprintf(message, sizeof(message), "Tare complete.");
+            break;
+        case CAL_EVENT_ZERO_DONE:
+            snprintf(message, sizeof(message), "Raw (no weight): %ld. Place known weight, enter grams",
+                     cal.getRawZero());
+            break;
+        case CAL_EVENT_RESULT:
+            factor = cal.getResultFactor();
+            snprintf(message, sizeof(message), "Point %u: factor %.3f (raw %ld -> %ld%s)",
+                     cal.getPointCount(), factor, cal.getRawZero(), cal.getRawWeight(),
+                     cal.isInverted() ? ", inverted" : "");
+            break;
+        case CAL_EVENT_NO_CHANGE:
+            snprintf(message, sizeof(message), "No change detected! Is the weight on the sensor? %s",
+                     cal.isBusy() ? "Point dropped." : "Aborted.");
+            break;
+        case CAL_EVENT_REJECTED:
+            snprintf(message, sizeof(message), "Point rejected: force must rise with raw counts (max %u points).",
+                     CAL_TABLE_MAX_POINTS);
+            break;
+        case CAL_EVENT_APPLIED: {
+            // Kept across power cycles; a failed NVS write leaves it RAM-only
+            bool saved = calibrationStore.save(cal.getChannel(), loadCell.getCalibrationTable(cal.getChannel()));
+            factor = loadCell.getCalibrationFactor(cal.getChannel());
+            snprintf(message, sizeof(message), "Calibration APPLIED (%u point%s, %s): factor %.3f, zero %ld",
+                     cal.getPointCount(), cal.getPointCount() == 1 ? "" : "s",
+                     saved ? "saved" : "NOT saved", factor, cal.getRawZero());
+            break;
+        }
+        case CAL_EVENT_CANCELLED:
+            snprintf(message, sizeof(message), "Calibration NOT applied.");
+            break;
+        case CAL_EVENT_TIMEOUT:
+            snprintf(message, sizeof(message), "Calibration timed out.");
+            break;
+        default:
+            message[0] = '\0';
+            break;
+    }
+
+    Serial.print(F("# "));
+    Serial.println(message);
+
+    // Serial-only instructions for the next step
+    switch (event) {
+        case CAL_EVENT_STARTED:
+            Serial.println(F("# Press ENTER when ready ('x' cancels)..."));
+            break;
+        case CAL_EVENT_ZERO_DONE:
+            Serial.println(F("# Enter the weight in GRAMS (e.g., 500 or 1000):"));
+            break;
+        case CAL_EVENT_RESULT:
+            if (cal.isInverted()) {
+                Serial.println(F("# NOTE: Negative difference, load cell may be mounted inverted"));
+            }
+            if (cal.getPointCount() == 1) {
+                Serial.println(F("# As a build flag (platformio.ini):"));
+                if (LOADCELL_CHANNELS > 1) {
+                    Serial.print(F("#   LOADCELL_CAL_FACTORS entry "));
+                    Serial.print(cal.getChannel());
+                    Serial.print(F(": "));
+                } else {
+                    Serial.print(F("#   -D CALIBRATION_FACTOR="));
+                }
+                Serial.println(factor, 1);
+            }
+            // fall through
+        case CAL_EVENT_NO_CHANGE:
+        case CAL_EVENT_REJECTED:
+            if (cal.getState() == CAL_RESULT) {
+                Serial.println(F("# 'a' + ENTER applies and saves to NVS, another weight in GRAMS"));
+                Serial.println(F("# adds a point, ENTER discards"));
+            }
+            break;
+        default:
+            break;
+    }
+
+    // Tare and apply move the zero: restart the filter, the burn detection
+    // and the timestamps
+    if (event == CAL_EVENT_TARE_DONE || event == CAL_EVENT_APPLIED) {
+#ifdef ENABLE_FORCE_FILTER
+        forceFilter.reset();
+#endif
+#ifdef ENABLE_THRUST_ANALYTICS
+        thrustAnalytics.reset();
+#endif
+#ifdef ENABLE_OUTPUT_QOS
+        bool wasBurn = outputQos.isBurn();
+        outputQos.reset();
+        if (wasBurn) onOutputModeChange();
+#endif
+        startTime = millis();
+    }
+
+#ifdef ENABLE_WEB_DASHBOARD
+    dashboard.sendCalibrationStatus(cal.getStateName(), message, factor);
+#endif
+
+    if (!cal.isBusy() && outputEnabled) {
+        printCsvHeader();
+    }
+}
+
+void postNotice(uint8_t notice) {
+#ifdef ENABLE_OUTPUT_QOS
+    if (outputQos.isBurn()) {
+        pendingNotices |= notice;
+        return;
+    }
+#endif
+    printNotices(notice);
+}
+
+void printNotices(uint8_t notices) {
+    if (notices & NOTICE_SAMPLE_RATE) {
+        checkSampleRate();
+    }
+#ifdef ENABLE_BURN_CAPTURE
+    if (notices & NOTICE_CAPTURE) {
+        reportCaptureState();
+    }
+#endif
+#ifdef ENABLE_THRUST_ANALYTICS
+    if (notices & NOTICE_BURN_REPORT) {
+        printBurnReport();
+    }
+#endif
+    if (notices & NOTICE_RAW_REPORT) {
+        printRawReport();
+    }
+}
+
+void startRawReport() {
+    rawReportPending = true;
+    rawReportCount = 0;
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        rawReportSums[ch] = 0;
+    }
+}
+
+void recordRawReport(const ThrustData& data) {
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        if (rawReportCount == 0) {
+            rawReportFirst[ch] = data.channelRaw[ch];
+        }
+        rawReportSums[ch] += data.channelRaw[ch];
+    }
+    if (++rawReportCount < RAW_REPORT_READINGS) return;
+    rawReportPending = false;
+    postNotice(NOTICE_RAW_REPORT);
+}
+
+void printRawReport() {
+    Serial.println(F("# --- Raw ADC Reading ---"));
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        if (LOADCELL_CHANNELS > 1) {
+            Serial.print(F("# Channel "));
+            Serial.println(ch);
+        }
+        Serial.print(F("# Raw Value: "));
+        Serial.println(rawReportFirst[ch]);
+        Serial.print(F("# Avg Raw ("));
+        Serial.print(RAW_REPORT_READINGS);
+        Serial.print(F("): "));
+        Serial.println(rawReportSums[ch] / RAW_REPORT_READINGS);
+    }
+#if LOADCELL_ADC == LOADCELL_ADC_HX711
+    HX711ReadCost cost = loadCell.adc().getReadCost();
+    Serial.print(F("# Read cost: "));
+    Serial.print(cost.avgUs, 1);
+    Serial.print(F(" us avg, "));
+    Serial.print(cost.maxUs, 1);
+    Serial.print(F(" us max, IRQs masked "));
+    Serial.print(cost.maxMaskedUs, 2);
+    Serial.print(F(" us max ("));
+    Serial.print(cost.reads);
+    Serial.println(F(" reads)"));
+#endif
+    if (outputEnabled) {
+        printCsvHeader();
+    }
+}
+
+#ifdef ENABLE_OUTPUT_QOS
+void onOutputModeChange() {
+#ifdef ENABLE_WEB_DASHBOARD
+    dashboard.setStreamMode(outputQos.isBurn() ? STREAM_BURN : STREAM_IDLE);
+#endif
+    if (outputQos.isBurn()) return;
+
+    // Back to idle: the burn summary, then whatever waited for it
+    Serial.print(F("# Burn over ("));
+    Serial.print(outputQos.getLastBurnS(), 2);
+    Serial.println(F(" s above threshold), output back to idle"));
+    uint8_t notices = pendingNotices;
+    pendingNotices = 0;
+    printNotices(notices);
+}
+#endif
+
+#ifdef ENABLE_DUAL_RATE
+// Everything paced by the sample rate follows a switch. Frames from before
+// the ADC settled never reach loop()
+void onRateEvent(const DualRateController& controller, DualRateEvent event) {
+    switch (event) {
+        case RATE_EVENT_FAST:
+        case RATE_EVENT_SLOW: {
+            float hz = loadCell.getSampleRate();
+            rateMonitor.begin(hz);
+            rateMonitor.reset(micros());
+            rateWarned = false;
+#ifdef ENABLE_FORCE_FILTER
+            forceFilter.setSampleRate(hz);
+#endif
+#ifdef ENABLE_OUTPUT_QOS
+            outputQos.setSampleRate(hz);
+#endif
+            Serial.print(F("# Rate: "));
+            Serial.print(hz, 0);
+            Serial.print(F(" SPS ("));
+            Serial.print(controller.getModeName());
+            Serial.println(F(")"));
+            break;
+        }
+
+        case RATE_EVENT_SHIFT_LEARNED:
+            Serial.print(F("# Rate zero shift (counts):"));
+            for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+                Serial.print(' ');
+                Serial.print(loadCell.getRateShift(ch));
+            }
+            Serial.println();
+            break;
+
+        case RATE_EVENT_SHIFT_REJECTED:
+            Serial.println(F("# Rate zero shift not measured (load moved), previous kept"));
+            break;
+
+        case RATE_EVENT_FAILED:
+            Serial.println(F("# ERROR: ADC rate did not change"));
+            break;
+    }
+}
+#endif
+
+// Measures one window before any output, so a slow ADC is obvious at boot
+void checkBootSampleRate() {
+    rateMonitor.begin(loadCell.getSampleRate());
+
+    ThrustData data;
+    unsigned long start = millis();
+    while (rateMonitor.getStats().windows == 0 && millis() - start < SAMPLE_RATE_BOOT_CHECK_MS) {
+        if (loadCell.readIfReady(data) && data.valid) {
+            rateMonitor.record(data.timestampUs);
+        }
+    }
+
+    const SampleRateStats& stats = rateMonitor.getStats();
+    if (stats.windows == 0) {
+        Serial.print(F("# WARNING: only "));
+        Serial.print(stats.samples);
+        Serial.println(F(" samples in the sample rate check"));
+        warnLowSampleRate();
+        return;
+    }
+
+    Serial.print(F("# Sample rate: "));
+    Serial.print(stats.rateHz, 1);
+    Serial.print(F(" SPS (nominal "));
+    Serial.print(stats.nominalHz, 0);
+    Serial.print(F("), jitter "));
+    Serial.print(stats.jitterUs, 0);
+    Serial.println(F(" us"));
+    checkSampleRate();
+}
+
+// Warns once per drop below SAMPLE_RATE_WARN_FRACTION of nominal
+void checkSampleRate() {
+    const SampleRateStats& stats = rateMonitor.getStats();
+    bool low = stats.rateHz < stats.nominalHz * SAMPLE_RATE_WARN_FRACTION;
+
+    if (low && !rateWarned) {
+        rateWarned = true;
+        warnLowSampleRate();
+    } else if (!low && rateWarned) {
+        rateWarned = false;
+        Serial.print(F("# Sample rate recovered: "));
+        Serial.print(stats.rateHz, 1);
+        Serial.println(F(" SPS"));
+    }
+}
+
+void warnLowSampleRate() {
+    const SampleRateStats& stats = rateMonitor.getStats();
+    Serial.println(F("# !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!"));
+    Serial.print(F("# !!! WARNING: sample rate "));
+    Serial.print(stats.rateHz, 1);
+    Serial.print(F(" SPS, expected "));
+    Serial.print(stats.nominalHz, 0);
+    Serial.println(F(" SPS"));
+#if LOADCELL_ADC == LOADCELL_ADC_HX711 && defined(ENABLE_DUAL_RATE)
+    if (stats.nominalHz > DUAL_RATE_SLOW_SPS) {
+        Serial.print(F("# !!! Is GPIO"));
+        Serial.print(HX711_RATE_PIN);
+        Serial.println(F(" wired to the HX711 RATE pin? ~10 SPS means it is not"));
+    }
+#elif LOADCELL_ADC == LOADCELL_ADC_HX711
+    if (HX711_80HZ_MODE) {
+        Serial.println(F("# !!! Is the HX711 RATE pin HIGH (80 Hz)? ~10 SPS means it is not"));
+    }
+#endif
+    Serial.println(F("# !!! Otherwise something blocks loop(); 'j' shows the intervals"));
+    Serial.println(F("# !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!"));
+}
+
+void printSampleRateReport() {
+    const SampleRateStats& stats = rateMonitor.getStats();
+    Serial.println(F("# === Sample Rate ==="));
+    Serial.print(F("# Nominal:     "));
+    Serial.print(stats.nominalHz, 1);
+    Serial.println(F(" SPS"));
+    Serial.print(F("# Measured:    "));
+    Serial.print(stats.rateHz, 2);
+    Serial.print(F(" SPS (last window), "));
+    Serial.print(stats.averageRateHz, 2);
+    Serial.println(F(" SPS average"));
+    Serial.print(F("# Interval:    "));
+    Serial.print(stats.meanIntervalUs, 0);
+    Serial.print(F(" us mean, "));
+    Serial.print(stats.jitterUs, 1);
+    Serial.print(F(" us jitter (SD), "));
+    Serial.print(stats.minIntervalUs);
+    Serial.print(F("-"));
+    Serial.print(stats.maxIntervalUs);
+    Serial.println(F(" us"));
+    Serial.print(F("# Missed DRDY: "));
+    Serial.print(stats.missed);
+    Serial.print(F(" over "));
+    Serial.print(stats.samples);
+    Serial.print(F(" samples, queue drops "));
+    Serial.println(loadCell.getQueueDrops());
+
+    // Non-empty bins, bar scaled to the largest
+    uint32_t largest = 1;
+    for (uint8_t bin = 0; bin < SAMPLE_RATE_HIST_BINS; bin++) {
+        if (rateMonitor.getHistogram(bin) > largest) largest = rateMonitor.getHistogram(bin);
+    }
+    float binUs = rateMonitor.getBinWidthUs();
+    Serial.println(F("# Intervals:"));
+    for (uint8_t bin = 0; bin < SAMPLE_RATE_HIST_BINS; bin++) {
+        uint32_t count = rateMonitor.getHistogram(bin);
+        if (count == 0) continue;
+
+        char line[48];
+        if (bin == SAMPLE_RATE_HIST_BINS - 1) {
+            snprintf(line, sizeof(line), "#   >= %6.0f us %8lu ", bin * binUs, (unsigned long)count);
+        } else {
+            snprintf(line, sizeof(line), "#   %6.0f us  %8lu ", bin * binUs, (unsigned long)count);
+        }
+        Serial.print(line);
+        for (uint32_t i = 0; i < (uint64_t)count * 30 / largest; i++) {
+            Serial.print('#');
+        }
+        Serial.println();
+    }
+}
+
+void loadStoredCalibration() {
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        CalibrationTable table;
+        if (!calibrationStore.load(ch, table)) continue;
+
+        loadCell.setCalibrationTable(ch, table);
+        Serial.print(F("# Channel "));
+        Serial.print(ch);
+        Serial.print(F(": stored "));
+        Serial.print(table.getPointCount());
+        Serial.print(F("-point calibration (factor "));
+        Serial.print(table.getFactor(), 3);
+        Serial.println(F(")"));
+    }
+}
+
+void printCalibrationTables() {
+    Serial.println(F("# === Calibration ==="));
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        const CalibrationTable& table = loadCell.getCalibrationTable(ch);
+        Serial.print(F("# Channel "));
+        Serial.print(ch);
+        Serial.print(F(": zero "));
+        Serial.print(loadCell.getTareOffset(ch));
+        if (table.isLinear()) {
+            Serial.print(F(", factor "));
+            Serial.print(table.getFactor(), 3);
+            Serial.println(F(" (build flag)"));
+            continue;
+        }
+        Serial.print(F(", "));
+        Serial.print(table.getPointCount());
+        Serial.println(F(" points:"));
+        for (uint8_t i = 0; i < table.getPointCount(); i++) {
+            const CalibrationPoint& point = table.getPoint(i);
+            Serial.print(F("#   "));
+            Serial.print(point.counts);
+            Serial.print(F(" counts = "));
+            Serial.print(point.forceN, 4);
+            Serial.print(F(" N ("));
+            Serial.print(point.counts / point.forceN, 3);
+            Serial.println(F(" counts/N)"));
+        }
+    }
+}
+
+void printCsvHeader() {
+    Serial.print(F("# timestamp_ms,force_N"));
+#ifdef ENABLE_FORCE_FILTER
+    // force_N is filtered, raw_N is the same sample before the filter
+    Serial.print(F(",raw_N"));
+#endif
+#if LOADCELL_CHANNELS > 1
+    // Axial sum first, then each channel of the same frame
+    for (uint8_t ch = 0; ch < LOADCELL_CHANNELS; ch++) {
+        Serial.print(F(",ch"));
+        Serial.print(ch);
+        Serial.print(F("_N"));
+    }
+#endif
+    Serial.println();
+}
+
 void printHelp() {
     Serial.println(F("# === Commands ==="));
     Serial.println(F("# t - Tare (zero) the sensor"));
@@ -361,5 +1386,393 @@ void printHelp() {
     Serial.println(F("# p - Pause/resume output"));
     Serial.println(F("# z - Zero timestamp"));
     Serial.println(F("# c - Calibration mode (input weight in grams)"));
+    Serial.println(F("# x - Cancel tare/calibration"));
+    Serial.println(F("# j - Show sample rate/jitter report"));
+    Serial.println(F("# k - Show calibration tables"));
+    Serial.println(F("# e - Erase stored calibration (use build flags)"));
+#ifdef ENABLE_BURN_CAPTURE
+    Serial.println(F("# b - Show burn capture status"));
+    Serial.println(F("# g - Trigger burn capture now"));
+    Serial.println(F("# n - Re-arm burn capture"));
+    Serial.println(F("# d - Dump captured burn as CSV"));
+#endif
+#ifdef ENABLE_DUAL_RATE
+    Serial.println(F("# a - Arm: fast sample rate until the burn is over"));
+    Serial.println(F("# i - Disarm: back to the slow sample rate"));
+#endif
+#ifdef ENABLE_THRUST_ANALYTICS
+    Serial.println(F("# l - Show the last burn report"));
+#endif
+#ifdef ENABLE_TEENSY_UART
+    Serial.println(F("# u - Show Teensy UART link stats"));
+#endif
+#if HX711_ACQ_TASK
+    Serial.println(F("# s - Show acquisition task CPU/stack report"));
+#endif
+#ifdef ENABLE_FORCE_FILTER
+    Serial.println(F("# f - Show/change force filter chain"));
+    Serial.println(F("# m - Stand test: measure ringing, add compensation"));
+#endif
     Serial.println(F("# h - Show this help"));
 }
+
+#ifdef ENABLE_BURN_CAPTURE
+void startBurnCapture() {
+    // Whatever the heap can spare above the reserve, up to the configured size
+    uint32_t freeHeap = ESP.getFreeHeap();
+    uint32_t fits = freeHeap > CAPTURE_HEAP_RESERVE
+        ? (freeHeap - CAPTURE_HEAP_RESERVE) / sizeof(CaptureSample) : 0;
+    uint32_t samples = fits < CAPTURE_BUFFER_SAMPLES ? fits : CAPTURE_BUFFER_SAMPLES;
+
+    burnCapture.configure(CAPTURE_TRIGGER_N, CAPTURE_PRETRIGGER_MS, CAPTURE_POSTTRIGGER_MS);
+    if (burnCapture.begin(samples) == 0) {
+        Serial.println(F("# Burn capture: buffer allocation FAILED, capture disabled"));
+        return;
+    }
+
+    Serial.print(F("# Burn capture: armed, "));
+    Serial.print(burnCapture.getCapacity());
+    Serial.print(F(" samples ("));
+    Serial.print(burnCapture.getCapacity() / loadCell.getSampleRate(), 1);
+    Serial.print(F(" s), trigger "));
+    Serial.print(burnCapture.getTriggerN(), 1);
+    Serial.println(F(" N"));
+}
+
+void reportCaptureState() {
+    switch (burnCapture.getState()) {
+        case CAPTURE_ARMED:
+            Serial.println(F("# Burn capture: armed"));
+            break;
+        case CAPTURE_TRIGGERED:
+            Serial.print(F("# Burn capture: TRIGGERED ("));
+            Serial.print(burnCapture.getTriggerSource() == CAPTURE_TRIGGER_COMMAND ? F("command") : F("force"));
+            Serial.println(F(")"));
+            break;
+        case CAPTURE_COMPLETE:
+            Serial.print(F("# Burn capture: COMPLETE, "));
+            Serial.print(burnCapture.getSampleCount());
+            Serial.print(F(" samples, "));
+            Serial.print(burnCapture.getDurationS(), 2);
+            Serial.print(F(" s, peak "));
+            Serial.print(burnCapture.getPeakN(), 3);
+            Serial.print(F(" N"));
+            if (burnCapture.isTruncated()) {
+                Serial.print(F(" (TRUNCATED: buffer full)"));
+            }
+            Serial.println();
+            Serial.println(F("# 'd' dumps it (or /api/capture.csv), 'n' re-arms"));
+            break;
+        default:
+            break;
+    }
+}
+
+void printCaptureStatus() {
+    Serial.println(F("# === Burn Capture ==="));
+    Serial.print(F("# State:    "));
+    Serial.println(burnCapture.getStateName());
+    Serial.print(F("# Buffer:   "));
+    Serial.print(burnCapture.getCapacity());
+    Serial.print(F(" samples ("));
+    Serial.print(burnCapture.getCapacity() / loadCell.getSampleRate(), 1);
+    Serial.println(F(" s)"));
+    Serial.print(F("# Trigger:  "));
+    Serial.print(burnCapture.getTriggerN(), 2);
+    Serial.print(F(" N, pre "));
+    Serial.print(burnCapture.getPreTriggerMs());
+    Serial.print(F(" ms, post "));
+    Serial.print(burnCapture.getPostTriggerMs());
+    Serial.println(F(" ms"));
+    if (burnCapture.getState() == CAPTURE_TRIGGERED || burnCapture.getState() == CAPTURE_COMPLETE) {
+        Serial.print(F("# Captured: "));
+        Serial.print(burnCapture.getSampleCount());
+        Serial.print(F(" samples ("));
+        Serial.print(burnCapture.getPreTriggerSamples());
+        Serial.print(F(" pre-trigger), "));
+        Serial.print(burnCapture.getDurationS(), 2);
+        Serial.print(F(" s, peak "));
+        Serial.print(burnCapture.getPeakN(), 3);
+        Serial.println(burnCapture.isTruncated() ? F(" N, truncated") : F(" N"));
+    }
+}
+
+void dumpCapture() {
+    if (burnCapture.getState() != CAPTURE_COMPLETE) {
+        Serial.print(F("# No completed capture (state "));
+        Serial.print(burnCapture.getStateName());
+        Serial.println(F(")"));
+        return;
+    }
+
+    // Rows go out between CSV markers; the live output is paused meanwhile
+    Serial.println(F("# --- Capture CSV start ---"));
+    char buffer[256];
+    uint32_t line = 0;
+    size_t length;
+    while ((length = burnCapture.formatCsv(buffer, sizeof(buffer), &line)) > 0) {
+        Serial.write((const uint8_t*)buffer, length);
+    }
+    Serial.println(F("# --- Capture CSV end ---"));
+}
+
+// Chunk filler for /api/capture.csv, on the AsyncTCP task. One download at
+// a time: the line cursor restarts with each response. A re-arm waits for
+// the download to finish
+size_t captureDownload(uint8_t* buffer, size_t maxLen, size_t index) {
+    static uint32_t line = 0;
+    if (index == 0) line = 0;
+    return burnCapture.readCsv((char*)buffer, maxLen, &line, micros());
+}
+#endif
+
+#ifdef ENABLE_TEENSY_UART
+void printTeensyLinkStats() {
+    const TeensyUartStats& stats = teensyUart.getStats();
+    Serial.println(F("# === Teensy UART Link ==="));
+    Serial.print(F("# Frames sent:    "));
+    Serial.println(stats.framesSent);
+    Serial.print(F("# Batches sent:   "));
+    Serial.println(stats.batchesSent);
+    Serial.print(F("# Retransmits:    "));
+    Serial.println(stats.retransmits);
+    Serial.print(F("# ACKs received:  "));
+    Serial.println(stats.acksReceived);
+    Serial.print(F("# ACK errors:     "));
+    Serial.println(stats.ackErrors);
+    Serial.print(F("# Unrecoverable:  "));
+    Serial.println(stats.unrecoverable);
+    Serial.print(F("# Held lost:      "));
+    Serial.println(stats.heldLost);
+    Serial.print(F("# Acked sequence: "));
+    Serial.println(stats.ackedSequence);
+    Serial.print(F("# Baud:           "));
+    Serial.print(teensyUart.getBaud());
+    Serial.println(teensyUart.isLinkReady() ? "" : " (negotiating)");
+    Serial.print(F("# Baud commits:   "));
+    Serial.println(stats.baudCommits);
+    Serial.print(F("# Baud fallbacks: "));
+    Serial.println(stats.baudFallbacks);
+    Serial.print(F("# TX dropped:     "));
+    Serial.println(stats.txDropped);
+    Serial.print(F("# TX discarded:   "));
+    Serial.println(stats.txDiscarded);
+    Serial.print(F("# TX queued:      "));
+    Serial.print(stats.txQueued);
+    Serial.print(F(" bytes (peak "));
+    Serial.print(stats.txQueueHighWater);
+    Serial.println(F(")"));
+}
+#endif
+
+#if HX711_ACQ_TASK
+void printTaskStats() {
+    LoadCellTaskStats stats = loadCell.getTaskStats();
+    Serial.println(F("# === Tasks ==="));
+    if (!loadCell.isTaskRunning()) {
+        Serial.println(F("# Acquisition task not running"));
+        return;
+    }
+    Serial.print(F("# hx711: core "));
+    Serial.print(stats.core);
+    Serial.print(F(", priority "));
+    Serial.print(stats.priority);
+    Serial.print(F(", CPU "));
+    Serial.print(stats.cpuPercent, 2);
+    Serial.print(F("%, stack free "));
+    Serial.print(stats.stackFreeBytes);
+    Serial.println(F(" B"));
+    Serial.print(F("#   Max DRDY latency: "));
+    Serial.print(stats.maxLatencyUs);
+    Serial.println(F(" us"));
+    Serial.print(F("#   Queue: "));
+    Serial.print(stats.queued);
+    Serial.print(F(" waiting, "));
+    Serial.print(stats.queueDrops);
+    Serial.println(F(" dropped"));
+    Serial.print(F("# loop:  core "));
+    Serial.print(xPortGetCoreID());
+    Serial.print(F(", stack free "));
+    Serial.print(uxTaskGetStackHighWaterMark(NULL));
+    Serial.println(F(" B"));
+}
+#endif
+
+#ifdef ENABLE_FORCE_FILTER
+// With ENABLE_DUAL_RATE a spec is checked at the fast rate; at the slow
+// one a low-pass above its Nyquist frequency passes samples through
+bool configureFilter(const char* spec) {
+#ifdef ENABLE_DUAL_RATE
+    if (!forceFilter.configure(spec, DUAL_RATE_FAST_SPS)) return false;
+    forceFilter.setSampleRate(loadCell.getSampleRate());
+#else
+    if (!forceFilter.configure(spec, loadCell.getSampleRate())) return false;
+#endif
+    filterSamples = 0;
+    filterTotalCycles = 0;
+    filterMaxCycles = 0;
+    filterBudgetWarned = false;
+    return true;
+}
+
+float filterForce(float forceNewtons) {
+    uint32_t start = ESP.getCycleCount();
+    float filtered = forceFilter.process(forceNewtons);
+    uint32_t cycles = ESP.getCycleCount() - start;
+
+    filterSamples++;
+    filterTotalCycles += cycles;
+    if (cycles > filterMaxCycles) filterMaxCycles = cycles;
+
+    if (!filterBudgetWarned && cycles > FORCE_FILTER_BUDGET_US * getCpuFrequencyMhz()) {
+        filterBudgetWarned = true;
+        Serial.print(F("# WARNING: force filter took "));
+        Serial.print((float)cycles / getCpuFrequencyMhz(), 1);
+        Serial.print(F(" us (budget "));
+        Serial.print(FORCE_FILTER_BUDGET_US);
+        Serial.println(F(" us)"));
+    }
+    return filtered;
+}
+
+void printFilterStatus() {
+    char spec[64];
+    forceFilter.describe(spec, sizeof(spec));
+    float cyclesPerUs = getCpuFrequencyMhz();
+
+    Serial.println(F("# === Force Filter ==="));
+    Serial.print(F("# Chain:  "));
+    Serial.println(spec);
+    Serial.print(F("# Cost:   "));
+    Serial.print(filterSamples ? filterTotalCycles / (float)filterSamples / cyclesPerUs : 0.0f, 2);
+    Serial.print(F(" us avg, "));
+    Serial.print(filterMaxCycles / cyclesPerUs, 2);
+    Serial.print(F(" us max ("));
+    Serial.print(filterSamples);
+    Serial.print(F(" samples, budget "));
+    Serial.print(FORCE_FILTER_BUDGET_US);
+    Serial.println(F(" us)"));
+}
+#endif
+
+#ifdef ENABLE_FORCE_FILTER
+void startStandTest() {
+    uint32_t window = (uint32_t)(loadCell.getSampleRate() * STAND_ID_WINDOW_MS / 1000.0f);
+    standTest.start(loadCell.getSampleRate(), STAND_ID_TRIGGER_N, window);
+    standTestStartMs = millis();
+
+    Serial.println(F("# === STAND TEST ==="));
+    Serial.print(F("# Tap the stand in the thrust direction, or put on or take off a"));
+    Serial.println(F(" weight"));
+    Serial.print(F("# (trigger "));
+    Serial.print(STAND_ID_TRIGGER_N, 1);
+    Serial.print(F(" N, "));
+    Serial.print(min(window, (uint32_t)STAND_ID_MAX_SAMPLES) / loadCell.getSampleRate(), 2);
+    Serial.println(F(" s recorded; 'm' cancels)"));
+}
+
+// The result goes at the head of the chain, replacing an older comp stage
+void onStandTestUpdate() {
+    if (standTest.getState() == STAND_ID_RECORDING) {
+        Serial.println(F("# Stand test: recording..."));
+        return;
+    }
+
+    const StandDynamics& result = standTest.getResult();
+    if (standTest.getState() == STAND_ID_FAILED) {
+        Serial.print(F("# Stand test failed: "));
+        Serial.print(StandIdentifier::errorName(result.error));
+        Serial.print(F(" ("));
+        Serial.print(result.peaks);
+        Serial.println(F(" peaks)"));
+        return;
+    }
+
+    Serial.print(F("# Stand: natural frequency "));
+    Serial.print(result.naturalHz, 2);
+    Serial.print(F(" Hz, damping ratio "));
+    Serial.print(result.dampingRatio, 4);
+    Serial.print(F(" ("));
+    Serial.print(result.peaks);
+    Serial.println(F(" peaks)"));
+
+    char chain[64];
+    forceFilter.describe(chain, sizeof(chain));
+    char spec[64];
+    int used = snprintf(spec, sizeof(spec), "comp=%.2f/%.4f", result.naturalHz, result.dampingRatio);
+    char* save = nullptr;
+    for (char* stage = strtok_r(chain, ",", &save); stage; stage = strtok_r(nullptr, ",", &save)) {
+        if (strncmp(stage, "comp=", 5) == 0 || strcmp(stage, "off") == 0) continue;
+        used += snprintf(spec + used, sizeof(spec) - used, ",%s", stage);
+        if (used >= (int)sizeof(spec)) break;
+    }
+
+    if (used < (int)sizeof(spec) && configureFilter(spec)) {
+        printFilterStatus();
+        Serial.print(F("# Add to FORCE_FILTER_SPEC to keep: "));
+        Serial.println(spec);
+    } else {
+        Serial.print(F("# Chain unchanged (full, or not valid at this rate); try 'f' with: "));
+        Serial.println(spec);
+    }
+}
+#endif
+
+#ifdef ENABLE_THRUST_ANALYTICS
+void printBurnReport() {
+    const BurnReport& r = thrustAnalytics.getReport();
+    if (r.number == 0) {
+        Serial.println(F("# No burn analysed yet"));
+        return;
+    }
+
+    char designation[16];
+    thrustAnalytics.getDesignation(designation, sizeof(designation));
+    Serial.print(F("# === Burn "));
+    Serial.print(r.number);
+    Serial.print(F(": "));
+    Serial.print(designation);
+    Serial.println(F(" ==="));
+    Serial.print(F("# Burn time:    "));
+    Serial.print(r.burnTimeS, 3);
+    Serial.print(F(" s, impulse "));
+    Serial.print(r.impulseNs, 2);
+    Serial.print(F(" N*s (class "));
+    Serial.print(r.impulseClass);
+    Serial.print(F("), average "));
+    Serial.print(r.averageN, 2);
+    Serial.println(F(" N"));
+    Serial.print(F("# Peak:         "));
+    Serial.print(r.peakN, 2);
+    Serial.print(F(" N at "));
+    Serial.print(r.timeToPeakS, 3);
+    Serial.println(F(" s"));
+    Serial.print(F("# Rise 10-90%:  "));
+    Serial.print(r.riseS, 3);
+    Serial.print(F(" s, tail-off 90-10% "));
+    Serial.print(r.tailOffS, 3);
+    Serial.println(F(" s"));
+    Serial.print(F("# Action time:  "));
+    Serial.print(r.actionTimeS, 3);
+    Serial.print(F(" s, impulse "));
+    Serial.print(r.actionImpulseNs, 2);
+    Serial.print(F(" N*s, average "));
+    Serial.print(r.actionAverageN, 2);
+    Serial.println(F(" N"));
+    Serial.print(F("# Thrust:       median "));
+    Serial.print(r.medianN, 2);
+    Serial.print(F(" N, p90 "));
+    Serial.print(r.p90N, 2);
+    Serial.println(F(" N"));
+    Serial.print(F("# Samples:      "));
+    Serial.print(r.samples);
+    if (r.gaps > 0) {
+        Serial.print(F(" ("));
+        Serial.print(r.gaps);
+        Serial.print(F(" gaps over "));
+        Serial.print(ANALYTICS_MAX_GAP_MS);
+        Serial.print(F(" ms not integrated)"));
+    }
+    Serial.println();
+}
+#endif
@@ -0,0 +1,421 @@
+// ============================================================================
+// Thrust Analytics Replay
+// ============================================================================
+// Checks ThrustAnalytics against an exact offline computation:
+//   1. replays the THST samples of a receiver text log (uart_log.txt)
+//      through ThrustAnalytics with the firmware defaults. The log restarts
+//      its timestamps at each reboot; every run is a segment of its own and
+//      a burn still open at its end is dropped, as a tare would drop it.
+//      For each burn the streaming report is printed next to the same
+//      figures computed from the whole recorded burn in double precision
+//      (full scans for the crossings, sorted samples for the percentiles)
+//   2. generates a long session at a multi-kHz rate with several burns and
+//      noise, times update() per sample and gives the largest difference
+//      from the exact figures over all of its burns
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -I ../lib/ThrustAnalytics -o analytics_replay
+//       analytics_replay.cpp ../lib/ThrustAnalytics/ThrustAnalytics.cpp
+//   (one command; see README)
+// Usage:
+//   ./analytics_replay <uart_log.txt> [sample_hz] [seconds]
+//   ./analytics_replay ../../1Feb-motar-test-data/uart_log.txt 2000 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include "ThrustAnalytics.h"
+
+// Firmware defaults (loadcell_config.h)
+#define REPLAY_START_N 5.0f
+#define REPLAY_END_N 2.5f
+#define REPLAY_HOLD_MS 200
+#define REPLAY_MAX_GAP_MS 500
+
+// Synthetic session
+#define SYNTH_BURNS 5
+#define SYNTH_NOISE_N 0.5f
+#define TIMING_BLOCK 256
+
+struct Sample {
+    uint32_t timestampUs;
+    float forceNewtons;
+};
+
+// Only fully received VALID thrust lines; garbled lines are skipped
+static bool parseLine(const char* line, Sample& sample) {
+    if (!strstr(line, ",VALID,")) return false;
+    const char* data = strstr(line, ",DATA,THST,");
+    if (!data) return false;
+
+    char unit[4];
+    unsigned long timestamp;
+    float value;
+    if (sscanf(data, ",DATA,THST,%f,%3[^,],%lu", &value, unit, &timestamp) != 3) return false;
+
+    sample.forceNewtons = value;
+    sample.timestampUs = (uint32_t)(timestamp * 1000UL);
+    return true;
+}
+
+static double nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ===== Exact Reference =====
+// The same definitions over the recorded burn, samples start..end
+class ExactBurn {
+public:
+    ExactBurn(const Sample* samples, size_t start, size_t end) :
+        _s(samples), _first(start), _end(end)
+    {
+        // Seeded like ThrustAnalytics: the sample before, if close and lower
+        if (start > 0 && samples[start].timestampUs - samples[start - 1].timestampUs <= gapUs() &&
+            force(start - 1) < force(start)) {
+            _first = start - 1;
+        }
+        _cumulative.assign(end - _first + 1, 0.0);
+        for (size_t i = _first + 1; i <= end; i++) {
+            _cumulative[i - _first] = _cumulative[i - 1 - _first] + intervalImpulse(i - 1, 1.0);
+        }
+    }
+
+    BurnReport report(size_t start) const {
+        BurnReport r;
+        memset(&r, 0, sizeof(r));
+
+        double startS = 0.0;
+        double startImpulse = 0.0;
+        if (_first < start) crossing(_first, REPLAY_START_N, startS, startImpulse);
+
+        size_t peak = start;
+        for (size_t i = start; i <= _end; i++) {
+            if (force(i) > force(peak)) peak = i;
+        }
+        double peakN = force(peak);
+
+        double endS, endImpulse;
+        lastCrossing(REPLAY_END_N, endS, endImpulse);
+
+        double lowFirstS, lowFirstImpulse, highFirstS, highFirstImpulse;
+        double lowLastS, lowLastImpulse, highLastS, highLastImpulse;
+        firstCrossing(ANALYTICS_LOW_FRACTION * peakN, lowFirstS, lowFirstImpulse);
+        firstCrossing(ANALYTICS_HIGH_FRACTION * peakN, highFirstS, highFirstImpulse);
+        lastCrossing(ANALYTICS_LOW_FRACTION * peakN, lowLastS, lowLastImpulse);
+        lastCrossing(ANALYTICS_HIGH_FRACTION * peakN, highLastS, highLastImpulse);
+
+        r.burnTimeS = endS - startS;
+        r.peakN = peakN;
+        r.timeToPeakS = time(peak) - startS;
+        r.impulseNs = endImpulse - startImpulse;
+        r.averageN = r.burnTimeS > 0.0f ? r.impulseNs / r.burnTimeS : 0.0f;
+        r.riseS = highFirstS - lowFirstS;
+        r.tailOffS = lowLastS - highLastS;
+        r.actionTimeS = lowLastS - lowFirstS;
+        r.actionImpulseNs = lowLastImpulse - lowFirstImpulse;
+        r.actionAverageN = r.actionTimeS > 0.0f ? r.actionImpulseNs / r.actionTimeS : 0.0f;
+
+        std::vector<float> above;
+        for (size_t i = start; i <= _end; i++) {
+            if (force(i) >= REPLAY_END_N) above.push_back(force(i));
+        }
+        std::sort(above.begin(), above.end());
+        r.medianN = quantile(above, 0.5);
+        r.p90N = quantile(above, 0.9);
+        r.samples = _end - start + 1;
+        r.impulseClass = ThrustAnalytics::impulseClass(r.impulseNs);
+        return r;
+    }
+
+private:
+    static uint32_t gapUs() { return REPLAY_MAX_GAP_MS * 1000UL; }
+
+    double force(size_t i) const { return fabs((double)_s[i].forceNewtons); }
+    double time(size_t i) const { return (_s[i].timestampUs - _s[_first].timestampUs) * 1e-6; }
+
+    // Trapezoid over the first fraction u of interval i..i+1, force linear
+    double intervalImpulse(size_t i, double u) const {
+        uint32_t dtUs = _s[i + 1].timestampUs - _s[i].timestampUs;
+        if (dtUs > gapUs()) return 0.0;
+        double dt = dtUs * 1e-6;
+        return dt * u * (force(i) + 0.5 * u * (force(i + 1) - force(i)));
+    }
+
+    // Level crossed inside interval i..i+1
+    void crossing(size_t i, double level, double& timeS, double& impulseNs) const {
+        double u = (level - force(i)) / (force(i + 1) - force(i));
+        if (u < 0.0) u = 0.0;
+        if (u > 1.0) u = 1.0;
+        timeS = time(i) + u * (time(i + 1) - time(i));
+        impulseNs = _cumulative[i - _first] + intervalImpulse(i, u);
+    }
+
+    void firstCrossing(double level, double& timeS, double& impulseNs) const {
+        size_t i = _first;
+        while (i < _end && force(i) < level) i++;
+        if (i == _first) {
+            timeS = time(i);
+            impulseNs = _cumulative[0];
+            return;
+        }
+        crossing(i - 1, level, timeS, impulseNs);
+    }
+
+    void lastCrossing(double level, double& timeS, double& impulseNs) const {
+        size_t i = _end;
+        while (i > _first && force(i) < level) i--;
+        if (i == _end) {
+            timeS = time(i);
+            impulseNs = _cumulative[i - _first];
+            return;
+        }
+        crossing(i, level, timeS, impulseNs);
+    }
+
+    // Linear between order statistics
+    static float quantile(const std::vector<float>& sorted, double p) {
+        if (sorted.empty()) return 0.0f;
+        double position = p * (sorted.size() - 1);
+        size_t below = (size_t)position;
+        if (below + 1 >= sorted.size()) return sorted.back();
+        double u = position - below;
+        return (float)(sorted[below] + u * (sorted[below + 1] - sorted[below]));
+    }
+
+    const Sample* _s;
+    size_t _first;
+    size_t _end;
+    std::vector<double> _cumulative;
+};
+
+// ===== Comparison =====
+struct Field {
+    const char* name;
+    const char* unit;
+    float BurnReport::* member;
+};
+
+#define FIELD(name, unit, member) { name, unit, &BurnReport::member }
+
+static const Field fields[] = {
+    FIELD("burn time", "s", burnTimeS),
+    FIELD("peak", "N", peakN),
+    FIELD("time to peak", "s", timeToPeakS),
+    FIELD("impulse", "N*s", impulseNs),
+    FIELD("average", "N", averageN),
+    FIELD("rise 10-90%", "s", riseS),
+    FIELD("tail-off 90-10%", "s", tailOffS),
+    FIELD("action time", "s", actionTimeS),
+    FIELD("action impulse", "N*s", actionImpulseNs),
+    FIELD("action average", "N", actionAverageN),
+    FIELD("median", "N", medianN),
+    FIELD("p90", "N", p90N),
+};
+static const uint8_t FIELD_COUNT = sizeof(fields) / sizeof(fields[0]);
+
+static float fieldValue(const BurnReport& r, uint8_t field) {
+    return r.*fields[field].member;
+}
+
+// Difference relative to the exact value, or to the peak for force
+// figures and to the burn time for times, whichever is larger, so a value
+// near zero does not blow up
+static float relativeError(const BurnReport& streamed, const BurnReport& exact, uint8_t field) {
+    float a = fieldValue(streamed, field);
+    float b = fieldValue(exact, field);
+    float scale = fabsf(b);
+    if (strcmp(fields[field].unit, "s") == 0) scale = fmaxf(scale, 0.01f * exact.burnTimeS);
+    if (strcmp(fields[field].unit, "N") == 0) scale = fmaxf(scale, 0.01f * exact.peakN);
+    return scale > 0.0f ? fabsf(a - b) / scale : 0.0f;
+}
+
+static void printComparison(const BurnReport& streamed, const BurnReport& exact) {
+    printf("  %-22s %12s %12s %9s\n", "", "streaming", "exact", "diff");
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+        char label[32];
+        snprintf(label, sizeof(label), "%s (%s)", fields[f].name, fields[f].unit);
+        float a = fieldValue(streamed, f);
+        float b = fieldValue(exact, f);
+        printf("  %-22s %12.4f %12.4f %+8.2f%%\n", label, a, b,
+               100.0f * (a - b) / (fabsf(b) > 0.0f ? fabsf(b) : 1.0f));
+    }
+    printf("  %-22s %12s %12s\n", "class", streamed.impulseClass, exact.impulseClass);
+}
+
+struct Replay {
+    uint32_t burns;
+    uint32_t dropped;
+    float maxError[FIELD_COUNT];
+};
+
+// One segment through analytics; compares every burn that ends in it
+static void replay(ThrustAnalytics& analytics, const std::vector<Sample>& samples, bool verbose,
+                   Replay& result) {
+    analytics.reset();
+    size_t start = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        bool wasBurning = analytics.isBurning();
+        bool ended = analytics.update(samples[i].forceNewtons, samples[i].timestampUs);
+        if (!wasBurning && analytics.isBurning()) start = i;
+        if (!ended) continue;
+
+        const BurnReport& streamed = analytics.getReport();
+        BurnReport exact = ExactBurn(samples.data(), start, i).report(start);
+        result.burns++;
+        for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+            result.maxError[f] = fmaxf(result.maxError[f], relativeError(streamed, exact, f));
+        }
+        if (verbose) {
+            char designation[16];
+            analytics.getDesignation(designation, sizeof(designation));
+            printf("\nBurn %u: samples %zu-%zu, t %.3f-%.3f s, %s (%u gaps)\n", streamed.number,
+                   start, i, samples[start].timestampUs * 1e-6, samples[i].timestampUs * 1e-6,
+                   designation, streamed.gaps);
+            printComparison(streamed, exact);
+        }
+    }
+    if (analytics.isBurning()) {
+        result.dropped++;
+        if (verbose) {
+            printf("\nBurn open at the end of the segment (from t %.3f s, peak %.1f N): dropped\n",
+                   samples[start].timestampUs * 1e-6, analytics.getPeakN());
+        }
+    }
+}
+
+// ===== Synthetic Session =====
+// Burns of different shapes: fast rise, regressive plateau, tail-off
+static float synthForce(double t, double burnEveryS) {
+    int burn = (int)(t / burnEveryS);
+    double b = t - burn * burnEveryS - 0.3 * burnEveryS;
+    if (b < 0.0 || burn >= SYNTH_BURNS) return 0.0f;
+
+    double peak = 50.0 * pow(3.0, burn);            // 50 N to 4 kN
+    double riseS = 0.02 + 0.03 * burn;
+    double plateauS = 0.8 + 0.6 * burn;
+    double tailS = 0.15 + 0.1 * burn;
+    if (b < riseS) return (float)(peak * sin(0.5 * M_PI * b / riseS) * sin(0.5 * M_PI * b / riseS));
+    b -= riseS;
+    if (b < plateauS) return (float)(peak * (1.0 - 0.4 * b / plateauS));
+    b -= plateauS;
+    if (b < tailS) return (float)(0.6 * peak * (1.0 - b / tailS) * (1.0 - b / tailS));
+    return 0.0f;
+}
+
+static void synthetic(float sampleHz, float seconds) {
+    size_t count = (size_t)(sampleHz * seconds);
+    std::vector<Sample> samples(count);
+    double burnEveryS = seconds / SYNTH_BURNS;
+    uint32_t rng = 12345;
+    for (size_t i = 0; i < count; i++) {
+        double t = i / (double)sampleHz;
+        // Sum of four uniforms: close to Gaussian
+        float n = 0.0f;
+        for (uint8_t k = 0; k < 4; k++) {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            n += (rng / 4294967296.0f) - 0.5f;
+        }
+        samples[i].timestampUs = (uint32_t)(t * 1e6);
+        samples[i].forceNewtons = -(synthForce(t, burnEveryS) + n * SYNTH_NOISE_N * 1.7320508f);
+    }
+
+    ThrustAnalytics analytics;
+    analytics.configure(REPLAY_START_N, REPLAY_END_N, REPLAY_HOLD_MS, REPLAY_MAX_GAP_MS);
+
+    // Timing first, on its own, in blocks that are all idle or all burning
+    double bestIdle = 1e30;
+    double bestBurning = 1e30;
+    for (uint8_t pass = 0; pass < 5; pass++) {
+        analytics.reset();
+        double idleNs = 0.0, burningNs = 0.0;
+        size_t idleCount = 0, burningCount = 0;
+        for (size_t i = 0; i < count; i += TIMING_BLOCK) {
+            size_t end = std::min(i + TIMING_BLOCK, count);
+            bool burning = analytics.isBurning();
+            double t0 = nowNs();
+            for (size_t j = i; j < end; j++) {
+                analytics.update(samples[j].forceNewtons, samples[j].timestampUs);
+            }
+            double ns = nowNs() - t0;
+            if (burning != analytics.isBurning()) continue;
+            if (burning) {
+                burningNs += ns;
+                burningCount += end - i;
+            } else {
+                idleNs += ns;
+                idleCount += end - i;
+            }
+        }
+        if (idleCount) bestIdle = std::min(bestIdle, idleNs / idleCount);
+        if (burningCount) bestBurning = std::min(bestBurning, burningNs / burningCount);
+    }
+
+    Replay result;
+    memset(&result, 0, sizeof(result));
+    replay(analytics, samples, false, result);
+
+    printf("\nSynthetic: %.0f SPS, %.0f s, %zu samples, %u burns (50 N to 4 kN), noise %.1f N RMS\n",
+           sampleHz, seconds, count, result.burns, SYNTH_NOISE_N);
+    printf("  update()        %.1f ns/sample idle, %.1f ns/sample burning (best of 5)\n",
+           bestIdle, bestBurning);
+    printf("  state           %zu bytes\n", sizeof(ThrustAnalytics));
+    printf("  largest difference from exact over all burns:\n");
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+        printf("    %-16s %6.2f%%\n", fields[f].name, 100.0f * result.maxError[f]);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <uart_log.txt> [sample_hz] [seconds]\n", argv[0]);
+        return 2;
+    }
+    float sampleHz = argc > 2 ? atof(argv[2]) : 2000.0f;
+    float seconds = argc > 3 ? atof(argv[3]) : 600.0f;
+
+    FILE* in = fopen(argv[1], "r");
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    // A timestamp going back is a reboot of the sender: new segment
+    std::vector<std::vector<Sample> > segments(1);
+    char line[512];
+    Sample sample;
+    while (fgets(line, sizeof(line), in)) {
+        if (!parseLine(line, sample)) continue;
+        std::vector<Sample>& current = segments.back();
+        if (!current.empty() && sample.timestampUs < current.back().timestampUs) {
+            segments.push_back(std::vector<Sample>());
+        }
+        segments.back().push_back(sample);
+    }
+    fclose(in);
+
+    printf("Start %.1f N, end %.1f N after %u ms, gaps over %u ms not integrated\n",
+           REPLAY_START_N, REPLAY_END_N, REPLAY_HOLD_MS, REPLAY_MAX_GAP_MS);
+
+    ThrustAnalytics analytics;
+    analytics.configure(REPLAY_START_N, REPLAY_END_N, REPLAY_HOLD_MS, REPLAY_MAX_GAP_MS);
+    Replay result;
+    memset(&result, 0, sizeof(result));
+    for (size_t s = 0; s < segments.size(); s++) {
+        const std::vector<Sample>& segment = segments[s];
+        printf("\n=== Segment %zu: %zu samples, %.1f s ===\n", s, segment.size(),
+               (segment.back().timestampUs - segment.front().timestampUs) * 1e-6);
+        replay(analytics, segment, true, result);
+    }
+    printf("\nLog: %u burns reported, %u open at a restart\n", result.burns, result.dropped);
+
+    synthetic(sampleHz, seconds);
+    return 0;
+}
@@ -0,0 +1,174 @@
+// ============================================================================
+// Dual-Rate Switching Simulation
+// ============================================================================
+// Runs DualRateController against the simulated ADC, which behaves like a
+// dual-rate HX711 (settling error after a switch, zero shift at the fast
+// rate). Two burns of a generated curve with long quiet gaps:
+//   1. not armed: the force trigger switches to fast during the burn
+//   2. armed 3 s before: the zero shift is measured on the quiet stand
+// For each burn it reports when the stand went fast, the frames and
+// impulse it got, the zero at the fast rate before and after the shift is
+// known, and the largest quiet-stand force, which shows any unsettled frame
+// that got through.
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -DLOADCELL_ADC=2 -DBOARD_NAME=\"host\"
+//       -I ../include -I ../lib/LoadCellModule -I ../lib/SimulatedAdc
+//       -I ../lib/DualRateController -I ../lib/CalibrationTable
+//       -I ../../shared/SpscQueue
+//       -o dualrate_sim dualrate_sim.cpp ../lib/LoadCellModule/LoadCellModule.cpp
+//       ../lib/SimulatedAdc/SimulatedAdc.cpp
+//       ../lib/DualRateController/DualRateController.cpp
+//       ../lib/CalibrationTable/CalibrationTable.cpp
+//   (one command; see README)
+// Usage:
+//   ./dualrate_sim [shift_counts] [slow_hz] [fast_hz]
+//   ./dualrate_sim 600 10 80
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#include "LoadCellModule.h"
+#include "DualRateController.h"
+
+// Generated curve: quiet, a 1.5 s burn, quiet. With the simulator's lead-in
+// and lead-out one loop is 14 s and each burn starts 9 s into it
+#define SIM_QUIET_S 8.0f
+#define SIM_BURN_S 1.5f
+#define SIM_LOOP_S 14.0f
+#define SIM_HOLD_MS 1000
+#define SIM_ARM_LEAD_S 3.0f
+
+static LoadCellModule loadCell;
+static DualRateController controller(loadCell);
+static float nowS = 0.0f;
+
+static bool writeCurve(char* path) {
+    int fd = mkstemp(path);
+    if (fd < 0) return false;
+    FILE* file = fdopen(fd, "w");
+    if (!file) return false;
+    fprintf(file, "; dualrate_sim burn\n");
+    fprintf(file, "0 0\n%.2f 0\n", SIM_QUIET_S);
+    fprintf(file, "%.2f 40\n", SIM_QUIET_S + 0.1f);
+    fprintf(file, "%.2f 30\n", SIM_QUIET_S + SIM_BURN_S - 0.2f);
+    fprintf(file, "%.2f 0\n", SIM_QUIET_S + SIM_BURN_S);
+    fprintf(file, "%.2f 0\n", SIM_LOOP_S - 2.0f);
+    fclose(file);
+    return true;
+}
+
+static void onEvent(const DualRateController& c, DualRateEvent event) {
+    static const char* names[] = { "fast", "slow", "shift learned", "shift rejected", "failed" };
+    printf("  %7.3f s  %-14s %3.0f SPS  mode %-6s shift %ld\n", nowS, names[event],
+           loadCell.getSampleRate(), c.getModeName(), loadCell.getRateShift(0));
+}
+
+struct BurnResult {
+    float fastAtS;          // From burn start; negative = before it
+    uint32_t burnFrames;
+    float impulse;
+    float fastZeroN;        // Mean quiet force at the fast rate
+    uint32_t fastZeroFrames;
+    float maxQuietN;
+};
+
+// One loop of the curve, arming armLeadS before the burn (0 = not armed)
+static BurnResult runLoop(float loopStartS, float armLeadS) {
+    float burnStartS = loopStartS + SIMULATED_ADC_LEAD_S + SIM_QUIET_S;
+    float burnEndS = burnStartS + SIM_BURN_S;
+    bool armed = armLeadS <= 0.0f;
+
+    BurnResult result = { NAN, 0, 0.0f, 0.0f, 0, 0.0f };
+    float lastS = -1.0f;
+    float lastForce = 0.0f;
+    double zeroSum = 0.0;
+
+    ThrustData data;
+    while (nowS < loopStartS + SIM_LOOP_S) {
+        if (!armed && nowS >= burnStartS - armLeadS) {
+            armed = true;
+            printf("  %7.3f s  arm()\n", nowS);
+            controller.arm();
+        }
+        if (!loadCell.readIfReady(data)) continue;
+        nowS = data.timestampUs * 1e-6f;
+        controller.update(data);
+
+        float force = data.forceNewtons;
+        bool inBurn = nowS >= burnStartS && nowS < burnEndS;
+        if (controller.isFast() && isnan(result.fastAtS)) result.fastAtS = nowS - burnStartS;
+        if (inBurn) result.burnFrames++;
+        if (nowS >= burnStartS - 0.5f && nowS < burnEndS + 0.5f && lastS >= 0.0f) {
+            result.impulse += 0.5f * (force + lastForce) * (nowS - lastS);
+        }
+        // Quiet stand: away from the burn edges
+        if (nowS < burnStartS - 0.1f || nowS > burnEndS + 0.1f) {
+            if (fabsf(force) > result.maxQuietN) result.maxQuietN = fabsf(force);
+            if (controller.isFast()) {
+                zeroSum += force;
+                result.fastZeroFrames++;
+            }
+        }
+        lastS = nowS;
+        lastForce = force;
+    }
+    if (result.fastZeroFrames) result.fastZeroN = (float)(zeroSum / result.fastZeroFrames);
+    return result;
+}
+
+static void printResult(const char* name, const BurnResult& r, float burnImpulse) {
+    printf("%s\n", name);
+    printf("  fast at       %+.3f s from burn start\n", r.fastAtS);
+    printf("  burn frames   %u\n", r.burnFrames);
+    printf("  impulse       %.2f N*s (curve %.2f, %+.1f%%)\n", r.impulse, burnImpulse,
+           100.0f * (r.impulse - burnImpulse) / burnImpulse);
+    printf("  fast zero     %+.3f N (%u quiet frames)\n", r.fastZeroN, r.fastZeroFrames);
+    printf("  quiet max     %.3f N\n", r.maxQuietN);
+}
+
+int main(int argc, char** argv) {
+    long shift = argc > 1 ? atol(argv[1]) : 600;
+    float slowHz = argc > 2 ? atof(argv[2]) : 10.0f;
+    float fastHz = argc > 3 ? atof(argv[3]) : 80.0f;
+    static const float calibrationFactors[LOADCELL_CHANNELS] = LOADCELL_CAL_FACTORS;
+
+    char path[] = "/tmp/dualrate_simXXXXXX";
+    if (!writeCurve(path)) {
+        fprintf(stderr, "cannot write the curve file\n");
+        return 1;
+    }
+    bool started = loadCell.adc().begin(path, slowHz, LOADCELL_CHANNELS);
+    unlink(path);
+    if (!started) {
+        fprintf(stderr, "cannot load the curve\n");
+        return 1;
+    }
+    loadCell.adc().setScale(calibrationFactors);
+    loadCell.adc().setNoise(SIM_ADC_NOISE_COUNTS);
+    loadCell.adc().setRateShift(shift);
+    if (!loadCell.begin(calibrationFactors)) {
+        fprintf(stderr, "%s\n", loadCell.getStatusString());
+        return 1;
+    }
+    loadCell.tare(TARE_READINGS);
+    float burnImpulse = loadCell.adc().getCurveImpulse();
+
+    controller.configure(slowHz, fastHz, DUAL_RATE_TRIGGER_N, SIM_HOLD_MS, 60000);
+    controller.onEvent(onEvent);
+
+    printf("Dual rate %.0f/%.0f SPS, trigger %.1f N, zero shift %ld counts (%.3f N)\n",
+           slowHz, fastHz, DUAL_RATE_TRIGGER_N, shift, shift / calibrationFactors[0]);
+
+    printf("\nLoop 1: not armed\n");
+    BurnResult triggered = runLoop(0.0f, 0.0f);
+    printf("\nLoop 2: armed %.0f s before the burn\n", SIM_ARM_LEAD_S);
+    BurnResult armed = runLoop(SIM_LOOP_S, SIM_ARM_LEAD_S);
+
+    printf("\n");
+    printResult("Force trigger", triggered, burnImpulse);
+    printResult("Armed", armed, burnImpulse);
+    printf("Settling frames dropped: %u\n", loadCell.getSettleDrops());
+    return 0;
+}
@@ -0,0 +1,151 @@
+// ============================================================================
+// Force Filter Log Replay
+// ============================================================================
+// Runs the THST samples of a receiver text log (uart_log.txt) through
+// ForceFilterChain on the host, one chain per spec argument, and reports
+// per-sample cost and how far each chain moved the signal:
+//   <spec>  samples  ns/sample  rms(out-raw)  max|out-raw|
+// With -o, writes timestamp_ms,raw_N,<spec>... as CSV for plotting.
+// The sample rate is the median sensor timestamp step in the log.
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -I ../lib/ForceFilter -o filterlog filterlog.cpp ../lib/ForceFilter/ForceFilter.cpp
+// Usage:
+//   ./filterlog ../../1Feb-motar-test-data/uart_log.txt
+//   ./filterlog uart_log.txt -o filtered.csv median=5 lowpass=2 median=5,lowpass=2
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include "ForceFilter.h"
+
+#define MAX_CHAINS 8
+
+struct Sample {
+    unsigned long timestampMs;
+    float forceNewtons;
+};
+
+// Only fully received VALID thrust lines; garbled lines are skipped
+static bool parseLine(const char* line, Sample& sample) {
+    if (!strstr(line, ",VALID,")) return false;
+    const char* data = strstr(line, ",DATA,THST,");
+    if (!data) return false;
+
+    char unit[4];
+    unsigned long timestamp;
+    float value;
+    if (sscanf(data, ",DATA,THST,%f,%3[^,],%lu", &value, unit, &timestamp) != 3) return false;
+
+    sample.forceNewtons = value;
+    sample.timestampMs = timestamp;
+    return true;
+}
+
+static double nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <uart_log.txt> [-o output.csv] [spec ...]\n", argv[0]);
+        return 2;
+    }
+
+    const char* csvPath = NULL;
+    const char* specs[MAX_CHAINS];
+    int specCount = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (specCount < MAX_CHAINS) {
+            specs[specCount++] = argv[i];
+        }
+    }
+    if (specCount == 0) {
+        // Each stage on its own, then the firmware default
+        static const char* defaults[] = {"median=5", "lowpass=2", "avg=4", "median=5,lowpass=2"};
+        specCount = sizeof(defaults) / sizeof(defaults[0]);
+        memcpy(specs, defaults, sizeof(defaults));
+    }
+
+    FILE* in = fopen(argv[1], "r");
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<Sample> samples;
+    char line[256];
+    Sample sample;
+    while (fgets(line, sizeof(line), in)) {
+        if (parseLine(line, sample)) samples.push_back(sample);
+    }
+    fclose(in);
+
+    if (samples.size() < 2) {
+        fprintf(stderr, "No THST samples in %s\n", argv[1]);
+        return 1;
+    }
+
+    // Median step, so dropped lines and pauses do not skew it
+    std::vector<unsigned long> steps;
+    for (size_t i = 1; i < samples.size(); i++) {
+        steps.push_back(samples[i].timestampMs - samples[i - 1].timestampMs);
+    }
+    std::nth_element(steps.begin(), steps.begin() + steps.size() / 2, steps.end());
+    float sampleRateHz = 1000.0f / steps[steps.size() / 2];
+    printf("# %zu samples at %.1f Hz\n", samples.size(), sampleRateHz);
+    printf("# %-24s %10s %10s %12s %12s\n", "spec", "samples", "ns/sample", "rms_diff_N", "max_diff_N");
+
+    std::vector<float> outputs[MAX_CHAINS];
+    for (int c = 0; c < specCount; c++) {
+        ForceFilterChain chain;
+        if (!chain.configure(specs[c], sampleRateHz)) {
+            fprintf(stderr, "Invalid spec '%s' (at %.1f Hz)\n", specs[c], sampleRateHz);
+            return 1;
+        }
+
+        std::vector<float>& out = outputs[c];
+        out.resize(samples.size());
+        double start = nowNs();
+        for (size_t i = 0; i < samples.size(); i++) {
+            out[i] = chain.process(samples[i].forceNewtons);
+        }
+        double elapsed = nowNs() - start;
+
+        double sumSquares = 0;
+        double maxDiff = 0;
+        for (size_t i = 0; i < samples.size(); i++) {
+            double diff = fabs(out[i] - samples[i].forceNewtons);
+            sumSquares += diff * diff;
+            if (diff > maxDiff) maxDiff = diff;
+        }
+        printf("  %-24s %10zu %10.1f %12.4f %12.4f\n", specs[c], samples.size(),
+               elapsed / samples.size(), sqrt(sumSquares / samples.size()), maxDiff);
+    }
+
+    if (csvPath) {
+        FILE* csv = fopen(csvPath, "w");
+        if (!csv) {
+            fprintf(stderr, "Cannot create %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "timestamp_ms,raw_N");
+        for (int c = 0; c < specCount; c++) fprintf(csv, ",%s", specs[c]);
+        fprintf(csv, "\n");
+        for (size_t i = 0; i < samples.size(); i++) {
+            fprintf(csv, "%lu,%.3f", samples[i].timestampMs, samples[i].forceNewtons);
+            for (int c = 0; c < specCount; c++) fprintf(csv, ",%.3f", outputs[c][i]);
+            fprintf(csv, "\n");
+        }
+        fclose(csv);
+    }
+    return 0;
+}
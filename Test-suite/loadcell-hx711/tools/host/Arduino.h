@@ -0,0 +1,122 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// ============================================================================
+// Host Stand-in for the Arduino Core (tools/link_test)
+// ============================================================================
+// Only what TeensyUART uses:
+//   - a simulated clock that the test advances (hostMicros)
+//   - a silent Serial
+//   - a Serial2 that records every byte it sends, with the baud rate it went
+//     out at, and whose driver TX ring drains at that rate
+// The test plays the Teensy: it reads Serial2.wire and feeds replies into
+// Serial2.rx.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <deque>
+#include <vector>
+
+#define SERIAL_8N1 0x800001c
+#define F(s) (s)
+
+extern uint64_t hostMicros;
+
+inline unsigned long millis() { return (unsigned long)(hostMicros / 1000); }
+inline unsigned long micros() { return (unsigned long)hostMicros; }
+
+template <typename T>
+inline T min(T a, T b) { return a < b ? a : b; }
+
+class HostPrint {
+public:
+    template <typename T> void print(T) {}
+    template <typename T> void println(T) {}
+    void println() {}
+};
+
+struct WireByte {
+    uint8_t value;
+    uint32_t baud;              // Rate the sender was set to
+};
+
+class HardwareSerial : public HostPrint {
+public:
+    HardwareSerial() : _baud(0), _ringSize(128), _ringUsed(0), _drainedUs(0) {}
+
+    void setTxBufferSize(size_t size) { _ringSize = size; }
+
+    void begin(uint32_t baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1) {
+        (void)config;
+        (void)rxPin;
+        (void)txPin;
+        _baud = baud;
+        _ringUsed = 0;
+        _drainedUs = hostMicros;
+    }
+
+    void updateBaudRate(uint32_t baud) {
+        drain();
+        _baud = baud;
+    }
+
+    uint32_t baudRate() const { return _baud; }
+
+    int availableForWrite() {
+        drain();
+        return (int)(_ringSize - _ringUsed);
+    }
+
+    size_t write(const uint8_t* data, size_t length) {
+        drain();
+        for (size_t i = 0; i < length; i++) {
+            WireByte byte = { data[i], _baud };
+            wire.push_back(byte);
+        }
+        _ringUsed += length;
+        return length;
+    }
+
+    // The ring is empty afterwards; time is not advanced
+    void flush() { _ringUsed = 0; }
+
+    int available() const { return (int)rx.size(); }
+
+    int read() {
+        if (rx.empty()) return -1;
+        uint8_t c = rx.front();
+        rx.pop_front();
+        return c;
+    }
+
+    std::vector<WireByte> wire;     // Everything written, oldest first
+    std::deque<uint8_t> rx;         // Bytes for the sketch to read
+
+private:
+    // 10 bits per byte (8N1)
+    void drain() {
+        if (_baud == 0) return;
+        uint64_t bytes = (hostMicros - _drainedUs) * _baud / 10000000ULL;
+        if (bytes >= _ringUsed) {
+            _ringUsed = 0;
+            _drainedUs = hostMicros;
+        } else if (bytes > 0) {
+            _ringUsed -= bytes;
+            _drainedUs += bytes * 10000000ULL / _baud;
+        }
+    }
+
+    uint32_t _baud;
+    size_t _ringSize;
+    size_t _ringUsed;
+    uint64_t _drainedUs;
+};
+
+extern HostPrint Serial;
+extern HardwareSerial Serial2;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,798 @@
+// ============================================================================
+// ThrustLink / TeensyUART Link Test
+// ============================================================================
+// Host checks for the ESP32 -> Teensy link:
+//   1. COBS round trip, including runs of 254 and more non-zero bytes, and
+//      CRC framing that rejects damaged frames
+//   2. BATCH frames: ThrustLinkBatchWriter against thrustLinkParseBatch,
+//      with values jumping between INT32_MIN and INT32_MAX and timestamps
+//      that wrap
+//   3. Windowed ACKs: the Teensy's LinkStats bitmap for a known loss
+//      pattern, and which holes TeensyUART retransmits for it (RETX_MAX per
+//      ACK, the holdoff, holes older than the history)
+//   4. Baud negotiation: TeensyUART against a scripted Teensy through
+//      BAUDREQ -> ACK -> TEST -> RES -> COMMIT, a NAK, a failed test, step
+//      timeouts and the fallback when ACKs stop; every sample taken while a
+//      rate is negotiated must still arrive
+// TeensyUART runs unmodified on a simulated clock; host/Arduino.h stands in
+// for the core. Exits 1 when a check fails.
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -Wall -DLOADCELL_ADC=2 -DBOARD_NAME=\"host\"
+//       -I host -I ../include -I ../lib/TeensyUART -I ../../shared/ThrustLink
+//       -I ../../UART-esp32-teensy/teensy4.1/lib/LinkStats
+//       -o link_test link_test.cpp ../lib/TeensyUART/TeensyUART.cpp
+//       ../../UART-esp32-teensy/teensy4.1/lib/LinkStats/LinkStats.cpp
+//   (one command; see README; add -DTEENSY_UART_BINARY=1 for binary frames)
+// Usage:
+//   ./link_test
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "ThrustLink.h"
+#include "TeensyUART.h"
+#include "LinkStats.h"
+
+// Rates the 115200 base rate carries (ASCII ~45, SAMPLE 18, batched ~4 bytes)
+#if !TEENSY_UART_BINARY
+#define SAMPLE_HZ 200
+#elif TEENSY_UART_BATCH_SAMPLES > 1
+#define SAMPLE_HZ 1000
+#else
+#define SAMPLE_HZ 400
+#endif
+#define STEP_US 100
+#define ACK_INTERVAL_MS 50             // As the Teensy receiver
+#define PEER_SILENCE_MS 2000           // BAUD_SILENCE_TIMEOUT_MS on the Teensy
+#define MAX_SEQUENCES 20000
+
+uint64_t hostMicros = 0;
+HostPrint Serial;
+HardwareSerial Serial2;
+
+static int failures = 0;
+static uint32_t rng = 12345;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+}
+
+static uint32_t random32() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint8_t xorChecksum(const char* body) {
+    uint8_t checksum = 0;
+    for (const char* c = body; *c; c++) checksum ^= (uint8_t)*c;
+    return checksum;
+}
+
+// ===== 1. COBS and Framing =====
+
+static bool cobsRoundTrip(const std::vector<uint8_t>& in) {
+    std::vector<uint8_t> encoded(in.size() + in.size() / 254 + 2);
+    std::vector<uint8_t> decoded(encoded.size());
+    size_t length = cobsEncode(in.data(), in.size(), encoded.data());
+    if (length > in.size() + in.size() / 254 + 1) return false;
+    for (size_t i = 0; i < length; i++) {
+        if (encoded[i] == 0) return false;
+    }
+    size_t back = cobsDecode(encoded.data(), length, decoded.data());
+    return back == in.size() && memcmp(decoded.data(), in.data(), in.size()) == 0;
+}
+
+static void testCobs() {
+    printf("COBS and framing\n");
+
+    static const size_t lengths[] = { 0, 1, 2, 253, 254, 255, 256, 507, 508, 509, 1000 };
+    bool runs = true;
+    bool zeros = true;
+    bool mixed = true;
+    for (size_t n = 0; n < sizeof(lengths) / sizeof(lengths[0]); n++) {
+        size_t length = lengths[n];
+        std::vector<uint8_t> data(length);
+
+        for (size_t i = 0; i < length; i++) data[i] = (uint8_t)(i % 255 + 1);
+        runs &= cobsRoundTrip(data);
+
+        for (size_t i = 0; i < length; i++) data[i] = 0;
+        zeros &= cobsRoundTrip(data);
+
+        // Non-zero runs of every length either side of 254
+        for (size_t i = 0; i < length; i++) data[i] = (uint8_t)(random32() % 300 == 0 ? 0 : i | 1);
+        mixed &= cobsRoundTrip(data);
+        if (length > 1) {
+            data[0] = 0;
+            data[length - 1] = 0;
+            mixed &= cobsRoundTrip(data);
+        }
+    }
+    check(runs, "non-zero runs of 0-1000 bytes round-trip");
+    check(zeros, "all-zero input round-trips");
+    check(mixed, "random zeros round-trip");
+
+    // 254 non-zero bytes fill one block exactly: 0xFF, data, empty block
+    std::vector<uint8_t> block(254, 0x11);
+    uint8_t encoded[260];
+    size_t length = cobsEncode(block.data(), block.size(), encoded);
+    check(length == 256 && encoded[0] == 0xFF && encoded[255] == 0x01, "254-byte run encodes as 0xFF block + 0x01");
+
+    uint8_t bad[4] = { 0x03, 0x11, 0x00, 0x11 };
+    uint8_t out[8];
+    uint8_t overrun[2] = { 0x05, 0x11 };
+    check(cobsDecode(bad, 4, out) == 0 && cobsDecode(overrun, 2, out) == 0, "zero inside a block or overrun rejected");
+
+    // Frames: round trip, then every single-bit error
+    uint32_t framed = 0;
+    uint32_t flipsMissed = 0;
+    for (int trial = 0; trial < 200; trial++) {
+        uint8_t payload[THRUSTLINK_MAX_PAYLOAD + 2];
+        size_t payloadLength = 1 + random32() % THRUSTLINK_MAX_PAYLOAD;
+        for (size_t i = 0; i < payloadLength; i++) payload[i] = (uint8_t)random32();
+        uint8_t original[THRUSTLINK_MAX_PAYLOAD];
+        memcpy(original, payload, payloadLength);
+
+        uint8_t frame[THRUSTLINK_MAX_ENCODED];
+        size_t frameLength = thrustLinkFrame(payload, payloadLength, frame);
+        uint8_t decoded[THRUSTLINK_MAX_ENCODED];
+        if (frame[frameLength - 1] == THRUSTLINK_DELIMITER &&
+            thrustLinkUnframe(frame, frameLength - 1, decoded) == payloadLength &&
+            memcmp(decoded, original, payloadLength) == 0) {
+            framed++;
+        }
+
+        for (size_t bit = 0; bit < (frameLength - 1) * 8; bit++) {
+            frame[bit / 8] ^= 1 << (bit % 8);
+            size_t got = thrustLinkUnframe(frame, frameLength - 1, decoded);
+            if (got == payloadLength && memcmp(decoded, original, payloadLength) != 0) flipsMissed++;
+            frame[bit / 8] ^= 1 << (bit % 8);
+        }
+    }
+    check(framed == 200, "200 random frames round-trip with CRC");
+    check(flipsMissed == 0, "no single-bit error passes the CRC");
+    printf("\n");
+}
+
+// ===== 2. Batches =====
+
+static bool sameSample(const ThrustLinkSample& a, const ThrustLinkSample& b) {
+    return a.device == b.device && a.sequence == b.sequence && a.timestampUs == b.timestampUs &&
+           a.valueMilli == b.valueMilli;
+}
+
+// Write samples into batches, frame each, decode it and compare. Returns the
+// number of batches, or 0 on a mismatch.
+static uint32_t batchRoundTrip(const std::vector<ThrustLinkSample>& samples, uint8_t limit) {
+    ThrustLinkBatchWriter writer;
+    uint32_t batches = 0;
+    size_t first = 0;
+    size_t i = 0;
+
+    while (first < samples.size()) {
+        writer.begin(samples[first].device, samples[first]);
+        i = first + 1;
+        while (i < samples.size() && writer.count() < limit && writer.add(samples[i])) i++;
+
+        uint8_t frame[THRUSTLINK_MAX_ENCODED];
+        size_t frameLength = writer.finish(frame);
+        uint8_t payload[THRUSTLINK_MAX_ENCODED];
+        size_t payloadLength = thrustLinkUnframe(frame, frameLength - 1, payload);
+        ThrustLinkSample decoded[THRUSTLINK_BATCH_MAX_SAMPLES];
+        uint8_t count = thrustLinkParseBatch(payload, payloadLength, decoded);
+        if (count != i - first || writer.count() != 0) return 0;
+        for (uint8_t k = 0; k < count; k++) {
+            if (!sameSample(decoded[k], samples[first + k])) return 0;
+        }
+        first = i;
+        batches++;
+    }
+    return batches;
+}
+
+static void testBatch() {
+    printf("BATCH frames\n");
+
+    static const int32_t edges[] = { INT32_MIN, INT32_MAX, -1, 0, 1, 63, -64, 64, -65 };
+    static const size_t edgeLengths[] = { 5, 5, 1, 1, 1, 1, 1, 2, 2 };
+    bool varints = true;
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+        uint8_t buffer[5];
+        int32_t value = 0;
+        size_t length = thrustLinkPutVarint(buffer, edges[i]);
+        varints &= length == edgeLengths[i] &&
+                   thrustLinkGetVarint(buffer, buffer + length, value) == length && value == edges[i];
+        varints &= thrustLinkGetVarint(buffer, buffer + length - 1, value) == 0 || length == 1;
+    }
+    check(varints, "zigzag varints at INT32_MIN/MAX and 7-bit edges");
+
+    // Values swinging across the full int32 range, timestamps across the wrap
+    std::vector<ThrustLinkSample> samples;
+    ThrustLinkSample sample;
+    sample.device = 3;
+    sample.sequence = 0xFFFFFFF0UL;
+    sample.timestampUs = 0xFFFFF000UL;
+    for (int i = 0; i < 400; i++) {
+        sample.valueMilli = (i % 4 == 0) ? INT32_MIN : (i % 4 == 1) ? INT32_MAX : (i % 4 == 2) ? 0 : -1;
+        samples.push_back(sample);
+        sample.sequence++;
+        sample.timestampUs += 250;
+    }
+    uint32_t batches = batchRoundTrip(samples, THRUSTLINK_BATCH_MAX_SAMPLES);
+    check(batches > 0, "INT32_MIN/MAX swings and timestamp wrap round-trip");
+    check(batches > 400 / THRUSTLINK_BATCH_MAX_SAMPLES, "add() refuses a full payload (large deltas)");
+
+    // Small steps fill the sample limit instead; random deltas anywhere in
+    // the 32-bit space, including time going backwards
+    samples.clear();
+    sample.timestampUs = 0xFFFFFF00UL;
+    sample.valueMilli = 0;
+    for (int i = 0; i < 320; i++) {
+        samples.push_back(sample);
+        sample.sequence++;
+        sample.timestampUs += 50;
+        sample.valueMilli += (int32_t)(random32() % 60) - 30;
+    }
+    check(batchRoundTrip(samples, 255) == 320 / THRUSTLINK_BATCH_MAX_SAMPLES,
+          "small deltas stop at THRUSTLINK_BATCH_MAX_SAMPLES");
+    check(batchRoundTrip(samples, TEENSY_UART_BATCH_SAMPLES) == 320 / TEENSY_UART_BATCH_SAMPLES,
+          "TEENSY_UART_BATCH_SAMPLES batches round-trip");
+
+    samples.clear();
+    for (int i = 0; i < 2000; i++) {
+        sample.timestampUs = random32();
+        sample.valueMilli = (int32_t)random32();
+        samples.push_back(sample);
+        sample.sequence++;
+    }
+    check(batchRoundTrip(samples, THRUSTLINK_BATCH_MAX_SAMPLES) > 0, "random 32-bit deltas round-trip");
+
+    // Malformed payloads
+    ThrustLinkBatchWriter writer;
+    writer.begin(1, samples[0]);
+    for (int i = 1; i < 5; i++) writer.add(samples[i]);
+    uint8_t frame[THRUSTLINK_MAX_ENCODED];
+    size_t frameLength = writer.finish(frame);
+    uint8_t payload[THRUSTLINK_MAX_ENCODED + 1];
+    size_t length = thrustLinkUnframe(frame, frameLength - 1, payload);
+    ThrustLinkSample decoded[THRUSTLINK_BATCH_MAX_SAMPLES];
+    bool rejected = thrustLinkParseBatch(payload, length - 1, decoded) == 0;
+    payload[length] = 0;
+    rejected &= thrustLinkParseBatch(payload, length + 1, decoded) == 0;
+    payload[14] = 0;
+    rejected &= thrustLinkParseBatch(payload, length, decoded) == 0;
+    payload[14] = THRUSTLINK_BATCH_MAX_SAMPLES + 1;
+    rejected &= thrustLinkParseBatch(payload, length, decoded) == 0;
+    payload[14] = 5;
+    rejected &= thrustLinkParseBatch(payload, length, decoded) == 5;
+    check(rejected, "truncated, padded and bad-count batches rejected");
+    printf("\n");
+}
+
+// ===== Scripted Teensy =====
+// Parses what TeensyUART sends (ASCII lines and ThrustLink frames), answers
+// the baud handshake like BaudNegotiator and sends windowed ACKs from a real
+// LinkStats. Bytes sent at a rate other than its own are lost.
+struct Peer {
+    enum State { IDLE, TESTING, AWAIT_COMMIT };
+
+    // Behaviour
+    uint32_t maxBaud;           // $BAUDNAK above
+    bool answerRequest;         // Reply to $BAUDREQ
+    bool answerTest;            // Send $BAUDRES
+    uint8_t dropTests;          // TEST frames to lose
+    bool sendAcks;
+    std::vector<uint32_t> dropOnce;     // Samples lost on first arrival
+
+    // State
+    uint32_t baud;
+    State state;
+    uint32_t pendingBaud;
+    unsigned long deadline;
+    uint8_t testsGood;
+    uint8_t testsSeen;
+    unsigned long lastAckMs;
+    unsigned long lastFrameMs;
+    size_t wireRead;
+    std::string line;
+    std::vector<uint8_t> binary;
+    bool inBinary;
+
+    // Results
+    LinkStats stats;
+    std::vector<uint8_t> seen;          // Arrivals per sequence
+    std::vector<uint32_t> arrivals;     // In order, duplicates included
+    std::vector<std::string> controls;  // $BAUD... bodies received
+    uint32_t garbled;
+    uint32_t commits;
+
+    Peer()
+        : maxBaud(3000000), answerRequest(true), answerTest(true), dropTests(0), sendAcks(true),
+          baud(THRUSTLINK_BASE_BAUD), state(IDLE), pendingBaud(0), deadline(0), testsGood(0),
+          testsSeen(0), lastAckMs(0), lastFrameMs(0), wireRead(0), inBinary(false),
+          seen(MAX_SEQUENCES, 0), garbled(0), commits(0) {}
+
+    void reply(const char* body) {
+        // Lost if the two ends disagree on the rate
+        if (Serial2.baudRate() != baud) return;
+        char text[64];
+        snprintf(text, sizeof(text), "$%s*%02X\n", body, xorChecksum(body));
+        for (const char* c = text; *c; c++) Serial2.rx.push_back((uint8_t)*c);
+    }
+
+    void sendAck(uint16_t cumulative, uint32_t missing) {
+        char body[48];
+        snprintf(body, sizeof(body), "ACKW,%s,%04u,%08lX", DEVICE_NAME, cumulative, (unsigned long)missing);
+        reply(body);
+    }
+
+    void switchBaud(uint32_t rate) {
+        baud = rate;
+        lastFrameMs = millis();
+        line.clear();
+        inBinary = false;
+    }
+
+    void record(uint32_t sequence, uint32_t senderMs) {
+        lastFrameMs = millis();
+        for (size_t i = 0; i < dropOnce.size(); i++) {
+            if (dropOnce[i] == sequence) {
+                dropOnce.erase(dropOnce.begin() + i);
+                return;
+            }
+        }
+        if (sequence < MAX_SEQUENCES && seen[sequence] < 255) seen[sequence]++;
+        arrivals.push_back(sequence);
+        stats.update(DEVICE_NAME, (uint16_t)(sequence % 10000), senderMs, millis());
+    }
+
+    void finishTest() {
+        if (answerTest) {
+            char body[32];
+            snprintf(body, sizeof(body), "BAUDRES,%lu,%u", (unsigned long)pendingBaud, testsGood);
+            reply(body);
+        }
+        if (answerTest && testsGood == THRUSTLINK_BAUD_TEST_FRAMES) {
+            state = AWAIT_COMMIT;
+            deadline = millis() + THRUSTLINK_BAUD_STEP_TIMEOUT_MS;
+        } else {
+            state = IDLE;
+            switchBaud(THRUSTLINK_BASE_BAUD);
+        }
+    }
+
+    void handleLine(const std::string& text) {
+        size_t dollar = text.rfind('$');
+        size_t star = text.rfind('*');
+        if (dollar == std::string::npos || star == std::string::npos || star < dollar) return;
+        std::string body = text.substr(dollar + 1, star - dollar - 1);
+        if (strtoul(text.c_str() + star + 1, NULL, 16) != xorChecksum(body.c_str())) return;
+
+        unsigned long rate = 0;
+        if (sscanf(body.c_str(), "BAUDREQ,%lu", &rate) == 1) {
+            controls.push_back(body);
+            if (!answerRequest) return;
+            char reply_[32];
+            if (rate > maxBaud) {
+                snprintf(reply_, sizeof(reply_), "BAUDNAK,%lu", rate);
+                reply(reply_);
+                return;
+            }
+            snprintf(reply_, sizeof(reply_), "BAUDACK,%lu", rate);
+            reply(reply_);
+            switchBaud(rate);
+            state = TESTING;
+            pendingBaud = rate;
+            testsGood = 0;
+            testsSeen = 0;
+            deadline = millis() + THRUSTLINK_BAUD_SETTLE_MS + THRUSTLINK_BAUD_STEP_TIMEOUT_MS;
+            return;
+        }
+        if (sscanf(body.c_str(), "BAUDCOMMIT,%lu", &rate) == 1) {
+            controls.push_back(body);
+            if (state == AWAIT_COMMIT && rate == pendingBaud) {
+                state = IDLE;
+                commits++;
+            }
+            return;
+        }
+
+        unsigned long id = 0;
+        unsigned long senderMs = 0;
+        char name[16];
+        if (sscanf(body.c_str(), "%15[^,],%lu,DATA,%*[^,],%*[^,],%*[^,],%lu", name, &id, &senderMs) == 3) {
+            record((uint32_t)id, (uint32_t)senderMs);
+        }
+    }
+
+    // False if the bytes are not an intact frame
+    bool handleFrame(const uint8_t* encoded, size_t encodedLength) {
+        uint8_t payload[THRUSTLINK_MAX_ENCODED];
+        size_t length = thrustLinkUnframe(encoded, encodedLength, payload);
+        if (length == 0) return false;
+
+        ThrustLinkSample samples[THRUSTLINK_BATCH_MAX_SAMPLES];
+        uint8_t index;
+        if (thrustLinkParseSample(payload, length, samples[0])) {
+            record(samples[0].sequence, samples[0].timestampUs / 1000);
+        } else if (uint8_t count = thrustLinkParseBatch(payload, length, samples)) {
+            for (uint8_t i = 0; i < count; i++) record(samples[i].sequence, samples[i].timestampUs / 1000);
+        } else if (thrustLinkCheckTest(payload, length, index) && state == TESTING) {
+            testsSeen++;
+            if (dropTests > 0) {
+                dropTests--;
+            } else {
+                testsGood++;
+            }
+            if (testsSeen == THRUSTLINK_BAUD_TEST_FRAMES && answerTest) finishTest();
+        } else {
+            lastFrameMs = millis();
+        }
+        return true;
+    }
+
+    // True when c completed a line
+    bool pushAscii(uint8_t c) {
+        if (c != '\n') {
+            line += (char)c;
+            return false;
+        }
+        handleLine(line);
+        line.clear();
+        return true;
+    }
+
+    // Bytes after a 0x00 that did not decode: ASCII, possibly followed by a
+    // binary frame without its leading delimiter (as UartIngest)
+    void replayBinary(bool terminated) {
+        inBinary = false;
+        for (size_t i = 0; i < binary.size(); i++) {
+            if (!pushAscii(binary[i])) continue;
+            size_t next = i + 1;
+            while (next < binary.size() && (binary[next] == '\r' || binary[next] == '\n')) next++;
+            if (terminated && next < binary.size() && handleFrame(&binary[next], binary.size() - next)) break;
+        }
+        binary.clear();
+    }
+
+    void receive(const WireByte& byte) {
+        if (byte.baud != baud) {
+            garbled++;
+            line.clear();
+            inBinary = false;
+            return;
+        }
+        uint8_t c = byte.value;
+        if (c == THRUSTLINK_DELIMITER) {
+            if (inBinary && !binary.empty() && !handleFrame(binary.data(), binary.size())) {
+                replayBinary(true);
+            }
+            inBinary = true;
+            binary.clear();
+            return;
+        }
+        if (inBinary) {
+            if (binary.size() < THRUSTLINK_MAX_ENCODED) {
+                binary.push_back(c);
+                return;
+            }
+            replayBinary(false);
+        }
+        pushAscii(c);
+    }
+
+    void service() {
+        for (; wireRead < Serial2.wire.size(); wireRead++) receive(Serial2.wire[wireRead]);
+
+        unsigned long now = millis();
+        if (state != IDLE && (long)(now - deadline) >= 0) {
+            if (state == TESTING) {
+                finishTest();
+            } else {
+                state = IDLE;
+                switchBaud(THRUSTLINK_BASE_BAUD);
+            }
+        }
+        if (state == IDLE && baud != THRUSTLINK_BASE_BAUD && now - lastFrameMs >= PEER_SILENCE_MS) {
+            switchBaud(THRUSTLINK_BASE_BAUD);
+        }
+
+        uint16_t cumulative;
+        uint32_t missing;
+        if (state == IDLE && sendAcks && now - lastAckMs >= ACK_INTERVAL_MS &&
+            stats.getAckWindow(0, cumulative, missing)) {
+            lastAckMs = now;
+            sendAck(cumulative, missing);
+        }
+    }
+
+    bool allArrived(uint32_t from, uint32_t to) const {
+        for (uint32_t seq = from; seq < to; seq++) {
+            if (!seen[seq]) return false;
+        }
+        return true;
+    }
+
+    uint32_t countArrived(uint32_t from, uint32_t to) const {
+        uint32_t count = 0;
+        for (uint32_t seq = from; seq < to; seq++) count += seen[seq] ? 1 : 0;
+        return count;
+    }
+};
+
+// ===== Simulated Link =====
+struct Sim {
+    TeensyUART* link;
+    Peer peer;
+    bool sampling;
+    uint32_t taken;             // Samples handed to sendThrustData()
+    uint64_t nextSampleUs;
+
+    Sim() : link(new TeensyUART()), sampling(true), taken(0) {
+        Serial2.wire.clear();
+        Serial2.rx.clear();
+        link->begin();
+        nextSampleUs = hostMicros;
+    }
+
+    ~Sim() { delete link; }
+
+    void step() {
+        hostMicros += STEP_US;
+        if (sampling && hostMicros >= nextSampleUs) {
+            link->sendThrustData(taken * 0.001f, millis(), micros());
+            taken++;
+            nextSampleUs += 1000000 / SAMPLE_HZ;
+        }
+        link->poll();
+        peer.service();
+    }
+
+    void run(unsigned long ms) {
+        uint64_t end = hostMicros + (uint64_t)ms * 1000;
+        while (hostMicros < end) step();
+    }
+
+    // Run until the sender's baud state changes, at most ms
+    void runUntilBaud(uint32_t baud, unsigned long ms) {
+        uint64_t end = hostMicros + (uint64_t)ms * 1000;
+        while (hostMicros < end && link->getBaud() != baud) step();
+    }
+
+    // Stop sampling and let ACKs recover what they can
+    void settle() {
+        sampling = false;
+        run(1500);
+    }
+};
+
+static int countControls(const Peer& peer, const char* prefix) {
+    int count = 0;
+    for (size_t i = 0; i < peer.controls.size(); i++) {
+        if (peer.controls[i].compare(0, strlen(prefix), prefix) == 0) count++;
+    }
+    return count;
+}
+
+static std::string joinControls(const Peer& peer) {
+    std::string all;
+    for (size_t i = 0; i < peer.controls.size(); i++) {
+        all += (i ? " " : "") + peer.controls[i];
+    }
+    return all;
+}
+
+// ===== 3. Windowed ACKs =====
+
+static void testAckWindow() {
+    printf("Windowed ACKs\n");
+
+    // Teensy side: holes 50, 52, 53 and 60 in 0-99; 90 is past the bitmap
+    LinkStats stats;
+    for (uint16_t seq = 0; seq < 100; seq++) {
+        if (seq == 50 || seq == 52 || seq == 53 || seq == 60 || seq == 90) continue;
+        stats.update(DEVICE_NAME, seq, seq * 10, seq * 10 + 5);
+    }
+    uint16_t cumulative = 0;
+    uint32_t missing = 0;
+    stats.getAckWindow(0, cumulative, missing);
+    check(cumulative == 49 && missing == 0x40D, "LinkStats: cumulative 49, holes 50/52/53/60");
+
+    stats.update(DEVICE_NAME, 50, 500, 1005);
+    stats.getAckWindow(0, cumulative, missing);
+    check(cumulative == 51 && missing == 0x103, "late fill moves the cumulative on");
+
+    // Across the 9999 -> 0 wrap of the 4-digit ID
+    LinkStats wrap;
+    for (uint32_t seq = 9990; seq < 10010; seq++) {
+        if (seq == 9999 || seq == 10001) continue;
+        wrap.update(DEVICE_NAME, (uint16_t)(seq % 10000), seq, seq + 5);
+    }
+    wrap.getAckWindow(0, cumulative, missing);
+    check(cumulative == 9998 && missing == 0x5, "holes across the ID wrap");
+
+    // Sender side: no negotiation, so only ACK traffic
+    Sim sim;
+    sim.peer.answerRequest = false;
+    sim.run(1500);
+    uint32_t start = sim.taken;
+    for (uint32_t j = 0; j < 20; j++) sim.peer.dropOnce.push_back(start + 1 + j);
+    sim.peer.sendAcks = false;
+    while (sim.taken < start + 40) sim.step();
+    sim.sampling = false;
+    sim.run(TEENSY_UART_RETX_HOLDOFF_MS + 50);
+
+    sim.peer.stats.getAckWindow(0, cumulative, missing);
+    check(cumulative == start % 10000 && missing == 0xFFFFF, "20 dropped samples reported as holes");
+
+    const TeensyUartStats& linkStats = sim.link->getStats();
+    uint32_t retransmits = linkStats.retransmits;
+    sim.peer.arrivals.clear();
+    sim.peer.sendAck(cumulative, missing);
+    sim.step();
+    bool first = sim.peer.arrivals.size() == TEENSY_UART_RETX_MAX;
+    for (size_t i = 0; first && i < sim.peer.arrivals.size(); i++) {
+        first = sim.peer.arrivals[i] == start + 1 + i;
+    }
+    check(first && linkStats.retransmits - retransmits == TEENSY_UART_RETX_MAX,
+          "first ACK resends the oldest RETX_MAX holes in order");
+
+    // Same ACK again at once: the resent ones are held off, the rest go
+    sim.peer.arrivals.clear();
+    sim.peer.sendAck(cumulative, missing);
+    sim.step();
+    bool second = sim.peer.arrivals.size() == 20 - TEENSY_UART_RETX_MAX;
+    for (size_t i = 0; second && i < sim.peer.arrivals.size(); i++) {
+        second = sim.peer.arrivals[i] == start + 1 + TEENSY_UART_RETX_MAX + i;
+    }
+    check(second, "repeat within the holdoff sends only the rest");
+
+    sim.run(TEENSY_UART_RETX_HOLDOFF_MS);
+    sim.peer.arrivals.clear();
+    sim.peer.sendAck(cumulative, missing);
+    sim.step();
+    check(sim.peer.arrivals.size() == TEENSY_UART_RETX_MAX && sim.peer.arrivals[0] == start + 1,
+          "after the holdoff the holes are resent again");
+
+    sim.peer.arrivals.clear();
+    sim.peer.sendAck(cumulative, 0);
+    sim.step();
+    check(sim.peer.arrivals.empty() && linkStats.ackedSequence == start, "empty bitmap resends nothing");
+
+    // Holes the history no longer holds
+    sim.sampling = true;
+    while (sim.taken < start + 41 + TEENSY_UART_HISTORY_SIZE) sim.step();
+    sim.sampling = false;
+    sim.run(TEENSY_UART_RETX_HOLDOFF_MS + 50);
+    uint32_t unrecoverable = linkStats.unrecoverable;
+    sim.peer.arrivals.clear();
+    sim.peer.sendAck(start % 10000, 0x3);
+    sim.step();
+    check(sim.peer.arrivals.empty() && linkStats.unrecoverable - unrecoverable == 2,
+          "holes older than the history counted unrecoverable");
+    printf("\n");
+}
+
+// ===== 4. Baud Negotiation =====
+
+static void testNegotiation() {
+    char what[80];
+    printf("Baud negotiation (%s, %d SPS)\n", TEENSY_UART_BINARY ? "binary" : "ASCII", SAMPLE_HZ);
+
+    {
+        Sim sim;
+        sim.run(500);
+        check(countControls(sim.peer, "BAUDREQ") == 0 && sim.link->isLinkReady(),
+              "no request before the Teensy has booted");
+        sim.runUntilBaud(3000000, 1000);
+        check(!sim.link->isLinkReady(), "switched on BAUDACK, link held while testing");
+        sim.run(1500);
+        std::string controls = joinControls(sim.peer);
+        check(controls == "BAUDREQ,3000000 BAUDCOMMIT,3000000", "REQ -> ACK -> TEST -> RES -> COMMIT at 3M");
+        check(sim.link->getBaud() == 3000000 && sim.peer.baud == 3000000 && sim.link->isLinkReady() &&
+              sim.link->getStats().baudCommits == 1 && sim.peer.commits == 1,
+              "both ends at 3M, link ready");
+        sim.settle();
+        check(sim.peer.allArrived(0, sim.taken), "every sample arrived, held ones included");
+        check(sim.link->getStats().heldLost == 0 && sim.peer.garbled == 0, "nothing lost or garbled");
+        check(sim.link->getStats().framesSent == sim.taken, "framesSent counts each sample once");
+    }
+
+    {
+        Sim sim;
+        sim.peer.maxBaud = 2000000;
+        sim.run(3000);
+        check(joinControls(sim.peer) == "BAUDREQ,3000000 BAUDREQ,2000000 BAUDCOMMIT,2000000",
+              "NAK at 3M, next rate 2M committed");
+        check(sim.link->getBaud() == 2000000, "running at 2M");
+        sim.settle();
+        check(sim.peer.allArrived(0, sim.taken), "every sample arrived");
+    }
+
+    {
+        Sim sim;
+        sim.peer.dropTests = 1;
+        sim.run(3000);
+        check(joinControls(sim.peer) == "BAUDREQ,3000000 BAUDREQ,2000000 BAUDCOMMIT,2000000",
+              "7/8 test frames fail 3M, 2M committed");
+        sim.settle();
+        check(sim.peer.allArrived(0, sim.taken) && sim.link->getStats().heldLost == 0,
+              "every sample arrived");
+    }
+
+    {
+        Sim sim;
+        sim.peer.answerRequest = false;
+        sim.run(1000 + THRUSTLINK_BAUD_STEP_TIMEOUT_MS / 2);
+        check(!sim.link->isLinkReady(), "unanswered BAUDREQ holds the link");
+        sim.run(THRUSTLINK_BAUD_STEP_TIMEOUT_MS);
+        check(sim.link->isLinkReady() && sim.link->getBaud() == TEENSY_UART_BAUD,
+              "step timeout: back at base, link ready");
+        sim.run(3000);
+        check(countControls(sim.peer, "BAUDREQ") == 1, "no retry before TEENSY_UART_RENEGOTIATE_MS");
+        sim.settle();
+        check(sim.peer.allArrived(0, sim.taken) && sim.link->getStats().heldLost == 0,
+              "samples held through the timeout arrived");
+    }
+
+    {
+        Sim sim;
+        sim.peer.answerTest = false;
+        sim.run(1000 + THRUSTLINK_BAUD_RATE_COUNT * 2 * TEENSY_UART_NEGOTIATION_HOLD_MS + 2000);
+        check(countControls(sim.peer, "BAUDREQ") == (int)THRUSTLINK_BAUD_RATE_COUNT &&
+              countControls(sim.peer, "BAUDCOMMIT") == 0,
+              "no BAUDRES: every rate tried once, none committed");
+        check(sim.link->getBaud() == TEENSY_UART_BAUD && sim.peer.baud == THRUSTLINK_BASE_BAUD &&
+              sim.link->isLinkReady(), "both ends back at base");
+        sim.settle();
+        check(sim.peer.allArrived(0, sim.taken) && sim.link->getStats().heldLost == 0,
+              "samples held through four attempts arrived");
+    }
+
+    {
+        // ACKs stop at 3M: the sender falls back, the Teensy follows once
+        // the line goes quiet, and both renegotiate
+        Sim sim;
+        sim.run(2000);
+        sim.peer.sendAcks = false;
+        sim.runUntilBaud(TEENSY_UART_BAUD, TEENSY_UART_LINK_TIMEOUT_MS + 500);
+        uint32_t fellBack = sim.taken;
+        check(sim.link->getStats().baudFallbacks == 1, "no ACKs for LINK_TIMEOUT_MS: fallback");
+        while (sim.peer.baud != THRUSTLINK_BASE_BAUD) sim.step();
+        uint32_t peerBack = sim.taken;
+        sim.peer.sendAcks = true;
+        sim.run(3 * TEENSY_UART_LINK_TIMEOUT_MS + 2000);
+        check(sim.link->getBaud() == THRUSTLINK_BAUD_RATES[1] && sim.link->getStats().baudCommits == 2,
+              "renegotiated one rate lower after the retry delay");
+        sim.settle();
+        check(sim.peer.allArrived(0, fellBack), "samples before the fallback arrived");
+        // The sender's leading delimiter went out before the Teensy followed,
+        // so the first frame after it is lost: at most one batch
+        uint32_t resumed = peerBack;
+        while (resumed < sim.taken && !sim.peer.seen[resumed]) resumed++;
+        check(resumed - peerBack <= TEENSY_UART_BATCH_SAMPLES && sim.peer.allArrived(resumed, sim.taken),
+              "samples after the Teensy's fallback arrived");
+        snprintf(what, sizeof(what), "(%lu sent while the ends disagreed, %lu lost)",
+                 (unsigned long)(peerBack - fellBack),
+                 (unsigned long)(peerBack - fellBack - sim.peer.countArrived(fellBack, peerBack)));
+        printf("  %s\n", what);
+    }
+    printf("\n");
+}
+
+int main() {
+    testCobs();
+    testBatch();
+    testAckWindow();
+    testNegotiation();
+
+    printf("%s\n", failures ? "FAILED" : "All checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+// ============================================================================
+// ThrustMetrics Float vs Fixed-Point Benchmark
+// ============================================================================
+// Feeds a long synthetic static fire (100 N +-20% over a 30 s period, 0.5 N
+// noise) to ThrustMetricsFloat and ThrustMetricsFixed and:
+//   1. compares impulse and average thrust against a double-precision
+//      reference on the same samples, at 10%, 20%, 50% and 100% of the run
+//   2. times update() for both on a block of the same samples and on a
+//      block above 4294 N (the fixed-point slow path)
+// Builds for the host and, in env:esp32dev_metrics_bench, for the ESP32
+// (results on the serial monitor; there the cost that matters).
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -I ../lib/WebDashboard
+//       -o metrics_bench metrics_bench.cpp
+//   (one command; see README)
+// Usage:
+//   ./metrics_bench [sample_hz] [minutes]
+//   ./metrics_bench 1000 10
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ThrustMetrics.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#define BENCH_PRINTF Serial.printf
+#define BENCH_YIELD() delay(1)      // Let the idle task feed the watchdog
+static double nowNs() { return micros() * 1e3; }
+#else
+#include <time.h>
+#define BENCH_PRINTF printf
+#define BENCH_YIELD() do {} while (0)
+static double nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+#endif
+
+#define SESSION_MEAN_N 100.0f
+#define SESSION_SWING 0.2f
+#define SESSION_PERIOD_S 30.0f
+#define SESSION_NOISE_N 0.5f
+#define HIGH_FORCE_N 5000.0f
+#define TIMING_BLOCK 1024
+#define TIMING_REPEATS 5
+#define START_US 1000000UL
+
+// ===== Synthetic Session =====
+static uint32_t noiseState = 12345;
+
+static float noise() {
+    // Sum of four uniforms: close enough to Gaussian, unit variance
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        noiseState = noiseState * 1664525UL + 1013904223UL;
+        sum += (noiseState >> 8) * (1.0f / 16777216.0f) - 0.5f;
+    }
+    return sum * 1.7320508f;
+}
+
+static float forceAt(double t) {
+    return SESSION_MEAN_N * (1.0f + SESSION_SWING * (float)sin(2.0 * M_PI * t / SESSION_PERIOD_S))
+           + SESSION_NOISE_N * noise();
+}
+
+// ===== Double-Precision Reference =====
+// ThrustMetrics' rules, accumulated in double
+struct Reference {
+    double impulse;
+    double thrustSum;
+    uint32_t burnSamples;
+    float peak;
+    float lastAbs;
+    uint32_t lastUs;
+    bool started;
+
+    Reference() : impulse(0), thrustSum(0), burnSamples(0), peak(0), lastAbs(0), lastUs(0),
+                  started(false) {}
+
+    void update(float force, uint32_t us) {
+        float absForce = fabsf(force);
+        if (absForce > peak) peak = absForce;
+        if (started) {
+            uint32_t dtUs = us - lastUs;
+            if (dtUs > 0 && dtUs < THRUST_METRICS_MAX_GAP_US) {
+                impulse += 0.5 * ((double)absForce + lastAbs) * dtUs * 1e-6;
+            }
+        }
+        if (absForce >= fmaxf(peak * 0.05f, 0.1f)) {
+            thrustSum += absForce;
+            burnSamples++;
+        }
+        lastAbs = absForce;
+        lastUs = us;
+        started = true;
+    }
+
+    double average() const { return burnSamples ? thrustSum / burnSamples : 0.0; }
+};
+
+static double errorPercent(float value, double reference) {
+    return reference != 0.0 ? (value - reference) / reference * 100.0 : 0.0;
+}
+
+static void runAccuracy(float sampleHz, float minutes) {
+    uint32_t total = (uint32_t)(sampleHz * minutes * 60.0f);
+    uint32_t dtUs = (uint32_t)(1e6f / sampleHz + 0.5f);
+    uint32_t checkpoints[4] = { total / 10, total / 5, total / 2, total };
+    int next = 0;
+
+    ThrustMetricsFloat floatMetrics;
+    ThrustMetricsFixed fixedMetrics;
+    Reference reference;
+    noiseState = 12345;
+
+    BENCH_PRINTF("Accuracy: %.0f SPS for %.1f min (%lu samples), error vs double\n",
+                 sampleHz, minutes, (unsigned long)total);
+    BENCH_PRINTF("  time   impulse N*s   float      fixed     | average N  float      fixed\n");
+
+    uint64_t timeUs = START_US;
+    for (uint32_t i = 1; i <= total; i++) {
+        float force = forceAt((timeUs - START_US) * 1e-6);
+        uint32_t us = (uint32_t)timeUs;
+        unsigned long ms = (unsigned long)(timeUs / 1000);
+        floatMetrics.update(force, ms, us);
+        fixedMetrics.update(force, ms, us);
+        reference.update(force, us);
+        timeUs += dtUs;
+
+        if (i == checkpoints[next]) {
+            BENCH_PRINTF("  %5.1f  %11.3f  %+8.4f%%  %+.1e%% | %8.3f  %+8.4f%%  %+.1e%%\n",
+                         i / sampleHz / 60.0f, reference.impulse,
+                         errorPercent(floatMetrics.getTotalImpulse(), reference.impulse),
+                         errorPercent(fixedMetrics.getTotalImpulse(), reference.impulse),
+                         reference.average(),
+                         errorPercent(floatMetrics.getAverageThrust(), reference.average()),
+                         errorPercent(fixedMetrics.getAverageThrust(), reference.average()));
+            next++;
+        }
+        if ((i & 0xFFFF) == 0) BENCH_YIELD();
+    }
+}
+
+// ===== Timing =====
+static float block[TIMING_BLOCK];
+
+// Best of TIMING_REPEATS, in ns per update
+template <typename Metrics>
+static double timeUpdates(uint32_t updates, uint32_t dtUs) {
+    double best = 0.0;
+    for (int repeat = 0; repeat < TIMING_REPEATS; repeat++) {
+        Metrics metrics;
+        uint32_t us = START_US;
+        double start = nowNs();
+        for (uint32_t i = 0; i < updates; i++) {
+            metrics.update(block[i & (TIMING_BLOCK - 1)], us / 1000, us);
+            us += dtUs;
+        }
+        double ns = (nowNs() - start) / updates;
+        // Keep the results live
+        volatile float sink = metrics.getTotalImpulse() + metrics.getAverageThrust();
+        (void)sink;
+        if (repeat == 0 || ns < best) best = ns;
+        BENCH_YIELD();
+    }
+    return best;
+}
+
+static void runTiming(float sampleHz, uint32_t updates) {
+    uint32_t dtUs = (uint32_t)(1e6f / sampleHz + 0.5f);
+
+    BENCH_PRINTF("\nCost per update (best of %d x %lu updates):\n", TIMING_REPEATS,
+                 (unsigned long)updates);
+    const char* names[2] = { "session", "> 4294 N" };
+    for (int pass = 0; pass < 2; pass++) {
+        noiseState = 12345;
+        for (uint32_t i = 0; i < TIMING_BLOCK; i++) {
+            block[i] = forceAt(i / sampleHz) + (pass == 1 ? HIGH_FORCE_N : 0.0f);
+        }
+        double floatNs = timeUpdates<ThrustMetricsFloat>(updates, dtUs);
+        double fixedNs = timeUpdates<ThrustMetricsFixed>(updates, dtUs);
+        BENCH_PRINTF("  %-9s float %6.1f ns  fixed %6.1f ns  (%.2fx)\n", names[pass],
+                     floatNs, fixedNs, fixedNs / floatNs);
+    }
+}
+
+static void runBench(float sampleHz, float minutes) {
+    runAccuracy(sampleHz, minutes);
+    runTiming(sampleHz, 200000);
+}
+
+#ifdef ARDUINO
+void setup() {
+    Serial.begin(921600);
+    delay(1000);
+    BENCH_PRINTF("\nThrustMetrics benchmark, %lu MHz\n\n", (unsigned long)getCpuFrequencyMhz());
+    runBench(1000.0f, 10.0f);
+    BENCH_PRINTF("\n");
+    runBench(80.0f, 10.0f);
+}
+
+void loop() {
+    delay(1000);
+}
+#else
+int main(int argc, char** argv) {
+    float sampleHz = argc > 1 ? atof(argv[1]) : 1000.0f;
+    float minutes = argc > 2 ? atof(argv[2]) : 10.0f;
+    if (sampleHz <= 0.0f || minutes <= 0.0f) {
+        fprintf(stderr, "usage: %s [sample_hz] [minutes]\n", argv[0]);
+        return 1;
+    }
+    runBench(sampleHz, minutes);
+    return 0;
+}
+#endif
@@ -0,0 +1,115 @@
+// ============================================================================
+// Load Cell Pipeline Benchmark
+// ============================================================================
+// Runs the firmware's sample path on the host with the simulated ADC:
+//   SimulatedAdc -> LoadCellModuleT (tare, calibration, ThrustData)
+//   -> ForceFilterChain -> ThrustMetrics
+// The ADC is free-running, so samples are produced as fast as the pipeline
+// consumes them. Reports ns/sample per stage, the sample rate that leaves
+// for, and peak/impulse against the curve to check the conversion.
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -DLOADCELL_ADC=2 -DBOARD_NAME=\"host\"
+//       -I ../include -I ../lib/LoadCellModule -I ../lib/SimulatedAdc
+//       -I ../lib/ForceFilter -I ../lib/WebDashboard -I ../lib/CalibrationTable
+//       -I ../../shared/SpscQueue
+//       -o pipeline_bench pipeline_bench.cpp ../lib/LoadCellModule/LoadCellModule.cpp
+//       ../lib/SimulatedAdc/SimulatedAdc.cpp ../lib/ForceFilter/ForceFilter.cpp
+//       ../lib/CalibrationTable/CalibrationTable.cpp
+//   (one command; see README)
+// Usage:
+//   ./pipeline_bench [curve.eng|-] [sample_hz] [filter_spec]
+//   ./pipeline_bench - 4000 median=5,lowpass=200
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "LoadCellModule.h"
+#include "ForceFilter.h"
+#include "ThrustMetrics.h"
+
+static double nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+struct PassResult {
+    double nsPerSample;
+    uint32_t samples;
+    float peak;
+    float impulse;
+};
+
+// One playback of the curve (lead-in, burn, lead-out) through the pipeline
+static bool runPass(const char* curve, float sampleHz, const char* spec, bool fullPipeline,
+                    PassResult& result) {
+    static const float calibrationFactors[LOADCELL_CHANNELS] = LOADCELL_CAL_FACTORS;
+
+    LoadCellModule loadCell;
+    if (!loadCell.adc().begin(curve, sampleHz, LOADCELL_CHANNELS)) return false;
+    loadCell.adc().setScale(calibrationFactors);
+    loadCell.adc().setNoise(SIM_ADC_NOISE_COUNTS);
+    if (!loadCell.begin(calibrationFactors)) return false;
+    loadCell.tare(TARE_READINGS);
+
+    ForceFilterChain filter;
+    if (!filter.configure(spec, sampleHz)) return false;
+    ThrustMetrics metrics;
+
+    float loopS = 2 * SIMULATED_ADC_LEAD_S + loadCell.adc().getCurveDuration();
+    uint32_t count = (uint32_t)(loopS * sampleHz) - TARE_READINGS;
+
+    // Keeps the compiler from dropping the acquire-only pass
+    volatile float sink = 0.0f;
+
+    double start = nowNs();
+    ThrustData data;
+    for (uint32_t i = 0; i < count; i++) {
+        loadCell.readIfReady(data);
+        if (fullPipeline) {
+            float force = filter.process(data.forceNewtons);
+            metrics.update(force, data.timestamp, data.timestampUs);
+        } else {
+            sink = data.forceNewtons;
+        }
+    }
+    double elapsed = nowNs() - start;
+    (void)sink;
+
+    result.nsPerSample = elapsed / count;
+    result.samples = count;
+    result.peak = metrics.getPeakThrust();
+    result.impulse = metrics.getTotalImpulse();
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* curve = argc > 1 && strcmp(argv[1], "-") != 0 ? argv[1] : "";
+    float sampleHz = argc > 2 ? strtof(argv[2], NULL) : SIM_ADC_SAMPLE_HZ;
+    const char* spec = argc > 3 ? argv[3] : "median=5,lowpass=100";
+
+    PassResult acquire;
+    PassResult full;
+    if (!runPass(curve, sampleHz, spec, false, acquire) ||
+        !runPass(curve, sampleHz, spec, true, full)) {
+        fprintf(stderr, "Setup failed (curve '%s', %.0f Hz, filter '%s')\n",
+                curve[0] ? curve : "built-in", sampleHz, spec);
+        return 1;
+    }
+
+    SimulatedAdc reference;
+    reference.begin(curve, sampleHz);
+
+    printf("# Curve: %s, %u points, %.3f s, peak %.2f N, impulse %.3f N*s\n",
+           curve[0] ? curve : "built-in", reference.getPointCount(),
+           reference.getCurveDuration(), reference.getCurvePeak(), reference.getCurveImpulse());
+    printf("# %u channel(s) at %.0f Hz, filter %s\n", LOADCELL_CHANNELS, sampleHz, spec);
+    printf("acquire+convert   %8.1f ns/sample\n", acquire.nsPerSample);
+    printf("full pipeline     %8.1f ns/sample (max %.0f kHz)\n",
+           full.nsPerSample, 1e6 / full.nsPerSample);
+    printf("measured          peak %.2f N, impulse %.3f N*s over %u samples\n",
+           full.peak, full.impulse, full.samples);
+    return 0;
+}
@@ -0,0 +1,190 @@
+// ============================================================================
+// Stand Dynamic Compensation Check
+// ============================================================================
+// Synthesizes what the firmware would record from a stand that is a
+// mass-spring-damper (natural frequency fn, damping ratio zeta), with
+// noise, then:
+//   1. identifies fn and zeta with StandIdentifier from a step and a tap
+//   2. runs a step through ForceFilterChain "comp=fn/zeta" built from the
+//      step identification, and compares rise time (10-90%), overshoot and
+//      settling time (2%, without noise) and the noise after settling with
+//      the raw stand output
+//
+// Build (host):
+//   g++ -O2 -std=c++11 -I ../lib/ForceFilter -I ../lib/StandIdentifier
+//       -o standcomp_sim standcomp_sim.cpp ../lib/ForceFilter/ForceFilter.cpp
+//       ../lib/StandIdentifier/StandIdentifier.cpp
+//   (one command; see README)
+// Usage:
+//   ./standcomp_sim [fn_hz] [zeta] [sample_hz] [noise_n]
+//   ./standcomp_sim 25 0.08 1000 0.02
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ForceFilter.h"
+#include "StandIdentifier.h"
+
+#define STEP_N 10.0f
+#define STEP_AT_S 0.2013f           // Between samples on purpose
+#define TAP_N 30.0f
+#define TAP_MS 3.0f
+#define RECORD_S 2.0f
+#define SUBSTEPS 50                 // Integration steps per sample
+
+enum Excitation { STEP, TAP };
+
+static float inputAt(Excitation excitation, double t) {
+    if (excitation == STEP) return t >= STEP_AT_S ? STEP_N : 0.0f;
+    double tapS = TAP_MS * 1e-3;
+    if (t < STEP_AT_S || t >= STEP_AT_S + tapS) return 0.0f;
+    return TAP_N * (float)sin(M_PI * (t - STEP_AT_S) / tapS);
+}
+
+// Stand output x'' + 2 zeta wn x' + wn^2 x = wn^2 F(t), sampled, plus noise
+static void synthesize(Excitation excitation, float fn, float zeta, float sampleHz, float noiseN,
+                       float* out, uint32_t count) {
+    double wn = 2.0 * M_PI * fn;
+    double dt = 1.0 / (sampleHz * SUBSTEPS);
+    double x = 0.0;
+    double v = 0.0;
+    double t = 0.0;
+    uint32_t rng = 12345;
+
+    for (uint32_t i = 0; i < count; i++) {
+        // Sum of four uniforms: close to Gaussian, RMS noiseN
+        float n = 0.0f;
+        for (uint8_t k = 0; k < 4; k++) {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            n += (rng / 4294967296.0f) - 0.5f;
+        }
+        out[i] = (float)x + n * noiseN * 1.7320508f;
+
+        // Semi-implicit Euler, fine enough at SUBSTEPS per sample
+        for (uint8_t s = 0; s < SUBSTEPS; s++) {
+            double a = wn * wn * (inputAt(excitation, t) - x) - 2.0 * zeta * wn * v;
+            v += a * dt;
+            x += v * dt;
+            t += dt;
+        }
+    }
+}
+
+static bool identify(const char* name, Excitation excitation, float fn, float zeta, float sampleHz,
+                     float noiseN, float* samples, uint32_t count, StandDynamics& result) {
+    synthesize(excitation, fn, zeta, sampleHz, noiseN, samples, count);
+
+    StandIdentifier identifier;
+    identifier.start(sampleHz, 1.0f, (uint32_t)(sampleHz * (RECORD_S - STEP_AT_S)));
+    for (uint32_t i = 0; i < count && identifier.isBusy(); i++) {
+        identifier.update(samples[i]);
+    }
+    result = identifier.getResult();
+
+    printf("%-5s ", name);
+    if (identifier.getState() != STAND_ID_DONE) {
+        printf("failed: %s (%u peaks)\n", StandIdentifier::errorName(result.error), result.peaks);
+        return false;
+    }
+    printf("fn %7.2f Hz (%+.1f%%)  zeta %.4f (%+.1f%%)  %u peaks\n",
+           result.naturalHz, 100.0f * (result.naturalHz - fn) / fn,
+           result.dampingRatio, 100.0f * (result.dampingRatio - zeta) / zeta, result.peaks);
+    return true;
+}
+
+struct StepMetrics {
+    float riseMs;
+    float overshootPct;
+    float settleMs;
+    float noiseN;               // From the noisy run
+};
+
+// Time at which the step response first crosses level, interpolated
+static float crossingS(const float* y, uint32_t count, float sampleHz, float level) {
+    for (uint32_t i = 1; i < count; i++) {
+        if (y[i - 1] < level && y[i] >= level) {
+            return (i - 1 + (level - y[i - 1]) / (y[i] - y[i - 1])) / sampleHz;
+        }
+    }
+    return NAN;
+}
+
+static StepMetrics measure(const float* y, const float* noisy, uint32_t count, float sampleHz) {
+    StepMetrics m;
+    m.riseMs = 1000.0f * (crossingS(y, count, sampleHz, 0.9f * STEP_N) -
+                          crossingS(y, count, sampleHz, 0.1f * STEP_N));
+
+    float peak = 0.0f;
+    uint32_t lastOutside = 0;
+    uint32_t stepIndex = (uint32_t)(STEP_AT_S * sampleHz);
+    for (uint32_t i = stepIndex; i < count; i++) {
+        if (y[i] > peak) peak = y[i];
+        if (fabsf(y[i] - STEP_N) > 0.02f * STEP_N) lastOutside = i;
+    }
+    m.overshootPct = 100.0f * (peak - STEP_N) / STEP_N;
+    m.settleMs = 1000.0f * (lastOutside + 1 - STEP_AT_S * sampleHz) / sampleHz;
+
+    // Last quarter, settled: only noise
+    uint32_t tail = count / 4;
+    double sumSq = 0.0;
+    for (uint32_t i = count - tail; i < count; i++) {
+        double d = noisy[i] - STEP_N;
+        sumSq += d * d;
+    }
+    m.noiseN = (float)sqrt(sumSq / tail);
+    return m;
+}
+
+static void printMetrics(const char* name, const StepMetrics& m) {
+    printf("%-12s rise %7.2f ms  overshoot %6.1f%%  settle(2%%) %7.1f ms  noise %.4f N\n",
+           name, m.riseMs, m.overshootPct, m.settleMs, m.noiseN);
+}
+
+int main(int argc, char** argv) {
+    float fn = argc > 1 ? atof(argv[1]) : 25.0f;
+    float zeta = argc > 2 ? atof(argv[2]) : 0.08f;
+    float sampleHz = argc > 3 ? atof(argv[3]) : 1000.0f;
+    float noiseN = argc > 4 ? atof(argv[4]) : 0.02f;
+
+    uint32_t count = (uint32_t)(RECORD_S * sampleHz);
+    float* samples = (float*)malloc(count * sizeof(float));
+    float* compensated = (float*)malloc(count * sizeof(float));
+    float* clean = (float*)malloc(count * sizeof(float));
+    float* cleanCompensated = (float*)malloc(count * sizeof(float));
+    if (!samples || !compensated || !clean || !cleanCompensated) return 1;
+
+    printf("Stand fn %.2f Hz, zeta %.4f; %.0f SPS, noise %.3f N RMS\n\n", fn, zeta, sampleHz, noiseN);
+
+    StandDynamics tap;
+    identify("tap", TAP, fn, zeta, sampleHz, noiseN, samples, count, tap);
+    StandDynamics step;
+    if (!identify("step", STEP, fn, zeta, sampleHz, noiseN, samples, count, step)) return 1;
+
+    char spec[48];
+    snprintf(spec, sizeof(spec), "comp=%.2f/%.4f", step.naturalHz, step.dampingRatio);
+    ForceFilterChain filter;
+    if (!filter.configure(spec, sampleHz)) {
+        printf("\n%s not valid at %.0f SPS\n", spec, sampleHz);
+        return 1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        compensated[i] = filter.process(samples[i]);
+    }
+    synthesize(STEP, fn, zeta, sampleHz, 0.0f, clean, count);
+    filter.reset();
+    for (uint32_t i = 0; i < count; i++) {
+        cleanCompensated[i] = filter.process(clean[i]);
+    }
+
+    printf("\nStep of %.1f N through %s:\n", STEP_N, spec);
+    printMetrics("stand", measure(clean, samples, count, sampleHz));
+    printMetrics("compensated", measure(cleanCompensated, compensated, count, sampleHz));
+
+    free(samples);
+    free(compensated);
+    free(clean);
+    free(cleanCompensated);
+    return 0;
+}
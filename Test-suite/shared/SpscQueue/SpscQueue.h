@@ -0,0 +1,83 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// ============================================================================
+// Lock-free Single-Producer / Single-Consumer Queue
+// ============================================================================
+// Fixed-size ring of N items (N must be a power of two). push() may only be
+// called from one context (e.g. a timer interrupt) and pop() from one other
+// context (e.g. loop()). Indices are free-running 32-bit counters published
+// with release/acquire ordering, so no interrupt masking is needed.
+//
+// A full queue rejects new items and counts them as drops rather than
+// overwriting data the consumer has not seen yet.
+
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+public:
+    SpscQueue() : _head(0), _tail(0), _highWater(0), _drops(0) {}
+
+    // ===== Producer Side =====
+
+    bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_acquire);
+        uint32_t used = head - tail;
+
+        if (used >= N) {
+            _drops++;
+            return false;
+        }
+
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+
+        if (used + 1 > _highWater) {
+            _highWater = used + 1;
+        }
+        return true;
+    }
+
+    // ===== Consumer Side =====
+
+    bool pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        uint32_t head = _head.load(std::memory_order_acquire);
+
+        if (head == tail) {
+            return false;
+        }
+
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ===== Status (approximate while the other side is running) =====
+
+    size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    uint32_t getHighWater() const { return _highWater; }
+    uint32_t getDrops() const { return _drops; }
+
+private:
+    T _items[N];
+    std::atomic<uint32_t> _head;  // Written by producer only
+    std::atomic<uint32_t> _tail;  // Written by consumer only
+
+    // Producer-owned counters (32-bit reads are atomic on the consumer side)
+    volatile uint32_t _highWater;
+    volatile uint32_t _drops;
+};
+
+#endif // SPSC_QUEUE_H
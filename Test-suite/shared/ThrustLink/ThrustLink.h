@@ -0,0 +1,394 @@
+#ifndef THRUST_LINK_H
+#define THRUST_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// ThrustLink Binary Frame Codec
+// ============================================================================
+// Compact binary framing for the ESP32 -> Teensy UART link, used next to the
+// ASCII $...*CS protocol:
+//
+//   <COBS(payload + CRC16)> 0x00
+//
+// COBS removes every 0x00 from the encoded bytes, so 0x00 is a pure frame
+// delimiter and the receiver resynchronizes at the next one after any error.
+// The CRC is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over the payload,
+// appended little-endian. All multi-byte fields are little-endian.
+//
+// Payload types:
+//   SAMPLE      type, device, seq u32, timestamp_us u32, value i32 (milli-units)
+//   DESCRIPTOR  type, device, name[16], sensor[8], unit[8]
+//   BATCH       type, device, seq u32, timestamp_us u32, value i32, count u8,
+//               then count - 1 (dt_us, dvalue) pairs as zigzag varints;
+//               sequences are consecutive from seq
+//   TEST        type, index u8, THRUSTLINK_TEST_SIZE - 2 pattern bytes; used
+//               to qualify a new baud rate during negotiation
+//
+// A SAMPLE is 18 bytes on the wire versus ~45 for the ASCII message; in a
+// BATCH each further sample typically costs 3-4 bytes.
+//
+// Header-only with no Arduino dependencies, so the ESP32 sender, the Teensy
+// receiver and host tools all compile the same code.
+
+#define THRUSTLINK_DELIMITER 0x00
+
+#define THRUSTLINK_TYPE_SAMPLE 0x01
+#define THRUSTLINK_TYPE_DESCRIPTOR 0x02
+#define THRUSTLINK_TYPE_BATCH 0x03
+#define THRUSTLINK_TYPE_TEST 0x04
+
+#define THRUSTLINK_NAME_LEN 16
+#define THRUSTLINK_FIELD_LEN 8
+
+#define THRUSTLINK_SAMPLE_SIZE 14       // Payload bytes, excluding CRC
+#define THRUSTLINK_DESCRIPTOR_SIZE (2 + THRUSTLINK_NAME_LEN + 2 * THRUSTLINK_FIELD_LEN)
+#define THRUSTLINK_BATCH_HEADER_SIZE 15
+#define THRUSTLINK_BATCH_MAX_SAMPLES 32
+#define THRUSTLINK_TEST_SIZE 64
+
+#ifndef THRUSTLINK_MAX_PAYLOAD
+#define THRUSTLINK_MAX_PAYLOAD 120      // Largest payload, excluding CRC
+#endif
+
+// COBS adds one byte per 254, plus the CRC and the delimiter
+#define THRUSTLINK_MAX_ENCODED (THRUSTLINK_MAX_PAYLOAD + 2 + (THRUSTLINK_MAX_PAYLOAD + 2) / 254 + 2)
+
+struct ThrustLinkSample {
+    uint8_t device;
+    uint32_t sequence;        // Free-running, never wraps in practice
+    uint32_t timestampUs;     // Sender micros()
+    int32_t valueMilli;       // Value in thousandths of the sensor unit
+};
+
+struct ThrustLinkDescriptor {
+    uint8_t device;
+    char name[THRUSTLINK_NAME_LEN];     // Null-terminated
+    char sensor[THRUSTLINK_FIELD_LEN];
+    char unit[THRUSTLINK_FIELD_LEN];
+};
+
+// ===== CRC-16/CCITT-FALSE =====
+
+inline uint16_t thrustLinkCrc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    // Nibble table: 32 bytes of flash, two lookups per byte
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    for (size_t i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+// ===== COBS =====
+
+// Encode length bytes into out (at least length + length / 254 + 1 bytes).
+// Returns the encoded length; no delimiter is written.
+inline size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeIndex = 0;
+    size_t outIndex = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] != 0) {
+            out[outIndex++] = in[i];
+            code++;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+    }
+    out[codeIndex] = code;
+    return outIndex;
+}
+
+// Decode length bytes (without delimiter) into out (at least length bytes).
+// Returns the decoded length, or 0 if the input is not valid COBS.
+inline size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t inIndex = 0;
+    size_t outIndex = 0;
+
+    while (inIndex < length) {
+        uint8_t code = in[inIndex++];
+        if (code == 0 || inIndex + code - 1 > length) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (in[inIndex] == 0) return 0;
+            out[outIndex++] = in[inIndex++];
+        }
+        if (code != 0xFF && inIndex < length) {
+            out[outIndex++] = 0;
+        }
+    }
+    return outIndex;
+}
+
+// ===== Little-endian Helpers =====
+
+inline void thrustLinkPut32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+inline uint32_t thrustLinkGet32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ===== Framing =====
+
+// Append the CRC to payload, COBS-encode and add the delimiter.
+// payload must have 2 spare bytes; frame must hold THRUSTLINK_MAX_ENCODED.
+// Returns the number of bytes to transmit.
+inline size_t thrustLinkFrame(uint8_t* payload, size_t length, uint8_t* frame) {
+    uint16_t crc = thrustLinkCrc16(payload, length);
+    payload[length] = (uint8_t)crc;
+    payload[length + 1] = (uint8_t)(crc >> 8);
+
+    size_t encoded = cobsEncode(payload, length + 2, frame);
+    frame[encoded++] = THRUSTLINK_DELIMITER;
+    return encoded;
+}
+
+// Decode one frame (bytes between delimiters) and check its CRC.
+// payload must hold length bytes. Returns the payload length without the
+// CRC, or 0 if the frame is corrupt.
+inline size_t thrustLinkUnframe(const uint8_t* encoded, size_t length, uint8_t* payload) {
+    size_t decoded = cobsDecode(encoded, length, payload);
+    if (decoded < 3) return 0;
+
+    size_t body = decoded - 2;
+    uint16_t crc = (uint16_t)(payload[body] | (payload[body + 1] << 8));
+    return thrustLinkCrc16(payload, body) == crc ? body : 0;
+}
+
+// ===== Payloads =====
+
+inline size_t thrustLinkEncodeSample(const ThrustLinkSample& sample, uint8_t* frame) {
+    uint8_t payload[THRUSTLINK_SAMPLE_SIZE + 2];
+    payload[0] = THRUSTLINK_TYPE_SAMPLE;
+    payload[1] = sample.device;
+    thrustLinkPut32(&payload[2], sample.sequence);
+    thrustLinkPut32(&payload[6], sample.timestampUs);
+    thrustLinkPut32(&payload[10], (uint32_t)sample.valueMilli);
+    return thrustLinkFrame(payload, THRUSTLINK_SAMPLE_SIZE, frame);
+}
+
+inline bool thrustLinkParseSample(const uint8_t* payload, size_t length, ThrustLinkSample& sample) {
+    if (length != THRUSTLINK_SAMPLE_SIZE || payload[0] != THRUSTLINK_TYPE_SAMPLE) {
+        return false;
+    }
+    sample.device = payload[1];
+    sample.sequence = thrustLinkGet32(&payload[2]);
+    sample.timestampUs = thrustLinkGet32(&payload[6]);
+    sample.valueMilli = (int32_t)thrustLinkGet32(&payload[10]);
+    return true;
+}
+
+inline size_t thrustLinkEncodeDescriptor(const ThrustLinkDescriptor& desc, uint8_t* frame) {
+    uint8_t payload[THRUSTLINK_DESCRIPTOR_SIZE + 2];
+    payload[0] = THRUSTLINK_TYPE_DESCRIPTOR;
+    payload[1] = desc.device;
+    memcpy(&payload[2], desc.name, THRUSTLINK_NAME_LEN);
+    memcpy(&payload[2 + THRUSTLINK_NAME_LEN], desc.sensor, THRUSTLINK_FIELD_LEN);
+    memcpy(&payload[2 + THRUSTLINK_NAME_LEN + THRUSTLINK_FIELD_LEN], desc.unit, THRUSTLINK_FIELD_LEN);
+    return thrustLinkFrame(payload, THRUSTLINK_DESCRIPTOR_SIZE, frame);
+}
+
+inline bool thrustLinkParseDescriptor(const uint8_t* payload, size_t length, ThrustLinkDescriptor& desc) {
+    if (length != THRUSTLINK_DESCRIPTOR_SIZE || payload[0] != THRUSTLINK_TYPE_DESCRIPTOR) {
+        return false;
+    }
+    desc.device = payload[1];
+    memcpy(desc.name, &payload[2], THRUSTLINK_NAME_LEN);
+    memcpy(desc.sensor, &payload[2 + THRUSTLINK_NAME_LEN], THRUSTLINK_FIELD_LEN);
+    memcpy(desc.unit, &payload[2 + THRUSTLINK_NAME_LEN + THRUSTLINK_FIELD_LEN], THRUSTLINK_FIELD_LEN);
+    desc.name[THRUSTLINK_NAME_LEN - 1] = '\0';
+    desc.sensor[THRUSTLINK_FIELD_LEN - 1] = '\0';
+    desc.unit[THRUSTLINK_FIELD_LEN - 1] = '\0';
+    return true;
+}
+
+// ===== Batches =====
+
+inline size_t thrustLinkPutVarint(uint8_t* p, int32_t value) {
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    size_t length = 0;
+    while (zigzag >= 0x80) {
+        p[length++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    p[length++] = (uint8_t)zigzag;
+    return length;
+}
+
+// Returns bytes consumed, or 0 if the varint runs past end
+inline size_t thrustLinkGetVarint(const uint8_t* p, const uint8_t* end, int32_t& value) {
+    uint32_t zigzag = 0;
+    for (size_t i = 0; i < 5 && p + i < end; i++) {
+        zigzag |= (uint32_t)(p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            value = (int32_t)((zigzag >> 1) ^ (0U - (zigzag & 1)));
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Builds one BATCH payload sample by sample. add() refuses a sample that
+// would overflow THRUSTLINK_MAX_PAYLOAD or THRUSTLINK_BATCH_MAX_SAMPLES, so
+// the caller flushes and starts a new batch with it.
+class ThrustLinkBatchWriter {
+public:
+    ThrustLinkBatchWriter() : _length(0), _count(0), _lastTimestampUs(0), _lastValue(0) {}
+
+    void begin(uint8_t device, const ThrustLinkSample& first) {
+        _payload[0] = THRUSTLINK_TYPE_BATCH;
+        _payload[1] = device;
+        thrustLinkPut32(&_payload[2], first.sequence);
+        thrustLinkPut32(&_payload[6], first.timestampUs);
+        thrustLinkPut32(&_payload[10], (uint32_t)first.valueMilli);
+        _length = THRUSTLINK_BATCH_HEADER_SIZE;
+        _count = 1;
+        _lastTimestampUs = first.timestampUs;
+        _lastValue = first.valueMilli;
+    }
+
+    // Sample must continue the sequence (first.sequence + count())
+    bool add(const ThrustLinkSample& sample) {
+        if (_count == 0 || _count >= THRUSTLINK_BATCH_MAX_SAMPLES) return false;
+
+        uint8_t pair[10];
+        size_t length = thrustLinkPutVarint(pair, (int32_t)(sample.timestampUs - _lastTimestampUs));
+        length += thrustLinkPutVarint(&pair[length], (int32_t)((uint32_t)sample.valueMilli - (uint32_t)_lastValue));
+        if (_length + length > THRUSTLINK_MAX_PAYLOAD) return false;
+
+        memcpy(&_payload[_length], pair, length);
+        _length += length;
+        _count++;
+        _lastTimestampUs = sample.timestampUs;
+        _lastValue = sample.valueMilli;
+        return true;
+    }
+
+    // Frame the batch into frame (THRUSTLINK_MAX_ENCODED bytes) and reset
+    size_t finish(uint8_t* frame) {
+        if (_count == 0) return 0;
+        _payload[14] = _count;
+        size_t length = thrustLinkFrame(_payload, _length, frame);
+        _count = 0;
+        _length = 0;
+        return length;
+    }
+
+    uint8_t count() const { return _count; }
+
+private:
+    uint8_t _payload[THRUSTLINK_MAX_PAYLOAD + 2];
+    size_t _length;
+    uint8_t _count;
+    uint32_t _lastTimestampUs;
+    int32_t _lastValue;
+};
+
+// Unpack a BATCH payload into samples (THRUSTLINK_BATCH_MAX_SAMPLES entries).
+// Returns the number of samples, or 0 if the payload is malformed.
+inline uint8_t thrustLinkParseBatch(const uint8_t* payload, size_t length, ThrustLinkSample* samples) {
+    if (length < THRUSTLINK_BATCH_HEADER_SIZE || payload[0] != THRUSTLINK_TYPE_BATCH) {
+        return 0;
+    }
+    uint8_t count = payload[14];
+    if (count == 0 || count > THRUSTLINK_BATCH_MAX_SAMPLES) {
+        return 0;
+    }
+
+    samples[0].device = payload[1];
+    samples[0].sequence = thrustLinkGet32(&payload[2]);
+    samples[0].timestampUs = thrustLinkGet32(&payload[6]);
+    samples[0].valueMilli = (int32_t)thrustLinkGet32(&payload[10]);
+
+    const uint8_t* cursor = payload + THRUSTLINK_BATCH_HEADER_SIZE;
+    const uint8_t* end = payload + length;
+    for (uint8_t i = 1; i < count; i++) {
+        int32_t dt;
+        int32_t dv;
+        size_t used = thrustLinkGetVarint(cursor, end, dt);
+        if (used == 0) return 0;
+        cursor += used;
+        used = thrustLinkGetVarint(cursor, end, dv);
+        if (used == 0) return 0;
+        cursor += used;
+
+        samples[i].device = samples[0].device;
+        samples[i].sequence = samples[i - 1].sequence + 1;
+        samples[i].timestampUs = samples[i - 1].timestampUs + (uint32_t)dt;
+        samples[i].valueMilli = (int32_t)((uint32_t)samples[i - 1].valueMilli + (uint32_t)dv);
+    }
+    return cursor == end ? count : 0;
+}
+
+// ===== Baud Negotiation =====
+// Both sides start at THRUSTLINK_BASE_BAUD. The sender proposes rates from
+// THRUSTLINK_BAUD_RATES, highest first; control lines are ASCII with the
+// usual XOR checksum:
+//
+//   sender   -> receiver  $BAUDREQ,<rate>*CS          (base rate)
+//   receiver -> sender    $BAUDACK,<rate>*CS or $BAUDNAK,<rate>*CS
+//   -- both switch to <rate> after THRUSTLINK_BAUD_SETTLE_MS --
+//   sender   -> receiver  THRUSTLINK_BAUD_TEST_FRAMES TEST frames
+//   receiver -> sender    $BAUDRES,<rate>,<good>*CS
+//   sender   -> receiver  $BAUDCOMMIT,<rate>*CS       (all frames good)
+//
+// Any step that times out after THRUSTLINK_BAUD_STEP_TIMEOUT_MS returns
+// both sides to the base rate; the sender then tries the next lower rate.
+
+#define THRUSTLINK_BASE_BAUD 115200
+#define THRUSTLINK_BAUD_TEST_FRAMES 8
+#define THRUSTLINK_BAUD_SETTLE_MS 20
+#define THRUSTLINK_BAUD_STEP_TIMEOUT_MS 300
+
+static const uint32_t THRUSTLINK_BAUD_RATES[] = { 3000000, 2000000, 921600, 460800 };
+#define THRUSTLINK_BAUD_RATE_COUNT (sizeof(THRUSTLINK_BAUD_RATES) / sizeof(THRUSTLINK_BAUD_RATES[0]))
+
+// ===== Baud Test Pattern =====
+
+// Pattern byte k of test frame index: walks all byte values, including
+// 0x00 (COBS overhead) and alternating bits (worst case for bit timing)
+inline uint8_t thrustLinkTestByte(uint8_t index, size_t k) {
+    static const uint8_t fixed[4] = { 0x00, 0xFF, 0x55, 0xAA };
+    if (k % 8 == 0) return fixed[(k / 8) % 4];
+    return (uint8_t)(k * 73 + index * 151);
+}
+
+inline size_t thrustLinkEncodeTest(uint8_t index, uint8_t* frame) {
+    uint8_t payload[THRUSTLINK_TEST_SIZE + 2];
+    payload[0] = THRUSTLINK_TYPE_TEST;
+    payload[1] = index;
+    for (size_t k = 2; k < THRUSTLINK_TEST_SIZE; k++) {
+        payload[k] = thrustLinkTestByte(index, k);
+    }
+    return thrustLinkFrame(payload, THRUSTLINK_TEST_SIZE, frame);
+}
+
+// True if payload is an intact TEST frame; index receives its number
+inline bool thrustLinkCheckTest(const uint8_t* payload, size_t length, uint8_t& index) {
+    if (length != THRUSTLINK_TEST_SIZE || payload[0] != THRUSTLINK_TYPE_TEST) {
+        return false;
+    }
+    index = payload[1];
+    for (size_t k = 2; k < THRUSTLINK_TEST_SIZE; k++) {
+        if (payload[k] != thrustLinkTestByte(index, k)) return false;
+    }
+    return true;
+}
+
+#endif // THRUST_LINK_H